@@ -1,5 +1,6 @@
 import java.util.*;
 import java.io.*;
+import java.nio.*;
 import javax.imageio.*;
 import java.awt.Rectangle;
 import java.awt.Graphics2D;
@@ -310,11 +311,80 @@ public class AtlasGenerator
 				}
 				atlas.write( "}\n}" );
 				atlas.close();
+
+				if (!unitCoordinates)
+					WriteIndex(name, fileNameOnly);
 			}
 			catch(IOException e)
 			{
 				
 			}
 		}
+
+		// Binary index read by game instead of parsing json: header, entries sorted by name hash, strings
+		private void WriteIndex(String name, boolean fileNameOnly) throws IOException
+		{
+			List<Object[]> entries = new ArrayList<Object[]>();
+			ByteArrayOutputStream strings = new ByteArrayOutputStream();
+
+			int textureOffset = AddString(strings, name + ".png");
+			for(Map.Entry<String, Rectangle> e : rectangleMap.entrySet())
+			{
+				String keyVal = e.getKey();
+				if (fileNameOnly)
+					keyVal = keyVal.substring(keyVal.lastIndexOf('/') + 1);
+
+				entries.add(new Object[] { Hash(keyVal), AddString(strings, keyVal), e.getValue() });
+			}
+
+			Collections.sort(entries, new Comparator<Object[]>()
+			{
+				public int compare(Object[] a, Object[] b)
+				{
+					return Long.compare((Integer)a[0] & 0xffffffffL, (Integer)b[0] & 0xffffffffL);
+				}
+			});
+
+			int headerSize = 20, entrySize = 16;
+			ByteBuffer buffer = ByteBuffer.allocate(headerSize + entries.size() * entrySize + strings.size());
+			buffer.order(ByteOrder.LITTLE_ENDIAN);
+			buffer.put("CAIX".getBytes("US-ASCII"));
+			buffer.putInt(1);
+			buffer.putInt(entries.size());
+			buffer.putInt(textureOffset);
+			buffer.putInt(headerSize + entries.size() * entrySize);
+			for(Object[] entry : entries)
+			{
+				Rectangle r = (Rectangle)entry[2];
+				buffer.putInt((Integer)entry[0]);
+				buffer.putInt((Integer)entry[1]);
+				buffer.putShort((short)r.x);
+				buffer.putShort((short)r.y);
+				buffer.putShort((short)r.width);
+				buffer.putShort((short)r.height);
+			}
+			buffer.put(strings.toByteArray());
+
+			FileOutputStream index = new FileOutputStream(name + ".atlas.idx");
+			index.write(buffer.array());
+			index.close();
+		}
+
+		private int AddString(ByteArrayOutputStream strings, String value) throws IOException
+		{
+			int offset = strings.size();
+			strings.write(value.getBytes("UTF-8"));
+			strings.write(0);
+			return offset;
+		}
+
+		// Same as StringHelper::hash in game, chars are signed there
+		private int Hash(String value) throws IOException
+		{
+			int hash = 0;
+			for(byte b : value.getBytes("UTF-8"))
+				hash = (hash << 5) + hash + b;
+			return hash;
+		}
 	}
 }
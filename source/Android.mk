@@ -44,6 +44,7 @@ LOCAL_SRC_FILES := $(subst $(LOCAL_PATH)/,, \
   $(wildcard $(GAME_PATH)/religion/*.cpp) \
   $(wildcard $(GAME_PATH)/scene/*.cpp) \
   $(wildcard $(GAME_PATH)/sound/*.cpp) \
+  $(wildcard $(GAME_PATH)/thread/*.cpp) \
   $(wildcard $(GAME_PATH)/game/*.cpp))
   
 LOCAL_SHARED_LIBRARIES := SDL2 SDL2_mixer SDL2_net sdl_ttf pnggo lzma bzip2 aes smk
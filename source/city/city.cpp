@@ -64,6 +64,7 @@
 #include "world/merchant.hpp"
 #include "city/helper.hpp"
 #include "city/statistic.hpp"
+#include "gfx/animation_bank.hpp"
 #include "objects/forum.hpp"
 #include "objects/senate.hpp"
 #include "objects/house.hpp"
@@ -84,8 +85,10 @@
 #include "objects/fort.hpp"
 #include "events/showinfobox.hpp"
 #include "walkergrid.hpp"
+#include "metricsgrid.hpp"
 #include "events/showinfobox.hpp"
 #include "cityservice_fire.hpp"
+#include "thread/workerpool.hpp"
 
 #include <set>
 
@@ -97,6 +100,27 @@ CAESARIA_LITERALCONST(tilemap)
 CAESARIA_LITERALCONST(walkerIdCount)
 CAESARIA_LITERALCONST(adviserEnabled)
 CAESARIA_LITERALCONST(fishPlaceEnabled)
+
+// less overlays are stepped on main thread, queue costs more than work
+static const unsigned int minParallelOverlays = 256;
+
+// runs computeStep() for range of overlays on worker thread,
+// raw pointers are used because smart pointer counters are not thread safe
+class OverlaysStepTask : public CTask
+{
+public:
+  TileOverlay** begin;
+  TileOverlay** end;
+  unsigned long time;
+
+  virtual bool task()
+  {
+    for( TileOverlay** it=begin; it != end; ++it )
+      (*it)->computeStep( time );
+
+    return true;
+  }
+};
 }
 
 class PlayerCity::Impl
@@ -110,16 +134,23 @@ public:
 
   TileOverlayList newOverlays;
   TileOverlayList overlays;
+  std::vector< TileOverlay* > computeQueue;
+  std::vector< OverlaysStepTask* > computeTasks;
 
   WalkerList newWalkers;
   WalkerList walkers;
 
+  // same walkers split by type, changed together with walkers list
+  std::vector< WalkerList > walkersByType;
+
   Picture empMapPicture;
 
   //walkers fast access map !!!
   city::WalkerGrid walkersGrid;
   //*********************** !!!
 
+  city::MetricsGrid metrics;
+
   city::SrvcList services;
   BorderInfo borderInfo;
   Tilemap tilemap;
@@ -132,6 +163,7 @@ public:
   ClimateType climate;   
   Walker::UniqueId walkerIdCount;
   unsigned int age;
+  unsigned int tilesRevision;
   int sentiment;
 
 public:
@@ -142,7 +174,10 @@ public:
   void calculatePopulation( PlayerCityPtr city );
   void beforeOverlayDestroyed(PlayerCityPtr city, TileOverlayPtr overlay );
   void updateWalkers(unsigned int time);
+  void appendWalker( const WalkerPtr& walker );
+  WalkerList& typeWalkers( walker::Type type );
   void updateOverlays( PlayerCityPtr city, unsigned int time);
+  void computeOverlays( unsigned int time );
   void updateServices( PlayerCityPtr city, unsigned int time );
 
 signals public:
@@ -163,10 +198,12 @@ PlayerCity::PlayerCity(world::EmpirePtr empire)
   _d->population = 0;
   _d->funds.setTaxRate( 7 );
   _d->age = 0;
+  _d->tilesRevision = 0;
   _d->walkerIdCount = 1;
   _d->climate = city::climate::central;
   _d->sentiment = 60;
   _d->empMapPicture = Picture::load( ResourceGroup::empirebits, 1 );
+  _d->walkersByType.resize( walker::all );
 
   addService( city::Migration::create( this ) );
   addService( city::WorkersHire::create( this ) );
@@ -236,9 +273,19 @@ void PlayerCity::timeStep(unsigned int time)
   _d->updateOverlays( this, time );
   _d->updateServices( this, time );
 
+  // houses consume services every few days, daily refresh is enough for info layers
+  if( GameDate::isDayChanged() )
+    _d->metrics.invalidate();
+
   if( getOption( updateRoads ) > 0 )
   {
     setOption( updateRoads, 0 );
+
+    city::RoadsPtr roads;
+    roads << findService( city::Roads::defaultName() );
+    if( roads.isValid() )
+      roads->invalidate();
+
     // for each overlay
     foreach( it, _d->overlays )
     {
@@ -267,27 +314,19 @@ void PlayerCity::Impl::monthStep( PlayerCityPtr city, const DateTime& time )
   funds.updateHistory( GameDate::current() );
 }
 
-WalkerList PlayerCity::walkers( walker::Type rtype )
+const WalkerList& PlayerCity::walkers( walker::Type rtype )
 {
   if( rtype == walker::all )
   {
     return _d->walkers;
   }
 
-  WalkerList res;
-  foreach( w, _d->walkers )
-  {
-    if( (*w)->type() == rtype  )
-    {
-      res.push_back( *w );
-    }
-  }
-
-  return res;
+  return _d->typeWalkers( rtype );
 }
 
 const WalkerList& PlayerCity::walkers(const TilePos& pos) { return _d->walkersGrid.at( pos ); }
 const WalkerList& PlayerCity::walkers() const { return _d->walkers; }
+city::MetricsGrid& PlayerCity::metrics() { return _d->metrics; }
 
 void PlayerCity::setBorderInfo(const BorderInfo& info)
 {
@@ -401,22 +440,89 @@ void PlayerCity::Impl::updateWalkers( unsigned int time )
   WalkerList::iterator walkerIt = walkers.begin();
   while( walkerIt != walkers.end() )
   {
-    WalkerPtr walker = *walkerIt;
+    // list keeps walker alive, no need to grab it here
+    Walker* walker = walkerIt->object();
     walker->timeStep( time );
     if( walker->isDeleted() )
     {
       // remove the walker from the walkers list
       walkersGrid.remove( *walkerIt );
+      typeWalkers( walker->type() ).remove( *walkerIt );
       walkerIt = walkers.erase(walkerIt);
     }
     else { ++walkerIt; }
   }
-  walkers << newWalkers;
+
+  foreach( it, newWalkers ) { appendWalker( *it ); }
   newWalkers.clear();
 }
 
+void PlayerCity::Impl::appendWalker( const WalkerPtr& walker )
+{
+  walkers.push_back( walker );
+
+  WalkerList& sameType = typeWalkers( walker->type() );
+  if( sameType.empty() )
+  {
+    // first walker of this type, start loading its animations
+    AnimationBank::prefetch( walker->type() );
+  }
+  sameType.push_back( walker );
+}
+
+WalkerList& PlayerCity::Impl::typeWalkers( walker::Type type )
+{
+  // types out of enum range share last list
+  return walkersByType[ std::min<unsigned int>( type, walkersByType.size()-1 ) ];
+}
+
+void PlayerCity::Impl::computeOverlays( unsigned int time )
+{
+  computeQueue.clear();
+  foreach( it, overlays )
+  {
+    if( !(*it)->isDeleted() )
+      computeQueue.push_back( (*it).object() );
+  }
+
+  if( computeQueue.empty() )
+    return;
+
+  WorkerPool& pool = WorkerPool::instance();
+  unsigned int tasksCount = 1;
+  if( computeQueue.size() >= minParallelOverlays )
+  {
+    // few tasks per thread, overlays have different weight
+    tasksCount = std::min<unsigned int>( pool.concurrency() * 4, computeQueue.size() / 64 );
+  }
+
+  while( computeTasks.size() < tasksCount )
+    computeTasks.push_back( new OverlaysStepTask() );
+
+  WorkerPool::Tasks tasks;
+  TileOverlay** first = &computeQueue[0];
+  const unsigned int total = computeQueue.size();
+  for( unsigned int k=0; k < tasksCount; k++ )
+  {
+    OverlaysStepTask& task = *computeTasks[ k ];
+    task.begin = first + total * k / tasksCount;
+    task.end = first + total * (k+1) / tasksCount;
+    task.time = time;
+    tasks.push_back( &task );
+  }
+
+  if( tasksCount == 1 )
+    computeTasks.front()->task();
+  else
+    pool.execute( tasks );
+}
+
 void PlayerCity::Impl::updateOverlays( PlayerCityPtr city, unsigned int time )
 {
+  // parallel phase: every overlay updates own state
+  computeOverlays( time );
+
+  // serial phase: walkers, city services and neighbours may change
   TileOverlayList::iterator overlayIt = overlays.begin();
   while( overlayIt != overlays.end() )
   {
@@ -428,6 +534,7 @@ void PlayerCity::Impl::updateOverlays( PlayerCityPtr city, unsigned int time )
       // remove the overlay from the overlay list
       (*overlayIt)->destroy();
       overlayIt = overlays.erase(overlayIt);
+      tilesRevision++;
     }
     else
     {
@@ -529,6 +636,7 @@ void PlayerCity::load( const VariantMap& stream )
   City::load( stream );
   _d->tilemap.load( stream.get( lc_tilemap ).toMap() );
   _d->walkersGrid.resize( Size( _d->tilemap.size() ) );
+  _d->metrics.resize( Size( _d->tilemap.size() ) );
   _d->walkerIdCount = (Walker::UniqueId)stream.get( lc_walkerIdCount ).toUInt();
   setOption( PlayerCity::forceBuild, 1 );
 
@@ -587,7 +695,7 @@ void PlayerCity::load( const VariantMap& stream )
     if( walker.isValid() )
     {
       walker->load( walkerInfo );
-      _d->walkers.push_back( walker );
+      _d->appendWalker( walker );
     }
     else
     {
@@ -632,7 +740,10 @@ void PlayerCity::load( const VariantMap& stream )
 
 void PlayerCity::addOverlay( TileOverlayPtr overlay ) { _d->newOverlays.push_back( overlay ); }
 
-PlayerCity::~PlayerCity() {}
+PlayerCity::~PlayerCity()
+{
+  foreach( it, _d->computeTasks ) { delete *it; }
+}
 
 void PlayerCity::addWalker( WalkerPtr walker )
 {
@@ -683,7 +794,15 @@ Signal1<int>& PlayerCity::onFundsChanged() {  return _d->funds.onChange(); }
 void PlayerCity::setCameraPos(const TilePos pos) { _d->cameraStart = pos; }
 TilePos PlayerCity::cameraPos() const {return _d->cameraStart; }
 void PlayerCity::addService( city::SrvcPtr service ) {  _d->services.push_back( service ); }
-void PlayerCity::setOption(PlayerCity::OptionType opt, int value) { _d->options[ opt ] = value; }
+void PlayerCity::setOption(PlayerCity::OptionType opt, int value)
+{
+  _d->options[ opt ] = value;
+
+  if( opt == updateTiles && value > 0 )
+    _d->tilesRevision++;
+}
+
+unsigned int PlayerCity::tilesRevision() const { return _d->tilesRevision; }
 
 int PlayerCity::prosperity() const
 {
@@ -708,7 +827,9 @@ void PlayerCity::clean()
   _d->services.clear();
 
   _d->walkers.clear();
+  foreach( it, _d->walkersByType ) { it->clear(); }
   _d->walkersGrid.clear();
+  _d->metrics.clear();
   _d->overlays.clear();
   _d->tilemap.resize( 0 );
 }
@@ -717,6 +838,7 @@ void PlayerCity::resize( unsigned int size)
 {
   _d->tilemap.resize( size );
   _d->walkersGrid.resize( Size( size ) );
+  _d->metrics.resize( Size( size ) );
 }
 
 PlayerCityPtr PlayerCity::create( world::EmpirePtr empire, PlayerPtr player )
@@ -35,6 +35,7 @@ namespace city
   class VictoryConditions;
   class TradeOptions;
   class BuildOptions;
+  class MetricsGrid;
 }
 
 struct BorderInfo
@@ -56,10 +57,13 @@ public:
 
   virtual void timeStep(unsigned int time);  // performs one simulation step
 
-  WalkerList walkers(constants::walker::Type type );
+  const WalkerList& walkers(constants::walker::Type type );
   const WalkerList& walkers(const TilePos& pos);
   const WalkerList& walkers() const;
 
+  //! cached house and building values for info layers
+  city::MetricsGrid& metrics();
+
   void addWalker( WalkerPtr walker );
 
   void addService( city::SrvcPtr service );
@@ -125,6 +129,9 @@ public:
   void setOption( OptionType opt, int value );
   int getOption( OptionType opt ) const;
 
+  // changes every time when tiles or overlays of city were changed
+  unsigned int tilesRevision() const;
+
   void clean();
   void resize(unsigned int size );
    
@@ -75,7 +75,7 @@ void Animals::timeStep(const unsigned int time)
 
     if( maxAnimalInCity > 0 )
     {
-      WalkerList animals = _city()->walkers( walkerType );
+      const WalkerList& animals = _city()->walkers( walkerType );
       if( animals.size() < maxAnimalInCity )
       {
         AnimalPtr animal = ptr_cast<Animal>( WalkerManager::instance().create( walkerType, _city() ) );
@@ -87,7 +87,7 @@ void Disorder::timeStep( const unsigned int time )
   Helper helper( _city() );
   HouseList houses = helper.find<House>( building::house );
 
-  WalkerList walkers = _city()->walkers( walker::protestor );
+  const WalkerList& walkers = _city()->walkers( walker::protestor );
 
   HouseList criminalizedHouse;
   _d->currentCrimeLevel = 0;
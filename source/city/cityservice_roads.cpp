@@ -17,7 +17,7 @@
 
 #include "cityservice_roads.hpp"
 #include "objects/construction.hpp"
-#include "city/helper.hpp"
+#include "city/city.hpp"
 #include "game/gamedate.hpp"
 #include "pathway/path_finding.hpp"
 #include "gfx/tilemap.hpp"
@@ -25,6 +25,9 @@
 #include "objects/house_level.hpp"
 #include "objects/road.hpp"
 #include "objects/constants.hpp"
+#include "core/foreach.hpp"
+
+#include <map>
 
 using namespace constants;
 using namespace gfx;
@@ -38,13 +41,34 @@ public:
   typedef std::pair< ConstructionPtr, int > UpdateInfo;
   typedef std::vector< UpdateInfo > Updates;
   typedef std::pair<TileOverlay::Type, int> UpdateBuilding;
+  typedef std::map<TileOverlay::Type, int> PavingRanges;
+
+  struct Source
+  {
+    TilePos pos;
+    int range;
+
+    Source( const TilePos& p, int r ) : pos( p ), range( r ) {}
+    bool operator==( const Source& a ) const { return pos == a.pos && range == a.range; }
+  };
+
+  typedef std::vector< Source > Sources;
 
   int defaultIncreasePaved;
   int defaultDecreasePaved;
+  PavingRanges ranges;
 
   DateTime lastTimeUpdate;
 
-  void updateRoadsAround(Propagator& propagator, UpdateInfo info );
+  // cached influence of paving buildings, one counter per tile,
+  // rebuild only when sources or road network was changed
+  std::vector<int> influence;
+  Sources sources;
+  bool roadsChanged;
+  unsigned int mapSize;
+
+  void updateRoadsAround( Propagator& propagator, UpdateInfo info );
+  void rebuildInfluence( PlayerCityPtr city, const Updates& updates );
 };
 
 SrvcPtr Roads::create(PlayerCityPtr city)
@@ -61,7 +85,16 @@ Roads::Roads( PlayerCityPtr city )
 {
   _d->defaultIncreasePaved = 4;
   _d->defaultDecreasePaved = -1;
-  _d->lastTimeUpdate = GameDate::current();  
+  _d->lastTimeUpdate = GameDate::current();
+  _d->roadsChanged = true;
+  _d->mapSize = 0;
+
+  _d->ranges[ building::senate ] = 10;
+  _d->ranges[ building::templeCeres ] = 4;
+  _d->ranges[ building::templeMars ] = 4;
+  _d->ranges[ building::templeMercury ] = 4;
+  _d->ranges[ building::templeNeptune ] = 4;
+  _d->ranges[ building::templeVenus ] = 4;
 }
 
 void Roads::timeStep( const unsigned int time )
@@ -71,46 +104,67 @@ void Roads::timeStep( const unsigned int time )
 
   _d->lastTimeUpdate = GameDate::current();
 
-  std::vector< Impl::UpdateBuilding > btypes;
-  btypes.push_back( Impl::UpdateBuilding(building::senate, 10) );
-  btypes.push_back( Impl::UpdateBuilding(building::templeCeres, 4));
-  btypes.push_back( Impl::UpdateBuilding(building::templeMars, 4));
-  btypes.push_back( Impl::UpdateBuilding(building::templeMercury, 4));
-  btypes.push_back( Impl::UpdateBuilding(building::templeNeptune, 4));
-  btypes.push_back( Impl::UpdateBuilding(building::templeVenus, 4));
-
-  Helper helper( _city() );
-
   Impl::Updates positions;
-  foreach( it, btypes )
+  Impl::Sources sources;
+  RoadList roads;
+
+  // one pass over overlays instead of search for every building type
+  TileOverlayList& overlays = _city()->overlays();
+  foreach( it, overlays )
   {
-    BuildingList tmp = helper.find<Building>( it->first );
+    TileOverlay::Type type = (*it)->type();
+    if( type == construction::road )
+    {
+      RoadPtr road = ptr_cast<Road>( *it );
+      if( road.isValid() )
+        roads.push_back( road );
+      continue;
+    }
 
-    foreach( b, tmp )
+    int range = 0;
+    Impl::PavingRanges::const_iterator rangeIt = _d->ranges.find( type );
+    if( rangeIt != _d->ranges.end() )
     {
-      positions.push_back( Impl::UpdateInfo( b->object(), it->second ) );
+      range = rangeIt->second;
+    }
+    else if( type == building::house )
+    {
+      HousePtr house = ptr_cast<House>( *it );
+      if( house.isValid() && house->spec().level() >= HouseLevel::bigMansion )
+        range = 5;
     }
-  }
 
-  HouseList houses = helper.find<House>( building::house );
-  foreach( house, houses )
-  {
-    if( (*house)->spec().level() >= HouseLevel::bigMansion )
+    if( range > 0 )
     {
-      positions.push_back( Impl::UpdateInfo( house->object(), 5 ) );
+      ConstructionPtr construction = ptr_cast<Construction>( *it );
+      if( construction.isValid() )
+      {
+        positions.push_back( Impl::UpdateInfo( construction, range ) );
+        sources.push_back( Impl::Source( construction->pos(), range ) );
+      }
     }
   }
 
-  Propagator propagator( _city() );
-  foreach( upos, positions )
+  unsigned int mapSize = _city()->tilemap().size();
+  if( _d->roadsChanged || mapSize != _d->mapSize || !(sources == _d->sources) )
   {
-    _d->updateRoadsAround( propagator, *upos );
+    _d->roadsChanged = false;
+    _d->mapSize = mapSize;
+    _d->sources = sources;
+    _d->rebuildInfluence( _city(), positions );
   }
 
-  if( _d->lastTimeUpdate.month() % 3 == 1 )
+  bool needDecrease = ( _d->lastTimeUpdate.month() % 3 == 1 );
+  foreach( road, roads )
   {
-    RoadList roads = helper.find<Road>( construction::road );
-    foreach( road, roads )
+    const TilePos& pos = (*road)->pos();
+    int count = _d->influence[ pos.j() * _d->mapSize + pos.i() ];
+    if( count > 0 )
+    {
+      (*road)->appendPaved( _d->defaultIncreasePaved * count );
+    }
+
+    if( needDecrease )
     {
       (*road)->appendPaved( _d->defaultDecreasePaved );
     }
@@ -118,6 +172,7 @@ void Roads::timeStep( const unsigned int time )
 }
 
 Roads::~Roads() {}
+void Roads::invalidate() { _d->roadsChanged = true; }
 
 void Roads::Impl::updateRoadsAround( Propagator& propagator, UpdateInfo info )
 {
@@ -129,13 +184,23 @@ void Roads::Impl::updateRoadsAround( Propagator& propagator, UpdateInfo info )
     const TilesArray& tiles = (*current)->allTiles();
     foreach( it, tiles )
     {
-      RoadPtr road = ptr_cast<Road>( (*it)->overlay() );
-      if( road.isValid() )
+      if( is_kind_of<Road>( (*it)->overlay() ) )
       {
-        road->appendPaved( defaultIncreasePaved );
+        influence[ (*it)->j() * mapSize + (*it)->i() ]++;
       }
     }
   }
 }
 
+void Roads::Impl::rebuildInfluence( PlayerCityPtr city, const Updates& updates )
+{
+  influence.assign( mapSize * mapSize, 0 );
+
+  Propagator propagator( city );
+  foreach( upos, updates )
+  {
+    updateRoadsAround( propagator, *upos );
+  }
+}
+
 }//end namesapce city
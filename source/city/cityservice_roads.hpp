@@ -33,6 +33,10 @@ public:
 
   virtual void timeStep( const unsigned int time );
   virtual ~Roads();
+
+  //! walkable tiles were built or removed, paving influence must be rebuilt
+  void invalidate();
+
 private:
   Roads(PlayerCityPtr city);
 
@@ -40,6 +44,8 @@ private:
   ScopedPtr< Impl > _d;
 };
 
+typedef SmartPtr<Roads> RoadsPtr;
+
 }//end namespace city
 
 #endif //__CAESARIA_CITYSERVICE_ROADS_H_INCLUDED__
@@ -50,7 +50,6 @@ public:
   typedef std::vector<TileOverlay::Type> BuildingsType;
   typedef std::map<TileOverlay::Group, BuildingsType> GroupBuildings;
 
-  WalkerList hrInCity;
   unsigned int distance;
   DateTime lastMessageDate;
   HirePriorities priorities;
@@ -59,7 +58,7 @@ public:
 
 public:
   void fillIndustryMap();
-  bool haveRecruter( WorkingBuildingPtr building );
+  bool haveRecruter( PlayerCityPtr city, WorkingBuildingPtr building );
   void hireWorkers( PlayerCityPtr city, WorkingBuildingPtr bld );
 };
 
@@ -101,8 +100,9 @@ void WorkersHire::Impl::fillIndustryMap()
   }
 }
 
-bool WorkersHire::Impl::haveRecruter( WorkingBuildingPtr building )
+bool WorkersHire::Impl::haveRecruter( PlayerCityPtr city, WorkingBuildingPtr building )
 {
+  const WalkerList& hrInCity = city->walkers( walker::recruter );
   foreach( w, hrInCity )
   {
     RecruterPtr hr = ptr_cast<Recruter>( *w );
@@ -124,7 +124,7 @@ void WorkersHire::Impl::hireWorkers(PlayerCityPtr city, WorkingBuildingPtr bld)
   if( bld->numberWorkers() == bld->maximumWorkers() )
     return;
 
-  if( haveRecruter( bld ) )
+  if( haveRecruter( city, bld ) )
     return;
 
   if( bld->getAccessRoads().size() > 0 )
@@ -145,8 +145,6 @@ void WorkersHire::timeStep( const unsigned int time )
   if( _city()->population() == 0 )
     return;
 
-  _d->hrInCity = _city()->walkers( walker::recruter );
-
   city::Helper helper( _city() );
   WorkingBuildingList buildings = helper.find< WorkingBuilding >( building::any );
 
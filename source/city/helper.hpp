@@ -127,17 +127,19 @@ public:
   SmartList< T > find( constants::walker::Type type,
                        TilePos start, TilePos stop=Helper::invalidPos )
   {
-    WalkerList walkersInArea;
-
     TilePos invalidPos( -1, -1 );
     TilePos stopPos = stop;
 
     if( start == invalidPos )
     {
-      const WalkerList& all = _city->walkers();
-      walkersInArea.insert( walkersInArea.end(), all.begin(), all.end() );
+      // city keeps walkers by type, no need to check every one
+      SmartList< T > result;
+      result << _city->walkers( type );
+      return result;
     }
-    else if( stopPos == invalidPos )
+
+    WalkerList walkersInArea;
+    if( stopPos == invalidPos )
     {
       const WalkerList& wlkOnTile = _city->walkers( start );
       walkersInArea.insert( walkersInArea.end(), wlkOnTile.begin(), wlkOnTile.end() );
@@ -0,0 +1,160 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "metricsgrid.hpp"
+#include "objects/house.hpp"
+#include "objects/house_level.hpp"
+#include "objects/constants.hpp"
+#include "gfx/tileoverlay.hpp"
+#include "core/math.hpp"
+
+using namespace constants;
+using namespace gfx;
+
+namespace city
+{
+
+MetricsGrid::MetricsGrid() : _stamp( 1 ) {}
+
+void MetricsGrid::resize( const Size& size )
+{
+  _size = size;
+  _grid.clear();
+
+  Entry empty;
+  empty.overlay = 0;
+  empty.stamp = 0;
+  empty.computed = 0;
+  _grid.resize( size.area(), empty );
+}
+
+void MetricsGrid::clear()
+{
+  foreach( it, _grid )
+  {
+    it->overlay = 0;
+    it->stamp = 0;
+    it->computed = 0;
+  }
+}
+
+void MetricsGrid::invalidate() { _stamp++; }
+
+int MetricsGrid::value( TileOverlay* overlay, Column column )
+{
+  if( overlay == 0 )
+    return 0;
+
+  const TilePos pos = overlay->pos();
+  unsigned int offset = pos.j() * _size.width() + pos.i();
+  if( offset >= _grid.size() )
+    return 0;
+
+  // overlay may be replaced on this place since last computation
+  Entry& entry = _grid[ offset ];
+  if( entry.stamp != _stamp || entry.overlay != overlay )
+  {
+    entry.overlay = overlay;
+    entry.stamp = _stamp;
+    entry.computed = 0;
+  }
+
+  const unsigned int bit = 1 << column;
+  if( (entry.computed & bit) == 0 )
+  {
+    entry.values[ column ] = _compute( overlay, column );
+    entry.computed |= bit;
+  }
+
+  return entry.values[ column ];
+}
+
+int MetricsGrid::_compute( TileOverlay* overlay, Column column )
+{
+  Construction* constr = safety_cast<Construction*>( overlay );
+  if( !constr )
+    return 0;
+
+  switch( column )
+  {
+  case fire: return (int)constr->state( Construction::fire );
+  case damage: return safety_cast<Building*>( overlay ) ? (int)constr->state( Construction::damage ) : 0;
+  case trouble: return constr->troubleDesc().empty() ? 0 : 1;
+  default: break;
+  }
+
+  House* house = safety_cast<House*>( overlay );
+  if( !house )
+    return 0;
+
+  const HouseSpecification& spec = house->spec();
+
+  switch( column )
+  {
+  case vacant: return (spec.level() == 1) && house->habitants().empty();
+
+  case health: return (int)house->state( House::health );
+  case hospital: return (int)house->getServiceValue( Service::hospital );
+  case barber: return (int)house->getServiceValue( Service::barber );
+  case baths: return (int)house->getServiceValue( Service::baths );
+
+  case school: return (int)house->getServiceValue( Service::school );
+  case library: return (int)house->getServiceValue( Service::library );
+  case academy: return (int)house->getServiceValue( Service::academy );
+
+  case education:
+  {
+    float acc = 0;
+    int level = spec.minEducationLevel();
+    switch( level )
+    {
+    case 3: acc += house->getServiceValue( Service::academy );
+    case 2: acc += house->getServiceValue( Service::library );
+    case 1: acc += house->getServiceValue( Service::school );
+      return static_cast<int>( acc / level );
+    default: return 0;
+    }
+  }
+
+  case entertainment:
+    return math::percentage( spec.computeEntertainmentLevel( house ), spec.minEntertainmentLevel() );
+  case theater: return (int)house->getServiceValue( Service::theater );
+  case amphitheater: return (int)house->getServiceValue( Service::amphitheater );
+  case colloseum: return (int)house->getServiceValue( Service::colloseum );
+  case hippodrome: return (int)house->getServiceValue( Service::hippodrome );
+
+  case religion:
+  {
+    int religionLevel = (int)house->getServiceValue( Service::religionMercury );
+    religionLevel += house->getServiceValue( Service::religionVenus );
+    religionLevel += house->getServiceValue( Service::religionMars );
+    religionLevel += house->getServiceValue( Service::religionNeptune );
+    religionLevel += house->getServiceValue( Service::religionCeres );
+    return math::clamp( religionLevel / (spec.minReligionLevel()+1), 0, 100 );
+  }
+
+  case tax: return math::clamp<int>( house->taxesThisYear(), 0, 100 );
+  case crime: return (int)house->getServiceValue( Service::crime );
+  case food: return (int)house->state( (Construction::Param)House::food );
+
+  default: break;
+  }
+
+  return 0;
+}
+
+}
@@ -0,0 +1,71 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#ifndef __CAESARIA_METRICS_GRID_H_INCLUDED__
+#define __CAESARIA_METRICS_GRID_H_INCLUDED__
+
+#include "gfx/predefinitions.hpp"
+#include "core/size.hpp"
+#include <vector>
+
+namespace city
+{
+
+// values shown by info layers, shared by all layers, every column
+// is computed only when some layer asks it and kept until invalidate()
+class MetricsGrid
+{
+public:
+  typedef enum { vacant=0,
+                 health, hospital, barber, baths,
+                 education, school, library, academy,
+                 entertainment, theater, amphitheater, colloseum, hippodrome,
+                 religion, tax, crime, fire, damage, food, trouble,
+                 columnsCount } Column;
+
+  MetricsGrid();
+
+  void resize( const Size& size );
+  void clear();
+
+  //! city state changed, every value must be computed again when asked
+  void invalidate();
+
+  //! value for overlay, computed on first request after invalidate
+  int value( gfx::TileOverlay* overlay, Column column );
+
+private:
+  struct Entry
+  {
+    gfx::TileOverlay* overlay;
+    unsigned int stamp;
+    unsigned int computed;  // bit per column
+    int values[ columnsCount ];
+  };
+
+  int _compute( gfx::TileOverlay* overlay, Column column );
+
+  typedef std::vector< Entry > Grid;
+
+  Size _size;
+  unsigned int _stamp;
+  Grid _grid;
+};
+
+}
+
+#endif//__CAESARIA_METRICS_GRID_H_INCLUDED__
@@ -26,12 +26,169 @@
 #include "core/direction.hpp"
 #include "objects/objects_factory.hpp"
 #include "pathway/astarpathfinding.hpp"
+#include "core/foreach.hpp"
+#include "thread/workerpool.hpp"
 #include <fstream>
 #include <cfloat>
+#include <queue>
+#include <algorithm>
 
 using namespace gfx;
 
-MidpointDisplacement::MidpointDisplacement(int n, int wmult, int hmult, float smoothness, float terrainSquare)
+namespace {
+enum { tasksMinRows=16 };
+
+//one pass of heightmap generation over a band of rows, random values come from
+//position hash so bands can run on any thread in any order with same result
+class HeightmapRowsTask : public CTask
+{
+public:
+  typedef enum { diamond=0, square, classify } Mode;
+
+  Mode mode;
+  float* heights;
+  int* types;
+  const float* thresholds;
+  int width;
+  int height;
+  int step;
+  float h;
+  unsigned int seed;
+  int firstRow;
+  int lastRow;
+
+  float noise( int index ) const
+  {
+    return Random::hash( seed + step, index ) * 2 * h - h;
+  }
+
+  void diamondRows()
+  {
+    int y = firstRow + ( ( 3 * step - firstRow % ( 2 * step ) ) % ( 2 * step ) );
+    for( ; y < lastRow; y += 2 * step )
+    {
+      float* up = heights + (y - step) * width;
+      float* down = heights + (y + step) * width;
+      for( int x = step; x < width; x += 2 * step )
+      {
+        float sum = up[ x - step ] + down[ x - step ] + up[ x + step ] + down[ x + step ];
+        heights[ x + y * width ] = sum / 4 + noise( x + y * width );
+      }
+    }
+  }
+
+  void squareRows()
+  {
+    int y = firstRow + ( ( step - firstRow % step ) % step );
+    for( ; y < lastRow; y += step )
+    {
+      for( int x = step * ( 1 - (y / step) % 2 ); x < width; x += 2 * step )
+      {
+        float sum = 0;
+        int count = 0;
+        int index = x + y * width;
+        if( x - step >= 0 ) { sum += heights[ index - step ]; count++; }
+        if( x + step < width ) { sum += heights[ index + step ]; count++; }
+        if( y - step >= 0 ) { sum += heights[ index - step * width ]; count++; }
+        if( y + step < height ) { sum += heights[ index + step * width ]; count++; }
+
+        heights[ index ] = count > 0 ? sum / count + noise( index ) : 0;
+      }
+    }
+  }
+
+  //clamp and terrain type selection in one sweep
+  void classifyRows()
+  {
+    for( int index = firstRow * width; index < lastRow * width; index++ )
+    {
+      float value = math::clamp<float>( heights[ index ], FLT_MIN, FLT_MAX );
+      int type = MidpointDisplacement::highMountain;
+      for( int k=0; k < 7; k++ )
+      {
+        if( value < thresholds[ k ] )
+        {
+          type = MidpointDisplacement::deepWater + k;
+          break;
+        }
+      }
+
+      types[ index ] = type;
+    }
+  }
+
+  virtual bool task()
+  {
+    switch( mode )
+    {
+    case diamond: diamondRows(); break;
+    case square: squareRows(); break;
+    case classify: classifyRows(); break;
+    }
+
+    return true;
+  }
+};
+
+class HeightmapPasses
+{
+public:
+  HeightmapPasses( int rows )
+  {
+    unsigned int count = math::clamp<unsigned int>( rows / tasksMinRows, 1, WorkerPool::instance().concurrency() );
+    for( unsigned int k=0; k < count; k++ )
+    {
+      tasks.push_back( new HeightmapRowsTask() );
+      tasks.back()->firstRow = rows * k / count;
+      tasks.back()->lastRow = rows * (k+1) / count;
+    }
+  }
+
+  ~HeightmapPasses()
+  {
+    foreach( it, tasks ) { delete *it; }
+  }
+
+  void setup( float* heights, int* types, const float* thresholds, int width, int height, unsigned int seed )
+  {
+    foreach( it, tasks )
+    {
+      (*it)->heights = heights;
+      (*it)->types = types;
+      (*it)->thresholds = thresholds;
+      (*it)->width = width;
+      (*it)->height = height;
+      (*it)->seed = seed;
+      (*it)->step = 1;
+      (*it)->h = 0;
+    }
+  }
+
+  void run( HeightmapRowsTask::Mode mode, int step, float h )
+  {
+    WorkerPool::Tasks ptasks;
+    foreach( it, tasks )
+    {
+      (*it)->mode = mode;
+      (*it)->step = step;
+      (*it)->h = h;
+      ptasks.push_back( *it );
+    }
+
+    if( tasks.size() == 1 )
+      tasks.front()->task();
+    else
+      WorkerPool::instance().execute( ptasks );
+  }
+
+private:
+  std::vector< HeightmapRowsTask* > tasks;
+};
+
+}
+
+MidpointDisplacement::MidpointDisplacement(int n, int wmult, int hmult, float smoothness, float terrainSquare, unsigned int seed)
+  : random_( (int)seed )
 {
   n_ = n;
   wmult_ = wmult;
@@ -45,7 +202,7 @@ MidpointDisplacement::MidpointDisplacement(int n, int wmult, int hmult, float sm
   hills_threshold_ = 2.60;
   shallow_mountains_threshold_ = 2.92;
   high_mountains_threshold_ = 0;
-  random_ = Random();
+  seed_ = seed;
   width_ = 10;
   height_ = 10;
 }
@@ -68,7 +225,7 @@ std::pair<int, int> MidpointDisplacement::VectorIndexToCoordinates(int i)
 
 std::vector<int> MidpointDisplacement::map()
 {
-  int power = pow(2, (float)n_);
+  int power = 1 << n_;
   int width = wmult_ * power + 1;
   int height = hmult_ * power + 1;
 
@@ -82,8 +239,6 @@ std::vector<int> MidpointDisplacement::map()
   return_map.resize(width_ * height_);
 
   int step = power / 2;
-  float sum;
-  int count;
 
   float h = _terrainSquare;
 
@@ -104,92 +259,24 @@ std::vector<int> MidpointDisplacement::map()
   }
 
   map[ CoordinatesToVectorIndex((width_ - 1) / 2, (height_ - 1) / 2) ] = (2 * h) + random_.Float(1, 5);
-  /*map.at(CoordinatesToVectorIndex(0, 0)) = -3;
-map.at(CoordinatesToVectorIndex((width_ - 1), 0)) = -3;
-map.at(CoordinatesToVectorIndex(0, (height_ - 1))) = -3;
-map.at(CoordinatesToVectorIndex((width_ - 1), (height_ - 1))) = -3;
-map.at(CoordinatesToVectorIndex((width_ - 1) / 2, (height_ - 1) / 2)) = 3;*/
 
-  while(step > 0) {
+  //high mountains threshold is zero, everything above shallow mountains becomes high mountain
+  float thresholds[7] = { deep_water_threshold_, water_threshold_, sand_threshold_, grass_threshold_,
+                          hills_threshold_, shallow_mountains_threshold_, FLT_MAX };
 
-    //Diamond
-    for (int x = step; x < width_; x += 2 * step)
-    {
-      for (int y = step; y < height_; y += 2 * step)
-      {
-        sum = map[ CoordinatesToVectorIndex(x - step, y - step) ]
-            + map[ CoordinatesToVectorIndex(x - step, y + step) ]
-            + map[ CoordinatesToVectorIndex(x + step, y - step) ]
-            + map[ CoordinatesToVectorIndex(x + step, y + step) ];
-        map[ CoordinatesToVectorIndex(x, y) ] = sum / 4 + random_.Float(-h, h); //???
-      }
-    }
+  HeightmapPasses passes( height_ );
+  passes.setup( &map[0], &return_map[0], thresholds, width_, height_, seed_ );
+
+  while(step > 0) {
+    passes.run( HeightmapRowsTask::diamond, step, h );
+    passes.run( HeightmapRowsTask::square, step, h );
 
-    //Square
-    for (int x = 0; x < width_; x += step) {
-      for (int y = step * (1 - (x / step) % 2); y < height_; y += 2 * step) {
-        sum = 0;
-        count = 0;
-        if(x - step >= 0) {
-          sum += map[ CoordinatesToVectorIndex(x - step, y) ];
-          count++;
-        }
-        if(x + step < width) {
-          sum += map[ CoordinatesToVectorIndex(x + step, y) ];
-          count++;
-        }
-        if(y - step >= 0) {
-          sum += map[ CoordinatesToVectorIndex(x, y - step) ];
-          count++;
-        }
-        if(y + step < height_) {
-          sum += map[ CoordinatesToVectorIndex(x, y + step) ];
-          count++;
-        }
-        if(count > 0) {
-          map[ CoordinatesToVectorIndex(x, y) ] = sum / count + random_.Float(-h, h); //???
-        } else {
-          map[ CoordinatesToVectorIndex(x, y) ] = 0;
-        }
-      }
-    }
     h /= smoothness_;
     step /= 2;
   }
 
-  float max = FLT_MAX;
-  float min = FLT_MIN;
-
-  for (unsigned int i = 0; i < map.size(); i++)
-  {
-    if(map[ i ] > max)
-    {
-      map[ i ] = max;
-    }
-
-    if(map[ i ] < min)
-    {
-      map[ i ] = min;
-    }
-  }
+  passes.run( HeightmapRowsTask::classify, 1, 0 );
 
-  for (unsigned int i = 0; i < map.size(); i++) {
-    //std::cout << map.at(i);
-    //map.at(i) = (map.at(i) - min) / (max - min);
-    //std::cout << map.at(i);
-    float value = map[ i ];
-    int new_value = unknown;
-    if(value < deep_water_threshold_) {      new_value = deepWater;    }
-    else if (value < water_threshold_) {      new_value = water;    }
-    else if (value < sand_threshold_) {      new_value = coast;    }
-    else if (value < grass_threshold_) {      new_value = grass;    }
-    else if (value < hills_threshold_) {      new_value = trees;    }
-    else if (value < shallow_mountains_threshold_) {      new_value = shallowMountain;    }
-    else if (value < high_mountains_threshold_) {      new_value = highMountain;    }
-    else {      new_value = highMountain;    }
-   // new_value = (value * 255) + 255;
-    return_map[ i ] = new_value;
-  }
   return return_map;
 }
 
@@ -246,7 +333,7 @@ TilePos psAr[8] = { TilePos(0, 1), TilePos(-1, 1), TilePos(-1, 0), TilePos(-1, -
                     TilePos(0, -1), TilePos(1, -1), TilePos(1, 0), TilePos(1, 1)};
 }
 
-static void __finalizeMap(Game& game, int pass )
+static void __finalizeMap(Game& game, Random& rgen, int pass )
 {
   PlayerCityPtr oCity = game.city();
   Tilemap& oTilemap = oCity->tilemap();
@@ -389,7 +476,7 @@ static void __finalizeMap(Game& game, int pass )
         {
         case 0:
         {
-          Picture pic = Picture::load( ResourceGroup::land1a, 62 + math::random( 57 ) );
+          Picture pic = Picture::load( ResourceGroup::land1a, 62 + rgen.Integer( 0, 56 ) );
           wtile.setPicture( pic );
           //wtile.setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
           wtile.setOriginalImgId( direction );
@@ -406,7 +493,7 @@ static void __finalizeMap(Game& game, int pass )
       if( start > 0 )
       {
         if( rnd > 0 )
-          rnd = math::random( 4 );
+          rnd = rgen.Integer( 0, 3 );
 
         wtile.setFlag( Tile::tlWater, true );
         wtile.setFlag( Tile::tlCoast, true );
@@ -417,185 +504,232 @@ static void __finalizeMap(Game& game, int pass )
     }
 }
 
-class TerrainGeneratorHelper
+namespace {
+
+//dijkstra over flat tile grid with own move costs, one search serves all queries
+//which start from any source tile, i.e. rivers to nearest water or road between map sides
+class CostField
 {
 public:
-  void canBuildRoad( const Tile* tile, bool& ret )
+  enum { impassable=0, unreached=0x7fffffff };
+
+  CostField( Tilemap& tilemap )
+    : tmap( tilemap ), size( tilemap.size() )
   {
-    ret = tile->isWalkable( true ) || tile->getFlag( Tile::tlTree );
+    costs.resize( size * size, impassable );
+    distance.resize( size * size, unreached );
+    from.resize( size * size, -1 );
   }
 
-  void canBuildRiver( const Tile* tile, bool& ret )
+  int index( const TilePos& pos ) const { return pos.i() + pos.j() * size; }
+  Tile& tile( int index ) { return tmap.at( index % size, index / size ); }
+
+  void addSource( int index )
   {
-    ret = (  tile->getFlag( Tile::tlWater ) || tile->getFlag( Tile::tlGrass ) || tile->getFlag( Tile::tlTree ) );
+    if( costs[ index ] == impassable || distance[ index ] == 0 )
+      return;
+
+    distance[ index ] = 0;
+    queue.push( Step( 0, index ) );
   }
 
-  Pathway findWay(Tilemap& oTilemap, int startSide, int endSide )
+  //expand field, stops at first reached tile marked in targets when they given
+  int compute( const std::vector<char>* targets=0 )
   {
-    Pathfinder& pathfinder = Pathfinder::instance();
-    pathfinder.setCondition( makeDelegate( this, &TerrainGeneratorHelper::canBuildRoad ) );
+    while( !queue.empty() )
+    {
+      Step current = queue.top();
+      queue.pop();
+
+      int index = current.second;
+      if( -current.first != distance[ index ] )
+        continue;
 
-    TilesArray tiles = sideTiles( startSide, oTilemap );
-    tiles = tiles.walkableTiles( true );
+      if( targets && (*targets)[ index ] )
+        return index;
 
-    if( tiles.empty() )
-      return Pathway();
+      int i = index % size;
+      int j = index / size;
+      int neighbors[4] = { j+1 < size ? index + size : -1, i > 0 ? index - 1 : -1,
+                           j > 0 ? index - size : -1, i+1 < size ? index + 1 : -1 };
+      for( int k=0; k < 4; k++ )
+      {
+        int next = neighbors[ k ];
+        if( next < 0 || costs[ next ] == impassable )
+          continue;
 
-    TilesArray otherTiles = sideTiles( endSide, oTilemap );
-    otherTiles = otherTiles.walkableTiles( true );
+        int nextDistance = distance[ index ] + costs[ next ];
+        if( nextDistance < distance[ next ] )
+        {
+          distance[ next ] = nextDistance;
+          from[ next ] = index;
+          queue.push( Step( -nextDistance, next ) );
+        }
+      }
+    }
 
-    return findWay( tiles, otherTiles );
+    return -1;
   }
 
-  Pathway findWay( const TilesArray& startTiles, const TilesArray& arrivedTiles )
+  //tiles from given one back to the source it was reached from
+  TilesArray pathToSource( int index )
   {
-    if( arrivedTiles.empty() || startTiles.empty() )
-      return Pathway();
-
-    Pathfinder& pathfinder = Pathfinder::instance();
-    unsigned int mainLimiter = 10;
-    unsigned int stTileLimiter = startTiles.size() > mainLimiter
-                                   ? startTiles.size() / mainLimiter : 1;
-    for( unsigned int tileIndex = 0; tileIndex < startTiles.size(); tileIndex += stTileLimiter )
-    {
-      Tile* rtile = startTiles[ tileIndex ];
+    TilesArray ret;
+    if( distance[ index ] == unreached )
+      return ret;
 
-      unsigned int arvTileLimiter = arrivedTiles.size() > mainLimiter
-                                      ? arrivedTiles.size() / mainLimiter : 1;
-      for( unsigned int arvTileIndex=0; arvTileIndex < arrivedTiles.size(); arvTileIndex += arvTileLimiter )
-      {
-        Tile* endTile = arrivedTiles[ arvTileIndex ];
+    for( ; index >= 0; index = from[ index ] )
+      ret.push_back( &tile( index ) );
 
-        Pathway way = pathfinder.getPath( *rtile, *endTile, Pathfinder::customCondition | Pathfinder::fourDirection );
+    return ret;
+  }
 
-        if( way.isValid() )
-          return way;
-      }
-    }
+  std::vector<unsigned char> costs;
 
-    return Pathway();
-  }
+private:
+  typedef std::pair<int, int> Step;
 
-  TilesArray sideTiles( int side, Tilemap& oTilemap )
+  Tilemap& tmap;
+  int size;
+  std::vector<int> distance;
+  std::vector<int> from;
+  std::priority_queue< Step > queue;
+};
+
+TilesArray __sideTiles( int side, Tilemap& oTilemap )
+{
+  int mapSize = oTilemap.size();
+  switch( side % 4 )
   {
-    int mapSize = oTilemap.size();
-    switch( side % 4 )
-    {
-    case 0: return oTilemap.getArea( TilePos( 0, 0), TilePos( 0, mapSize-1 ) );
-    case 1: return oTilemap.getArea( TilePos( 0, mapSize-1), TilePos( mapSize-1, mapSize-1 ) );
-    case 2: return oTilemap.getArea( TilePos( mapSize-1, mapSize-1), TilePos( mapSize-1, 0 ) );
-    case 3: return oTilemap.getArea( TilePos( mapSize-1, 0), TilePos( 0, 0 ) );
-    }
+  case 0: return oTilemap.getArea( TilePos( 0, 0), TilePos( 0, mapSize-1 ) );
+  case 1: return oTilemap.getArea( TilePos( 0, mapSize-1), TilePos( mapSize-1, mapSize-1 ) );
+  case 2: return oTilemap.getArea( TilePos( mapSize-1, mapSize-1), TilePos( mapSize-1, 0 ) );
+  case 3: return oTilemap.getArea( TilePos( mapSize-1, 0), TilePos( 0, 0 ) );
+  }
+
+  return TilesArray();
+}
 
+TilesArray __findRoadWay( Tilemap& oTilemap, int startSide, int endSide )
+{
+  TilesArray startTiles = __sideTiles( startSide, oTilemap ).walkableTiles( true );
+  TilesArray endTiles = __sideTiles( endSide, oTilemap ).walkableTiles( true );
+  if( startTiles.empty() || endTiles.empty() )
     return TilesArray();
+
+  CostField field( oTilemap );
+  int mapSize = oTilemap.size();
+  for( int index=0; index < mapSize * mapSize; index++ )
+  {
+    Tile& tile = field.tile( index );
+    if( tile.isWalkable( true ) ) { field.costs[ index ] = 1; }
+    else if( tile.getFlag( Tile::tlTree ) ) { field.costs[ index ] = 2; }
   }
-};
 
-static void __createRivers(Game& game )
+  std::vector<char> targets( mapSize * mapSize, 0 );
+  foreach( it, endTiles ) { targets[ field.index( (*it)->pos() ) ] = 1; }
+  foreach( it, startTiles ) { field.addSource( field.index( (*it)->pos() ) ); }
+
+  int arrived = field.compute( &targets );
+  if( arrived < 0 )
+    return TilesArray();
+
+  TilesArray way = field.pathToSource( arrived );
+  std::reverse( way.begin(), way.end() );
+  return way;
+}
+
+}
+
+static void __createRivers(Game& game, Random& rgen )
 {
   PlayerCityPtr oCity = game.city();
   Tilemap& oTilemap = oCity->tilemap();
+  int mapSize = oTilemap.size();
 
-  TerrainGeneratorHelper tgHelper;
-  Pathfinder& pathfinder = Pathfinder::instance();
-  pathfinder.setCondition( makeDelegate( &tgHelper, &TerrainGeneratorHelper::canBuildRiver ) );
+  //rivers go over water, grass and trees to nearest water tile
+  CostField field( oTilemap );
+  std::vector<int> terrainTiles;
+  for( int index=0; index < mapSize * mapSize; index++ )
+  {
+    Tile& tile = field.tile( index );
+    if( tile.getFlag( Tile::tlWater ) || tile.getFlag( Tile::tlGrass ) || tile.getFlag( Tile::tlTree ) )
+      field.costs[ index ] = 1;
+
+    if( tile.isWalkable( true ) || tile.getFlag( Tile::tlTree ) )
+      terrainTiles.push_back( index );
+  }
 
-  TilesArray terrainTiles = oTilemap.getArea( TilePos(0,0), Size( oTilemap.size() ) );
-  for( TilesArray::iterator it=terrainTiles.begin(); it != terrainTiles.end(); )
+  if( terrainTiles.empty() )
+    return;
+
+  for( int index=0; index < mapSize * mapSize; index++ )
   {
-    Tile* tile = *it;
-    if( tile->isWalkable( true ) || tile->getFlag( Tile::tlTree ) ) { ++it; }
-    else { it = terrainTiles.erase( it ); }
+    if( field.tile( index ).getFlag( Tile::tlWater ) )
+      field.addSource( index );
   }
 
+  field.compute();
+
   int riverCount = 0;
   for( int tryCount=0; tryCount < 20;  tryCount++ )
   {
-    if( riverCount++ > oTilemap.size() / 60 )
+    if( riverCount++ > mapSize / 60 )
       break;
 
-    Tile* centertile = terrainTiles.random();
-    Pathway way;
-    for( int range=0; range < 99; range++ )
-    {
-      TilesArray perimeter = oTilemap.getRectangle( range, centertile->pos() );
-      foreach( it, perimeter )
-      {
-        Tile* currentTile = *it;
-        if( currentTile->getFlag( Tile::tlWater ) )
-        {
-          way = pathfinder.getPath( *centertile, *currentTile, Pathfinder::customCondition | Pathfinder::fourDirection );
-          if( way.isValid() )
-          {
-            break;
-          }
-        }
-      }
-
-      if( way.isValid() )
-        break;
-    }
+    int center = terrainTiles[ rgen.Integer( 0, terrainTiles.size() - 1 ) ];
+    TilesArray wayTiles = field.pathToSource( center );
 
-    if( way.isValid() )
+    foreach( it, wayTiles )
     {
-      TilesArray wayTiles = way.allTiles();
+      TileOverlayPtr overlay = TileOverlayFactory::instance().create( constants::building::river );
 
-      foreach( it, wayTiles )
-      {
-        TileOverlayPtr overlay = TileOverlayFactory::instance().create( constants::building::river );
-
-        //Picture pic = Picture::load( ResourceGroup::land1a, 62 + math::random( 57 ) );
-        (*it)->setPicture( Picture::getInvalid() );
-        //(*it)->setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
-        (*it)->setOriginalImgId( 0 );
+      (*it)->setPicture( Picture::getInvalid() );
+      (*it)->setOriginalImgId( 0 );
 
-        bool isWater = (*it)->getFlag( Tile::tlWater );
+      //previous river may cross this one, it is water already
+      bool isWater = (*it)->getFlag( Tile::tlWater );
 
-        overlay->build( oCity, (*it)->pos() );
-        oCity->overlays().push_back( overlay );
+      overlay->build( oCity, (*it)->pos() );
+      oCity->overlays().push_back( overlay );
 
-        if( isWater )
-          break;
-      }
+      if( isWater )
+        break;
     }
   }
 }
 
-static void __createRoad(Game& game )
+static void __createRoad(Game& game, Random& rgen )
 {
   PlayerCityPtr oCity = game.city();
   Tilemap& oTilemap = oCity->tilemap();
 
-  TerrainGeneratorHelper tgHelper;
-
-  Pathway way;
+  TilesArray wayTiles;
   for( int side=0; side < 2; side++ )
   {
-    way = tgHelper.findWay( oTilemap, side, side + 2 );
+    wayTiles = __findRoadWay( oTilemap, side, side + 2 );
 
-    if( !way.isValid() )
+    if( wayTiles.empty() )
     {
-      way = tgHelper.findWay( oTilemap, side, side + 1 );
+      wayTiles = __findRoadWay( oTilemap, side, side + 1 );
     }
 
-    if( !way.isValid() )
+    if( wayTiles.empty() )
     {
-      way = tgHelper.findWay( oTilemap, side, side + 3 );
+      wayTiles = __findRoadWay( oTilemap, side, side + 3 );
     }
 
-    if( way.isValid() )
+    if( !wayTiles.empty() )
       break;
   }
 
-  if( way.isValid() )
+  if( !wayTiles.empty() )
   {
-    TilesArray wayTiles = way.allTiles();
-
     foreach( it, wayTiles )
     {
       TileOverlayPtr overlay = TileOverlayFactory::instance().create( constants::construction::road );
 
-      Picture pic = Picture::load( ResourceGroup::land1a, PicID::grassPic + math::random( PicID::grassPicsNumber ) );
+      Picture pic = Picture::load( ResourceGroup::land1a, PicID::grassPic + rgen.Integer( 0, PicID::grassPicsNumber - 1 ) );
       (*it)->setPicture( pic );
       (*it)->setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
 
@@ -605,15 +739,21 @@ static void __createRoad(Game& game )
 
     BorderInfo borderInfo = oCity->borderInfo();
 
-    borderInfo.roadEntry = way.startPos();
-    borderInfo.roadExit = way.stopPos();
+    borderInfo.roadEntry = wayTiles.front()->pos();
+    borderInfo.roadExit = wayTiles.back()->pos();
     oCity->setBorderInfo( borderInfo );
   }
 }
 
-void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrainSq)
+void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrainSq, unsigned int seed )
 {
-  MidpointDisplacement diamond_square = MidpointDisplacement(n2size, 8, 8, smooth, terrainSq);
+  if( seed == 0 )
+    seed = (unsigned int)time( 0 );
+
+  Logger::warning( "TerrainGenerator: seed %u", seed );
+
+  Random rgen( (int)seed );
+  MidpointDisplacement diamond_square = MidpointDisplacement(n2size, 8, 8, smooth, terrainSq, seed);
   std::vector<int> map = diamond_square.map();
 
   /*vfs::NFile nfile = vfs::NFile::open( vfs::Path( "test.ter" ), vfs::Entity::fmWrite );
@@ -704,7 +844,7 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
         case 0: pic = ;
         case 1:
         }*/
-        pic = Picture::load( ResourceGroup::land1a, 62 + math::random( 57 ) );
+        pic = Picture::load( ResourceGroup::land1a, 62 + rgen.Integer( 0, 56 ) );
         tile.setPicture( pic );
         tile.setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
       }
@@ -714,7 +854,7 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
       {
         color = NColor( 255, 32, 139, 58);
         int start=30, rnd=31;
-        if( math::random( 10 ) > 6 )
+        if( rgen.Integer( 0, 9 ) > 6 )
         {
           start = 10;
           rnd = 7;
@@ -730,7 +870,7 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
           tile.setFlag( Tile::tlTree, true );
         }
 
-        Picture pic = Picture::load( ResourceGroup::land1a, start + math::random( rnd ) );
+        Picture pic = Picture::load( ResourceGroup::land1a, start + rgen.Integer( 0, rnd - 1 ) );
         tile.setPicture( pic );
         tile.setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
       }
@@ -738,7 +878,7 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
 
       case MidpointDisplacement::shallowMountain: {
         color = NColor( 255, 147, 188, 157 );
-        Picture pic = Picture::load( ResourceGroup::land1a, 290 + math::random( 7 ) );
+        Picture pic = Picture::load( ResourceGroup::land1a, 290 + rgen.Integer( 0, 6 ) );
         tile.setFlag( Tile::tlRock, true );
         tile.setPicture( pic );
         tile.setOriginalImgId( TileHelper::convPicName2Id( pic.name() ) );
@@ -747,7 +887,7 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
 
       case MidpointDisplacement::highMountain: {
         color = NColor( 255, 129, 141, 132);
-        Picture pic = Picture::load( ResourceGroup::land1a, 62 + math::random( 57 ) );
+        Picture pic = Picture::load( ResourceGroup::land1a, 62 + rgen.Integer( 0, 56 ) );
         //Picture::load( ResourceGroup::land1a, 230 + math::random( 59 ) );
         //tile.setFlag( Tile::tlRock, true );
         tile.setPicture( pic );
@@ -765,21 +905,21 @@ void TerrainGenerator::create(Game& game, int n2size, float smooth, float terrai
 
   __removeCorners( game );
 
-  __finalizeMap( game, passCheckNorthCoastTiles );
-  __finalizeMap( game, passCheckEastCoastTiles );
-  __finalizeMap( game, passCheckSouthCoastTiles );
-  __finalizeMap( game, passCheckWestCoastTiles );
-  __finalizeMap( game, passCheckSmallCoastTiles );
-  //__finalizeMap( game, 6 );
-  __finalizeMap( game, passCheckInsideCornerTiles );
-  __finalizeMap( game, 8 );
-  __finalizeMap( game, 9 );
+  __finalizeMap( game, rgen, passCheckNorthCoastTiles );
+  __finalizeMap( game, rgen, passCheckEastCoastTiles );
+  __finalizeMap( game, rgen, passCheckSouthCoastTiles );
+  __finalizeMap( game, rgen, passCheckWestCoastTiles );
+  __finalizeMap( game, rgen, passCheckSmallCoastTiles );
+  //__finalizeMap( game, rgen, 6 );
+  __finalizeMap( game, rgen, passCheckInsideCornerTiles );
+  __finalizeMap( game, rgen, 8 );
+  __finalizeMap( game, rgen, 9 );
 
-  __finalizeMap( game, 0xff );
+  __finalizeMap( game, rgen, 0xff );
+
+  __createRivers( game, rgen );
+  __createRoad( game, rgen );
 
   //update pathfinder map
   Pathfinder::instance().update( oTilemap );
-
-  __createRivers( game );
-  __createRoad( game );
 }
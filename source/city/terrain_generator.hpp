@@ -27,7 +27,7 @@ class Game;
 class MidpointDisplacement
 {
  public:
-  MidpointDisplacement(int n, int wmult, int hmult, float smoothness, float terrainSquare);
+  MidpointDisplacement(int n, int wmult, int hmult, float smoothness, float terrainSquare, unsigned int seed);
   ~MidpointDisplacement() {}
   std::vector<int> map();
   int width() const { return width_; }
@@ -51,6 +51,7 @@ private:
   float _terrainSquare;
   int width_;
   int height_;
+  unsigned int seed_;
   Random random_;
 };
 
@@ -59,7 +60,8 @@ class TerrainGenerator
 public:
   void setSaveFile( vfs::Path filename );
   void create( Game& game, vfs::Path filename );
-  void create( Game& game, int n2size, float smooth, float terrainSq );
+  //! same seed and parameters always produce the same map, zero seed takes current time
+  void create( Game& game, int n2size, float smooth, float terrainSq, unsigned int seed=0 );
 };
 
 #endif //_CAESARIA_TERRAIN_GENERATOR_INCLUDE_H_
@@ -18,31 +18,49 @@
 #include "terrain_generator_random.hpp"
 
 Random::Random() {
-  srand(static_cast <unsigned> (time(0)));
+  _state = static_cast <unsigned> (time(0));
 }
 
 Random::Random(int seed) {
-  srand(seed);
+  _state = static_cast <unsigned> (seed);
 }
 
 Random::Random(double seed) {
-  srand(seed);
+  _state = static_cast <unsigned> (seed);
 }
 
 Random::Random(float seed) {
-  srand(seed);
+  _state = static_cast <unsigned> (seed);
+}
+
+unsigned int Random::next() {
+  //lcg step with mixed output, any seed including zero is fine
+  _state = _state * 1664525u + 1013904223u;
+  unsigned int x = _state;
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  return x;
+}
+
+float Random::hash(unsigned int seed, unsigned int key) {
+  unsigned int x = seed ^ (key * 0x9e3779b9u);
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return static_cast <float> ((x >> 8) * (1.0 / 16777216.0));
 }
 
 int Random::Integer(int minimum, int maximum) {
-  return minimum + (std::rand() % (maximum - minimum + 1));
+  return minimum + static_cast <int> (next() % static_cast <unsigned> (maximum - minimum + 1));
 }
 
 double Random::Double(double minimum, double maximum) {
-  return minimum + fmod(std::rand(), (maximum - minimum + 1.0));
+  return minimum + (next() * (1.0 / 4294967296.0)) * (maximum - minimum);
 }
 
 float Random::Float(float minimum, float maximum) {
-  return minimum + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (maximum - minimum)));
+  return minimum + static_cast <float> ((next() >> 8) * (1.0 / 16777216.0)) * (maximum - minimum);
 }
-
-
@@ -32,6 +32,14 @@ class Random {
   int Integer(int minimum, int maximum);
   double Double(double minimum, double maximum);
   float Float(float minimum, float maximum);
+
+  //! next raw value of own generator sequence, same seed gives same sequence
+  unsigned int next();
+
+  //! stateless noise value in [0,1) for given seed and key, safe for any thread
+  static float hash( unsigned int seed, unsigned int key );
+private:
+  unsigned int _state;
 };
 
 
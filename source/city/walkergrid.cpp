@@ -37,7 +37,7 @@ void WalkerGrid::clear()
   }
 }
 
-void WalkerGrid::append( WalkerPtr a )
+void WalkerGrid::append( const WalkerPtr& a )
 {
   unsigned int offset = _offset( a->pos() );
   if( offset < _gsize )
@@ -58,7 +58,7 @@ const Size& WalkerGrid::size() const
   return _size;
 }
 
-void WalkerGrid::remove( WalkerPtr a)
+void WalkerGrid::remove( const WalkerPtr& a)
 {
   unsigned int offset = _offset( a->pos() );
   if( offset < _gsize )
@@ -37,10 +37,10 @@ public:
 
   void clear();
 
-  void append( WalkerPtr a );
+  void append( const WalkerPtr& a );
   void resize(Size size );
   const Size& size() const;
-  void remove( WalkerPtr a );
+  void remove( const WalkerPtr& a );
 
   const WalkerList& at(const TilePos &pos );
 
@@ -79,52 +79,67 @@ static const unsigned long crc_table[1][256] =
 
 
 /* ========================================================================= */
-#define DO1 crc = crc_table[0][((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8)
-#define DO8 DO1; DO1; DO1; DO1; DO1; DO1; DO1; DO1
+// slice-by-8 tables, row k gives crc of byte followed by k zero bytes
+class Crc32Tables
+{
+public:
+  unsigned int rows[8][256];
 
-/* ========================================================================= */
-unsigned long ByteArray::crc32(unsigned long crc)
+  Crc32Tables()
+  {
+    for( int n=0; n < 256; n++ )
+      rows[0][n] = (unsigned int)crc_table[0][n];
+
+    for( int n=0; n < 256; n++ )
+    {
+      unsigned int c = rows[0][n];
+      for( int k=1; k < 8; k++ )
+      {
+        c = rows[0][c & 0xff] ^ (c >> 8);
+        rows[k][n] = c;
+      }
+    }
+  }
+};
+
+// built on static initialization, before any thread can ask for crc
+static const Crc32Tables crcTables;
+
+static unsigned int __crc32( unsigned int crc, const unsigned char* buf, size_t len )
 {
-  if(size() == 0)
-    return 0UL;
+  const unsigned int (*t)[256] = crcTables.rows;
 
-  crc = crc ^ 0xffffffffUL;
-  unsigned int len = size();
-  const char* buf = data();
+  crc = ~crc;
   while( len >= 8 )
   {
-    DO8;
+    unsigned int low = crc ^ ( buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((unsigned int)buf[3] << 24) );
+    crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24]
+        ^ t[3][buf[4]] ^ t[2][buf[5]] ^ t[1][buf[6]] ^ t[0][buf[7]];
+    buf += 8;
     len -= 8;
   }
 
-  if( len )
-  {
-    do
-    {
-      DO1;
-    } while (--len);
-  }
+  while( len-- )
+    crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
 
-  return crc ^ 0xffffffffUL;
+  return ~crc;
 }
 
+/* ========================================================================= */
+unsigned long ByteArray::crc32(unsigned long crc)
+{
+  if(size() == 0)
+    return 0UL;
+
+  return __crc32( (unsigned int)crc, (const unsigned char*)data(), size() );
+}
 
 unsigned long ByteArray::CRC32(unsigned long crc, const char * data, size_t length)
 {
   if(length == 0)
     return 0UL;
 
-  crc = crc ^ 0xffffffffUL;
-  const char* buf = data;
-  size_t len = length;
-
-  do
-  {
-    DO1;
-    len --;
-  } while (len > 0);
-
-  return crc ^ 0xffffffffUL;
+  return __crc32( (unsigned int)crc, (const unsigned char*)data, length );
 }
 
 ByteArray::ByteArray()
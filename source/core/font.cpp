@@ -26,22 +26,287 @@
 #include "game/settings.hpp"
 #include "core/osystem.hpp"
 #include "gfx/engine.hpp"
+#include "core/foreach.hpp"
 #include <map>
 
 using namespace gfx;
 
+namespace {
+
+static const int glyphPageSize = 512;
+
+struct GlyphInfo
+{
+  int page;
+  Rect rect;    // place on atlas page, empty for glyphs without image
+  int xoffset;  // shift of image from pen position
+  int advance;
+  int index;    // glyph index in font face, used for kerning pairs
+};
+
+// glyph images of one font and color, packed by rows into atlas pages
+class GlyphCache
+{
+public:
+  GlyphCache( TTF_Font* font, const SDL_Color& color )
+    : _font( font ), _color( color ), _rowHeight( 0 ) {}
+  ~GlyphCache();
+
+  const GlyphInfo& glyph( unsigned int ch );
+  const Picture* page( int index ) const { return _pages[ index ]; }
+
+  // upload pages, which got new glyphs, to textures
+  void flush();
+
+private:
+  void _render( unsigned int ch, GlyphInfo& info );
+
+  typedef std::map< unsigned int, GlyphInfo > Glyphs;
+
+  TTF_Font* _font;
+  SDL_Color _color;
+  Glyphs _glyphs;
+  std::vector< Picture* > _pages;
+  std::vector< bool > _changed;
+  Point _cursor;
+  int _rowHeight;
+};
+
+typedef std::map< std::pair< TTF_Font*, int >, GlyphCache* > GlyphCaches;
+
+GlyphCaches& glyphCaches()
+{
+  static GlyphCaches inst;
+  return inst;
+}
+
+// next unicode character from utf8 string, characters beyond 16 bit are not supported by SDL_ttf
+unsigned int nextChar( const std::string& text, unsigned int& index )
+{
+  unsigned char c = text[ index++ ];
+  if( c < 0x80 )
+    return c;
+
+  int length = (c & 0xe0) == 0xc0 ? 1 : ((c & 0xf0) == 0xe0 ? 2 : 3);
+  unsigned int ch = c & (0x3f >> length);
+  for( int i=0; i < length && index < text.size(); i++ )
+  {
+    ch = (ch << 6) | (text[ index++ ] & 0x3f);
+  }
+
+  return ch > 0xffff ? '?' : ch;
+}
+
+std::string encodeChar( unsigned int ch )
+{
+  std::string ret;
+  if( ch < 0x80 ) { ret += (char)ch; }
+  else if( ch < 0x800 )
+  {
+    ret += (char)(0xc0 | (ch >> 6));
+    ret += (char)(0x80 | (ch & 0x3f));
+  }
+  else
+  {
+    ret += (char)(0xe0 | (ch >> 12));
+    ret += (char)(0x80 | ((ch >> 6) & 0x3f));
+    ret += (char)(0x80 | (ch & 0x3f));
+  }
+
+  return ret;
+}
+
+// "over" composition which keeps alpha of destination, so text can be
+// blended into transparent pictures without light fringes,
+// without blending covered pixels are copied with their alpha like SDL blit does
+void blendGlyph( SDL_Surface* src, const Rect& srcRect, SDL_Surface* dst, Point pos, bool blend )
+{
+  Rect area( pos, srcRect.size() );
+  area.clipAgainst( Rect( 0, 0, dst->w, dst->h ) );
+  if( area.width() <= 0 || area.height() <= 0 )
+    return;
+
+  Point srcStart = srcRect.lefttop() + area.lefttop() - pos;
+  unsigned int ashift = dst->format->Ashift;
+
+  for( int y=0; y < area.height(); y++ )
+  {
+    const unsigned int* s = (const unsigned int*)((const char*)src->pixels + (srcStart.y() + y) * src->pitch) + srcStart.x();
+    unsigned int* d = (unsigned int*)((char*)dst->pixels + (area.top() + y) * dst->pitch) + area.left();
+
+    for( int x=0; x < area.width(); x++, s++, d++ )
+    {
+      unsigned int sa = (*s >> ashift) & 0xff;
+      if( sa == 0 )
+        continue;
+
+      if( sa == 0xff || !blend )
+      {
+        *d = *s;
+        continue;
+      }
+
+      unsigned int da = (*d >> ashift) & 0xff;
+      unsigned int dk = da * (0xff - sa) / 0xff;
+      unsigned int oa = sa + dk;
+
+      unsigned int result = oa << ashift;
+      for( unsigned int shift=0; shift < 32; shift += 8 )
+      {
+        if( shift == ashift )
+          continue;
+
+        unsigned int sc = (*s >> shift) & 0xff;
+        unsigned int dc = (*d >> shift) & 0xff;
+        result |= ((sc * sa + dc * dk) / oa) << shift;
+      }
+
+      *d = result;
+    }
+  }
+}
+
+void drawGlyphs( const Font::Glyphs& glyphs, SDL_Surface* dst, const Point& offset, bool blend )
+{
+  if( SDL_MUSTLOCK( dst ) )
+    SDL_LockSurface( dst );
+
+  foreach( it, glyphs )
+  {
+    blendGlyph( it->page->surface(), it->rect, dst, offset + it->pos, blend );
+  }
+
+  if( SDL_MUSTLOCK( dst ) )
+    SDL_UnlockSurface( dst );
+}
+
+GlyphCache::~GlyphCache()
+{
+  foreach( it, _pages )
+  {
+    Picture::destroy( *it );
+    delete *it;
+  }
+}
+
+const GlyphInfo& GlyphCache::glyph(unsigned int ch)
+{
+  Glyphs::iterator it = _glyphs.find( ch );
+  if( it != _glyphs.end() )
+    return it->second;
+
+  GlyphInfo& info = _glyphs[ ch ];
+  _render( ch, info );
+  return info;
+}
+
+void GlyphCache::flush()
+{
+  for( unsigned int i=0; i < _pages.size(); i++ )
+  {
+    if( _changed[ i ] )
+    {
+      _pages[ i ]->update();
+      _changed[ i ] = false;
+    }
+  }
+}
+
+void GlyphCache::_render(unsigned int ch, GlyphInfo& info)
+{
+  int minx, maxx, miny, maxy, advance;
+  TTF_GlyphMetrics( _font, ch, &minx, &maxx, &miny, &maxy, &advance );
+
+  info.page = 0;
+  info.rect = Rect();
+  info.advance = advance;
+  info.index = TTF_GlyphIsProvided( _font, ch );
+  // SDL_ttf moves first glyph right when it begins before pen position
+  info.xoffset = std::min( minx, 0 );
+
+  std::string text = encodeChar( ch );
+#if defined(CAESARIA_PLATFORM_EMSCRIPTEN)
+  SDL_Surface* sGlyph = TTF_RenderText_Solid( _font, text.c_str(), _color );
+#else
+  SDL_Surface* sGlyph = TTF_RenderUTF8_Blended( _font, text.c_str(), _color );
+#endif
+
+  if( !sGlyph )
+    return;
+
+  if( _cursor.x() + sGlyph->w > glyphPageSize )
+  {
+    _cursor = Point( 0, _cursor.y() + _rowHeight + 1 );
+    _rowHeight = 0;
+  }
+
+  if( _pages.empty() || _cursor.y() + sGlyph->h > glyphPageSize )
+  {
+    Picture* page = Picture::create( Size( glyphPageSize ), 0, true );
+    page->fill( 0x00000000, Rect() );
+    _pages.push_back( page );
+    _changed.push_back( true );
+    _cursor = Point();
+    _rowHeight = 0;
+  }
+
+#if SDL_MAJOR_VERSION>1
+  SDL_SetSurfaceBlendMode( sGlyph, SDL_BLENDMODE_NONE );
+#else
+  SDL_SetAlpha( sGlyph, 0, 0 );
+#endif
+
+  info.page = _pages.size() - 1;
+  info.rect = Rect( _cursor, Size( sGlyph->w, sGlyph->h ) );
+
+  SDL_Rect dstRect = { _cursor.x(), _cursor.y(), sGlyph->w, sGlyph->h };
+  SDL_BlitSurface( sGlyph, 0, _pages.back()->surface(), &dstRect );
+  _changed.back() = true;
+
+  // one pixel gap, so glyphs don't bleed into each other when scaled
+  _cursor += Point( sGlyph->w + 1, 0 );
+  _rowHeight = std::max( _rowHeight, sGlyph->h );
+
+  SDL_FreeSurface( sGlyph );
+}
+
+}
+
 class Font::Impl
 {
 public:
   TTF_Font *ttfFont;
   SDL_Color color; 
+  GlyphCache* cache;
+
+  GlyphCache* glyphs();
 };
 
+GlyphCache* Font::Impl::glyphs()
+{
+  if( cache == 0 && ttfFont != 0 )
+  {
+    int key = (color.r << 24) + (color.g << 16) + (color.b << 8);
+#if SDL_MAJOR_VERSION>1
+    key += color.a;
+#else
+    key += color.unused;
+#endif
+    GlyphCache*& ref = glyphCaches()[ std::make_pair( ttfFont, key ) ];
+    if( ref == 0 )
+      ref = new GlyphCache( ttfFont, color );
+
+    cache = ref;
+  }
+
+  return cache;
+}
 
 Font::Font() : _d( new Impl )
 {
   _d->ttfFont = 0;
   _d->color = SDL_Color();
+  _d->cache = 0;
 }
 
 Font::Font( const Font& other ) : _d( new Impl )
@@ -173,6 +438,7 @@ void Font::setColor( NColor color )
 #else
   _d->color.unused = color.alpha();
 #endif
+  _d->cache = 0;
 }
 
 void Font::draw( Picture& dstpic, const std::string &text, const int dx, const int dy, bool useAlpha, bool updatextTx )
@@ -180,45 +446,18 @@ void Font::draw( Picture& dstpic, const std::string &text, const int dx, const i
   if( !_d->ttfFont || !dstpic.isValid() )
     return;
 
-#if defined(CAESARIA_PLATFORM_EMSCRIPTEN)
-  SDL_Surface* sText = TTF_RenderText_Solid( _d->ttfFont, text.c_str(), _d->color );
-#else
-  SDL_Surface* sText = TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
-#endif
-
-  if( sText )
+  SDL_Surface* dst = dstpic.surface();
+  if( !dst )
   {
-
-    if( useAlpha )
-    {
-#if SDL_MAJOR_VERSION>1
-      SDL_SetSurfaceBlendMode( sText, SDL_BLENDMODE_NONE );
-#else
-      SDL_SetAlpha( sText, 0, 0 );
-#endif
-    }
-
-    if( !dstpic.surface() )
-    {
-      Logger::warning("Font::draw dstpic surface is null");
-      return;
-    }
-
-    SDL_Rect srcRect, dstRect;
-
-    srcRect.x = 0;
-    srcRect.y = 0;
-    srcRect.w = sText->w;
-    srcRect.h = sText->h;
-    dstRect.x = dx;
-    dstRect.y = dy;
-    dstRect.w = sText->w;
-    dstRect.h = sText->h;
-
-    SDL_BlitSurface( sText, &srcRect, dstpic.surface(), &dstRect );
-    SDL_FreeSurface( sText );
+    Logger::warning("Font::draw dstpic surface is null");
+    return;
   }
 
+  // useAlpha keeps text alpha as is, like blit with blending disabled
+  Glyphs glyphs;
+  layout( text, Point( dx, dy ), glyphs );
+  drawGlyphs( glyphs, dst, Point(), !useAlpha );
+
   if( updatextTx )
     dstpic.update();
 }       
@@ -230,20 +469,94 @@ void Font::draw(Picture &dstpic, const std::string &text, const Point& pos, bool
 
 Picture* Font::once(const std::string &text, bool mayChange)
 {
-  SDL_Surface* textSurface = TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
-  Picture* ret = Picture::create( Size( textSurface->w, textSurface->h ), (unsigned char*)textSurface->pixels, mayChange );
-  SDL_FreeSurface( textSurface );
-  ret->update();
+  Size size = getTextSize( text );
+  Glyphs glyphs;
+  layout( text, Point(), glyphs );
+
+  if( mayChange )
+  {
+    Picture* ret = Picture::create( size, 0, true );
+    draw( *ret, glyphs, Point(), true );
+    return ret;
+  }
+
+  // static picture frees its surface after upload, so text is composed before
+  SDL_Surface* textSurface = SDL_CreateRGBSurface( 0, size.width(), size.height(), 32,
+                                                   0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+  SDL_FillRect( textSurface, 0, 0 );
+  drawGlyphs( glyphs, textSurface, Point(), false );
 
+  Picture* ret = Picture::create( size, (unsigned char*)textSurface->pixels, false );
+  SDL_FreeSurface( textSurface );
   return ret;
 }
 
+void Font::layout(const std::string& text, const Point& pos, Font::Glyphs& glyphs) const
+{
+  GlyphCache* cache = _d->glyphs();
+  if( !cache )
+    return;
+
+  // pairs are applied like TTF_SizeUTF8 does, so layout width matches getTextSize
+  bool kerning = TTF_GetFontKerning( _d->ttfFont ) != 0;
+  int prevIndex = 0;
+  int x = pos.x();
+  unsigned int index = 0;
+  while( index < text.size() )
+  {
+    const GlyphInfo& info = cache->glyph( nextChar( text, index ) );
+    if( kerning && prevIndex && info.index )
+      x += TTF_GetFontKerningSize( _d->ttfFont, prevIndex, info.index );
+    prevIndex = info.index;
+
+    if( info.rect.width() > 0 )
+    {
+      Glyph glyph;
+      glyph.page = cache->page( info.page );
+      glyph.rect = info.rect;
+      glyph.pos = Point( x + info.xoffset, pos.y() );
+      glyphs.push_back( glyph );
+    }
+
+    x += info.advance;
+  }
+}
+
+void Font::draw(Engine& painter, const Font::Glyphs& glyphs, const Point& offset, Rect* clipRect) const
+{
+  GlyphCache* cache = _d->glyphs();
+  if( !cache )
+    return;
+
+  cache->flush();
+  foreach( it, glyphs )
+  {
+    painter.draw( *it->page, it->rect, Rect( offset + it->pos, it->rect.size() ), clipRect );
+  }
+}
+
+void Font::draw(Picture& dstpic, const Font::Glyphs& glyphs, const Point& offset, bool updateTx) const
+{
+  SDL_Surface* dst = dstpic.surface();
+  if( !dst )
+  {
+    Logger::warning("Font::draw dstpic surface is null");
+    return;
+  }
+
+  drawGlyphs( glyphs, dst, offset, true );
+
+  if( updateTx )
+    dstpic.update();
+}
+
 Font::~Font() {}
 
 Font& Font::operator=( const Font& other )
 {
   _d->ttfFont = other._d->ttfFont;
   _d->color = other._d->color;
+  _d->cache = other._d->cache;
   return *this;
 }
 
@@ -341,6 +654,14 @@ void FontCollection::addFont(const int key, const std::string& name, vfs::Path p
   setFont( key, name, font0);
 }
 
+void FontCollection::clearGlyphs()
+{
+  foreach( it, glyphCaches() ) { delete it->second; }
+  glyphCaches().clear();
+
+  foreach( it, _d->collection ) { it->second._d->cache = 0; }
+}
+
 void FontCollection::initialize(const std::string &resourcePath)
 {
   vfs::Directory resDir( resourcePath );
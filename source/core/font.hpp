@@ -19,6 +19,7 @@
 #define __CAESARIA_FONT_H_INCLUDED__
 
 #include <string>
+#include <vector>
 #include "core/size.hpp"
 #include "core/rectangle.hpp"
 #include "core/alignment.hpp"
@@ -31,6 +32,7 @@ namespace gfx
 {
  class Picture;
  class PictureRef;
+ class Engine;
 }
 
 enum FontType { FONT_0, FONT_1, FONT_1_WHITE, FONT_1_RED, 
@@ -46,6 +48,16 @@ class Font
   friend class FontCollection;
 
 public:
+  //! part of glyph atlas page and its place relative to text position
+  struct Glyph
+  {
+    const gfx::Picture* page;
+    Rect rect;
+    Point pos;
+  };
+
+  typedef std::vector<Glyph> Glyphs;
+
   Font();
   static Font create( const std::string& family, const int size );
   static Font create( FontType type );
@@ -74,6 +86,15 @@ public:
 
   gfx::Picture* once(const std::string &text, bool mayChange=false);
 
+  //! append glyphs of text placed at pos, glyph images are cached per font and color
+  void layout( const std::string& text, const Point& pos, Glyphs& glyphs ) const;
+
+  //! draw glyphs with offset directly to screen
+  void draw( gfx::Engine& painter, const Glyphs& glyphs, const Point& offset, Rect* clipRect=0 ) const;
+
+  //! blend glyphs with offset into picture
+  void draw( gfx::Picture& dstpic, const Glyphs& glyphs, const Point& offset, bool updateTx=true ) const;
+
   unsigned int getWidthFromCharacter( unsigned int c ) const;
   int getCharacterFromPos(const std::wstring& text, int pixel_x) const;
   unsigned int kerningHeight() const;
@@ -96,6 +117,9 @@ public:
   void setFont(const int key, const std::string& name, Font font);  // save a font
   void addFont(const int key, const std::string& name, vfs::Path filename, const int size, const NColor& color);
 
+  //! free glyph atlas pages, must be called while render engine is alive
+  void clearGlyphs();
+
 private:
   FontCollection();
 
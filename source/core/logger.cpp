@@ -32,6 +32,7 @@
 #include <fstream>
 #include <map>
 #include "vfs/directory.hpp"
+#include "thread/thread.hpp"
 
 #ifdef CAESARIA_PLATFORM_ANDROID
 #include <android/log.h>
@@ -80,14 +81,19 @@ public:
 	virtual void write( std::string str, bool )
 	{
 		// Don't write progress stuff into the logfile
-		// Make sure only one thread is writing to the file at a time
+		// Only logger thread is writing to the file
 		if( _logFile )
 		{
 			fputs(str.c_str(), _logFile);
 			fputs("\n", _logFile);
-			fflush(_logFile);
 		}
 	}
+
+	virtual void flush()
+	{
+		if( _logFile )
+			fflush(_logFile);
+	}
 };
 
 class ConsoleLogWriter : public LogWriter
@@ -100,14 +106,52 @@ public:
       __android_log_print(ANDROID_LOG_DEBUG, CAESARIA_PLATFORM_NAME, "%s", str.c_str() );
 #else
     std::cout << str;
-    if( newline ) std::cout << std::endl;
-    else std::cout << std::flush;
+    if( newline ) std::cout << '\n';
+#endif
+	}
+
+	virtual void flush()
+	{
+#ifndef CAESARIA_PLATFORM_ANDROID
+		std::cout << std::flush;
 #endif
 	}
 
 	virtual bool isActive() const { return true; }
 };
 
+namespace
+{
+static const unsigned int queueSize = 1024;
+static const int maxMessageLength = 512;
+
+struct LogMessage
+{
+  std::string text;
+  bool newline;
+};
+
+// writes queued messages on logger thread
+class LogDrainTask : public CTask
+{
+public:
+  virtual bool task()
+  {
+    Logger::flush();
+    return true;
+  }
+};
+
+// formatting goes into stack of calling thread
+void formatMessage( std::string& out, const char* fmt, va_list args )
+{
+  char buffer[ maxMessageLength ];
+  int length = vsnprintf( buffer, maxMessageLength, fmt, args );
+  buffer[ maxMessageLength-1 ] = 0;
+  out = length >= 0 ? buffer : fmt;
+}
+}
+
 class Logger::Impl
 {
 public:
@@ -115,8 +159,25 @@ public:
   typedef List<std::string> Filters;
 
   Filters filters;
-
   Writers writers;
+  Level level;
+
+  // ring of messages, guarded by queueLock
+  std::vector< LogMessage > queue;
+  unsigned int head;
+  unsigned int queued;
+  bool drainScheduled;
+  Mutex queueLock;
+  volatile bool crashed;
+
+  // guards writers and filters, held while messages are written
+  Mutex writeLock;
+
+  ThreadPtr thread;
+  LogDrainTask drainTask;
+
+  void push( std::string& message, bool newline );
+  void drain();
 
   void write( const std::string& message, bool newline=true )
   {
@@ -140,35 +201,176 @@ public:
       }
     }
   }
-
 };
 
+void Logger::Impl::push( std::string& message, bool newline )
+{
+  if( crashed )
+  {
+    write( message, newline );
+    foreach( i, writers ) { if( i->second.isValid() ) i->second->flush(); }
+    return;
+  }
+
+  queueLock.lock();
+  while( queued == queue.size() )
+  {
+    // writer thread is behind, help it to keep memory bounded
+    queueLock.unlock();
+    drain();
+    queueLock.lock();
+  }
+
+  LogMessage& slot = queue[ (head + queued) % queue.size() ];
+  slot.text.swap( message );
+  slot.newline = newline;
+  queued++;
+
+  bool needSchedule = !drainScheduled && thread.isValid();
+  drainScheduled = true;
+  queueLock.unlock();
+
+  if( needSchedule && !thread->Event( &drainTask ) )
+  {
+    drain();
+  }
+  else if( !thread.isValid() )
+  {
+    drain();
+  }
+}
+
+void Logger::Impl::drain()
+{
+  MutexLocker writeLocker( &writeLock );
+
+  std::vector< LogMessage > batch;
+  while( true )
+  {
+    queueLock.lock();
+    if( queued == 0 )
+    {
+      drainScheduled = false;
+      queueLock.unlock();
+      break;
+    }
+
+    batch.resize( queued );
+    for( unsigned int k=0; k < batch.size(); k++ )
+    {
+      LogMessage& slot = queue[ (head + k) % queue.size() ];
+      batch[ k ].text.swap( slot.text );
+      batch[ k ].newline = slot.newline;
+    }
+    head = (head + queued) % queue.size();
+    queued = 0;
+    queueLock.unlock();
+
+    foreach( it, batch ) { write( it->text, it->newline ); }
+    foreach( i, writers ) { if( i->second.isValid() ) i->second->flush(); }
+  }
+}
+
 void Logger::warning( const char* fmt, ... )
 {
-  va_list argument_list;
+  if( lvWarning < instance()._d->level )
+    return;
 
+  std::string ret;
+  va_list argument_list;
   va_start(argument_list, fmt);
+  formatMessage( ret, fmt, argument_list );
+  va_end(argument_list);
+
+  instance()._d->push( ret, true );
+}
+
+void Logger::log( Level level, const char* fmt, ... )
+{
+  if( level < instance()._d->level )
+    return;
 
   std::string ret;
-  StringHelper::vformat( ret, 512, fmt, argument_list );
+  va_list argument_list;
+  va_start(argument_list, fmt);
+  formatMessage( ret, fmt, argument_list );
+  va_end(argument_list);
 
+  instance()._d->push( ret, true );
+}
+
+void Logger::debug( const char* fmt, ... )
+{
+  if( lvDebug < instance()._d->level )
+    return;
+
+  std::string ret;
+  va_list argument_list;
+  va_start(argument_list, fmt);
+  formatMessage( ret, fmt, argument_list );
   va_end(argument_list);
 
-  instance()._d->write( ret );
+  instance()._d->push( ret, true );
+}
+
+void Logger::warning(const std::string& text)
+{
+  if( lvWarning < instance()._d->level )
+    return;
+
+  std::string ret( text );
+  instance()._d->push( ret, true );
 }
 
-void Logger::warning(const std::string& text) {  instance()._d->write( text );}
 void Logger::warningIf(bool warn, const std::string& text){  if( warn ) warning( text ); }
-void Logger::update(const std::string& text, bool newline){  instance()._d->write( text, newline ); }
+
+void Logger::update(const std::string& text, bool newline)
+{
+  std::string ret( text );
+  instance()._d->push( ret, newline );
+}
+
+void Logger::setLevel(Logger::Level level) { instance()._d->level = level; }
+Logger::Level Logger::level() { return instance()._d->level; }
+void Logger::flush() { instance()._d->drain(); }
+
+void Logger::flushOnCrash()
+{
+  Impl& d = *instance()._d;
+  if( d.crashed )
+    return;
+
+  d.crashed = true;
+
+  // locks are only tried, if crashed thread holds them messages are written anyway
+  bool queueLocked = d.queueLock.tryLock();
+  bool writeLocked = d.writeLock.tryLock();
+
+  for( unsigned int k=0; k < d.queued; k++ )
+  {
+    LogMessage& slot = d.queue[ (d.head + k) % d.queue.size() ];
+    d.write( slot.text, slot.newline );
+  }
+  d.head = (d.head + d.queued) % d.queue.size();
+  d.queued = 0;
+
+  foreach( i, d.writers ) { if( i->second.isValid() ) i->second->flush(); }
+
+  if( writeLocked ) d.writeLock.unlock();
+  if( queueLocked ) d.queueLock.unlock();
+}
 
 void Logger::addFilter(const std::string text)
 {
   if (hasFilter(text)) return;
+
+  MutexLocker locker( &instance()._d->writeLock );
   instance()._d->filters.append(text);
 }
 
 bool Logger::hasFilter(const std::string text)
 {
+  MutexLocker locker( &instance()._d->writeLock );
   foreach(filter, instance()._d->filters)
   {
     if (*filter == text) return true;
@@ -178,6 +380,7 @@ bool Logger::hasFilter(const std::string text)
 
 bool Logger::removeFilter(const std::string text)
 {
+  MutexLocker locker( &instance()._d->writeLock );
   foreach(filter, instance()._d->filters)
   {
     if (*filter == text)
@@ -221,10 +424,26 @@ Logger& Logger::instance()
   return inst;
 }
 
-Logger::~Logger() {}
+Logger::~Logger()
+{
+  // after crash everything is written already and locks may be held
+  if( !_d->crashed )
+    _d->drain();
+  _d->thread = ThreadPtr();
+}
 
 Logger::Logger() : _d( new Impl )
 {
+  _d->level = lvDebug;
+  _d->queue.resize( queueSize );
+  _d->head = 0;
+  _d->queued = 0;
+  _d->drainScheduled = false;
+  _d->crashed = false;
+
+  _d->thread = ThreadPtr( new Thread() );
+  _d->thread->drop();
+
   CrashHandler_initCrashHandler();
 }
 
@@ -232,6 +451,7 @@ void Logger::registerWriter(std::string name, LogWriterPtr writer)
 {
   if( writer.isValid() && writer->isActive() )
   {
+    MutexLocker locker( &instance()._d->writeLock );
     instance()._d->writers[ name ] = writer;
   }
 }
@@ -251,6 +471,8 @@ void CrashHandler_initCrashHandler()
 
 void CrashHandler_handleCrash(int signum)
 {
+  Logger::flushOnCrash();
+
   switch(signum)
   {
     case SIGABRT: Logger::warning("SIGABRT: abort() called somewhere in the program."); break;
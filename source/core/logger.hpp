@@ -28,19 +28,40 @@ class LogWriter : public ReferenceCounted
 public:
   virtual void write( std::string, bool newLine ) = 0;
   virtual bool isActive() const = 0;
+
+  //! called after batch of messages was written
+  virtual void flush() {}
 };
 
 typedef SmartPtr<LogWriter> LogWriterPtr;
 
+// messages are queued by callers from any thread and
+// written by background thread in order of arrival
 class Logger
 {
 public:
   typedef enum { consolelog=0, filelog, count } Type;
+  typedef enum { lvDebug=0, lvInfo, lvWarning, lvError } Level;
+
   static void warning( const char* fmt, ...);
   static void warning( const std::string& text );
   static void warningIf( bool warn, const std::string& text );
   static void update( const std::string& text, bool newline=false );
 
+  static void log( Level level, const char* fmt, ... );
+  static void debug( const char* fmt, ... );
+
+  //! messages with lower level are dropped in runtime
+  static void setLevel( Level level );
+  static Level level();
+
+  //! writes all queued messages in calling thread
+  static void flush();
+
+  //! writes queued messages without waiting for locks, next messages are written
+  //! directly, crashed thread may hold logger locks, so crash handler uses it
+  static void flushOnCrash();
+
   static void addFilter(const std::string text);
   static bool hasFilter(const std::string text);
   static bool removeFilter(const std::string text);
@@ -57,6 +78,18 @@ private:
   ScopedPtr< Impl > _d;
 };
 
+// debug messages are removed by compiler when CAESARIA_LOG_LEVEL is above lvDebug,
+// arguments are not evaluated then: CAESARIA_LOG_DEBUG( "path %d", length );
+#ifndef CAESARIA_LOG_LEVEL
+  #ifdef DEBUG
+    #define CAESARIA_LOG_LEVEL 0
+  #else
+    #define CAESARIA_LOG_LEVEL 1
+  #endif
+#endif
+
+#define CAESARIA_LOG_DEBUG if( CAESARIA_LOG_LEVEL > Logger::lvDebug ) {} else Logger::debug
+
 void CrashHandler_initCrashHandler();
 void CrashHandler_handleCrash(int signum);
 
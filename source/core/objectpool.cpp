@@ -0,0 +1,115 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "objectpool.hpp"
+#include "thread/mutex.hpp"
+
+#include <new>
+#include <vector>
+
+namespace
+{
+const std::size_t granularity = 16;
+const std::size_t maxPooledSize = 1024;
+const std::size_t classesCount = maxPooledSize / granularity;
+const std::size_t chunkSize = 64 * 1024;
+
+struct FreeBlock
+{
+  FreeBlock* next;
+};
+}
+
+class ObjectPool::Impl
+{
+public:
+  FreeBlock* freeLists[ classesCount ];
+  std::vector< char* > chunks;
+  std::size_t used;
+  Mutex mutex;
+
+  void grow( std::size_t sizeClass );
+};
+
+ObjectPool& ObjectPool::instance()
+{
+  // never destroyed, objects may be deleted by static destructors
+  static ObjectPool* inst = new ObjectPool();
+  return *inst;
+}
+
+ObjectPool::ObjectPool() : _d( new Impl )
+{
+  for( std::size_t k=0; k < classesCount; k++ )
+    _d->freeLists[ k ] = 0;
+
+  _d->used = 0;
+}
+
+void ObjectPool::Impl::grow( std::size_t sizeClass )
+{
+  const std::size_t blockSize = (sizeClass + 1) * granularity;
+  char* chunk = static_cast<char*>( ::operator new( chunkSize ) );
+  chunks.push_back( chunk );
+
+  // blocks of new chunk are given out in address order
+  const std::size_t count = chunkSize / blockSize;
+  for( std::size_t k=count; k > 0; k-- )
+  {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>( chunk + (k-1) * blockSize );
+    block->next = freeLists[ sizeClass ];
+    freeLists[ sizeClass ] = block;
+  }
+}
+
+void* ObjectPool::allocate( std::size_t size )
+{
+  if( size == 0 || size > maxPooledSize )
+    return ::operator new( size );
+
+  const std::size_t sizeClass = (size - 1) / granularity;
+
+  MutexLocker locker( &_d->mutex );
+  if( !_d->freeLists[ sizeClass ] )
+    _d->grow( sizeClass );
+
+  FreeBlock* block = _d->freeLists[ sizeClass ];
+  _d->freeLists[ sizeClass ] = block->next;
+  _d->used++;
+
+  return block;
+}
+
+void ObjectPool::deallocate( void* ptr, std::size_t size )
+{
+  if( !ptr )
+    return;
+
+  if( size == 0 || size > maxPooledSize )
+  {
+    ::operator delete( ptr );
+    return;
+  }
+
+  const std::size_t sizeClass = (size - 1) / granularity;
+
+  MutexLocker locker( &_d->mutex );
+  FreeBlock* block = static_cast<FreeBlock*>( ptr );
+  block->next = _d->freeLists[ sizeClass ];
+  _d->freeLists[ sizeClass ] = block;
+  _d->used--;
+}
+
+std::size_t ObjectPool::used() const { return _d->used; }
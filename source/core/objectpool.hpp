@@ -0,0 +1,48 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef _CAESARIA_OBJECTPOOL_H_INCLUDE_
+#define _CAESARIA_OBJECTPOOL_H_INCLUDE_
+
+#include "core/scopedptr.hpp"
+#include <cstddef>
+
+// memory for often created objects, blocks of one size are taken
+// from common chunks and go back to free list of that size after delete
+class ObjectPool
+{
+public:
+  static ObjectPool& instance();
+
+  void* allocate( std::size_t size );
+  void deallocate( void* ptr, std::size_t size );
+
+  //! number of blocks given out now
+  std::size_t used() const;
+
+private:
+  ObjectPool();
+
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+//! class and its children are allocated from ObjectPool
+#define CAESARIA_POOL_ALLOCATED \
+  public: \
+  static void* operator new( std::size_t size ) { return ObjectPool::instance().allocate( size ); } \
+  static void operator delete( void* ptr, std::size_t size ) { ObjectPool::instance().deallocate( ptr, size ); }
+
+#endif //_CAESARIA_OBJECTPOOL_H_INCLUDE_
@@ -40,7 +40,7 @@ public:
     return *this;
   }
 
-  SmartList& operator<<( SmartPtr< T > a )
+  SmartList& operator<<( const SmartPtr< T >& a )
   {
     this->push_back( a );
     return *this;
@@ -41,7 +41,7 @@ int StringHelper::vformat(std::string& str, int max_size, const char* format, va
   }
 
   const int INTERNAL_BUFFER_SIZE = 1024;
-  static char buffer[INTERNAL_BUFFER_SIZE];
+  char buffer[INTERNAL_BUFFER_SIZE];
   char* buffer_ptr = buffer;
 
   if (max_size + 1 > INTERNAL_BUFFER_SIZE)
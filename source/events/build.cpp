@@ -24,6 +24,7 @@
 #include "walker/enemysoldier.hpp"
 #include "city/statistic.hpp"
 #include "warningmessage.hpp"
+#include "core/foreach.hpp"
 
 using namespace constants;
 using namespace gfx;
@@ -83,6 +84,17 @@ void BuildEvent::_exec( Game& game, unsigned int )
     helper.updateDesirability( _overlay, city::Helper::onDesirability );
     game.city()->addOverlay( _overlay );
 
+    // plazas, gates and bridges change walkable network like roads do
+    TilesArray area = helper.getArea( _overlay );
+    foreach( it, area )
+    {
+      if( (*it)->getFlag( Tile::tlRoad ) )
+      {
+        game.city()->setOption( PlayerCity::updateRoads, 1 );
+        break;
+      }
+    }
+
     ConstructionPtr construction = ptr_cast<Construction>( _overlay );
     if( construction.isValid() )
     {
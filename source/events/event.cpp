@@ -123,14 +123,14 @@ void ClearLandEvent::_exec( Game& game, unsigned int )
     foreach( it, clearedTiles )
     {
       Tile* tile = *it;
+      deleteRoad |= tile->getFlag( Tile::tlRoad );
+
       tile->setMasterTile( NULL );
       tile->setFlag( Tile::tlTree, false);
       tile->setFlag( Tile::tlRoad, false);
       tile->setFlag( Tile::tlGarden, false);
       tile->setOverlay( NULL );
 
-      deleteRoad |= tile->getFlag( Tile::tlRoad );
-
       if( tile->getFlag( Tile::tlMeadow ) || tile->getFlag( Tile::tlWater ) )
       {
         tile->setPicture( TileHelper::convId2PicName( tile->originalImgId() ) );
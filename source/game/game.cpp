@@ -68,6 +68,10 @@
 
 using namespace gfx;
 
+namespace {
+static const unsigned int uploadTimeLimit = 4; // ms for picture uploads per frame
+}
+
 class Game::Impl
 {
 public:
@@ -153,6 +157,13 @@ void Game::Impl::initSound()
   ae.setVolume( audio::themeSound, SETTINGS_VALUE( musicVolume ) );
   ae.setVolume( audio::gameSound, SETTINGS_VALUE( soundVolume ) );
 
+  Logger::warning( "Game: preload interface sounds" );
+  ae.preload( "panel", 1 );
+  ae.preload( "panel", 2 );
+  ae.preload( "panel", 3 );
+  ae.preload( "icon", 1 );
+  ae.preload( "buildok", 1 );
+
   Logger::warning( "Game: load talks archive" );
   audio::Helper::initTalksArchive( SETTINGS_RC_PATH( talksArchive ) );
 }
@@ -176,6 +187,13 @@ void Game::Impl::mountArchives(ResourceLoader &loader)
                  "!!!.\nBe sure that you copy all .sg2, .map and .smk files placed to resource folder";
     }
 
+    //decoded sprites are cached between launches
+    vfs::Directory cacheDir( SETTINGS_VALUE( cachedir ).toString() );
+    if( cacheDir.exist() || vfs::Directory::createByPath( cacheDir ) )
+    {
+      vfs::Sg2ArchiveReader::setCacheFolder( cacheDir );
+    }
+
     loader.loadFromModel( SETTINGS_RC_PATH( sg2model ), gfxDir );
   }
   else
@@ -273,7 +291,10 @@ void Game::changeTimeMultiplier(int percent){  setTimeMultiplier( _d->timeMultip
 void Game::setTimeMultiplier(int percent){  _d->timeMultiplier = math::clamp<unsigned int>( percent, 10, 300 );}
 int Game::timeMultiplier() const{  return _d->timeMultiplier;}
 
-Game::~Game(){}
+Game::~Game()
+{
+  FontCollection::instance().clearGlyphs();
+}
 
 void Game::save(std::string filename) const
 {
@@ -428,6 +449,9 @@ void Game::initialize()
 
 bool Game::exec()
 {
+  audio::Engine::instance().update();
+  gfx::PictureBank::instance().update( uploadTimeLimit );
+
   if (_d->currentScreen && _d->currentScreen->getScreenType() == _d->nextScreen)
   {
     if (!_d->currentScreen->update(_d->engine))
@@ -84,7 +84,8 @@ bool GameLoaderMission::load( const std::string& filename, Game& game )
       int n2size = rndvm.get( "size", 5 );
       float smooth = rndvm.get( "smooth", 2.6 );
       float terrain = rndvm.get( "terrain", 4 );
-      targar.create( game, n2size, smooth, terrain );
+      int seed = rndvm.get( "seed", 0 );
+      targar.create( game, n2size, smooth, terrain, (unsigned int)seed );
     }
     else
     {
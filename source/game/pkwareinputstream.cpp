@@ -47,56 +47,228 @@ SOFTWARE.
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstring>
 
 using namespace std;
 
+namespace {
+
+/**
+* Reverse the bits in `number', essentially converting it from little
+* endian to big endian or vice versa.
+*/
+int reverse(int number, int length) {
+	int result = 0;
+	for (int i = 0; i < length; i++) {
+		if (0 != (number & (1 << i))) {
+			// Set bit in result
+			result |= (1 << (length - 1 - i));
+		}
+	}
+	return result;
+}
+
+/**
+* Gets the amount of bytes to copy from the dictionary.
+* Works on any bit source, used both to build the lookup tables
+* and to decode the long codes the tables don't cover.
+*/
+template<class Bits>
+int copyLengthTree(Bits& in) {
+	int bits;
+	
+	bits = in.readBits(2);
+	if (bits == 3) { // 11
+		return 3;
+	} else if (bits == 1) { // 10x
+		return 4 - 2 * in.readBit();
+	} else if (bits == 2) { // 01
+		if (in.readBit() == 1) { // 011
+			return 5;
+		} else { // 010x
+			return 7 - in.readBit();
+		}
+	} else { // 00
+		bits = in.readBits(2);
+		if (bits == 3) { // 0011
+			return 8;
+		} else if (bits == 1) { // 0010
+			if (in.readBit() == 1) { // 00101
+				return 9;
+			} else { // 00100x
+				return 10 + in.readBit();
+			}
+		} else if (bits == 2) { // 0001
+			if (in.readBit() == 1) { // 00011xx
+				return 12 + in.readBits(2);
+			} else { // 00010xxx
+				return 16 + in.readBits(3);
+			}
+		} else { // 0000
+			bits = in.readBits(2);
+			if (bits == 3) { // 000011xxxx
+				return 24 + in.readBits(4);
+			} else if (bits == 1) { // 000010xxxxx
+				return 40 + in.readBits(5);
+			} else if (bits == 2) { // 000001xxxxxx
+				return 72 + in.readBits(6);
+			} else { // 000000
+				if (in.readBit() == 1) { // 0000001xxxxxxx
+					return 136 + in.readBits(7);
+				} else { // 0000000xxxxxxxx
+					return 264 + in.readBits(8);
+				}
+			}
+		}
+	}
+}
+
+/**
+* Gets the "high" value of the copy offset, the lower N bits
+* are stored verbatim; N depends on the copy length and the
+* dictionary size.
+*/
+template<class Bits>
+int copyOffsetHighTree(Bits& in) {
+	int bits;
+	
+	bits = in.readBits(2);
+	if (bits == 3) { // 11
+		return 0;
+	} else if (bits == 1) { // 10
+		bits = in.readBits(2);
+		if (bits == 3) { // 1011
+			return 0x1;
+		} else if (bits == 1) { // 1010
+			return 0x2;
+		} else if (bits == 2) { // 1001x
+			return 0x4 - in.readBit();
+		} else { // 1000x
+			return 0x6 - in.readBit();
+		}
+	} else if (bits == 2) { // 01
+		bits = in.readBits(4);
+		if (bits == 0) {
+			return 0x17 - in.readBit();
+		} else {
+			bits = reverse(bits, 4);
+			return 0x16 - bits;
+		}
+	} else { // 00
+		bits = in.readBits(2);
+		if (bits == 3) {
+			bits = reverse(in.readBits(3), 3);
+			return 0x1f - bits;
+		} else if (bits == 1) {
+			bits = reverse(in.readBits(3), 3);
+			return 0x27 - bits;
+		} else if (bits == 2) {
+			bits = reverse(in.readBits(3), 3);
+			return 0x2f - bits;
+		} else {
+			bits = reverse(in.readBits(4), 4);
+			return 0x3f - bits;
+		}
+	}
+}
+
 /**
-* Dictionary for keeping track of past read bytes
+* Bit source over a fixed 8 bit pattern, used to run the code trees
+* on every possible lookahead when building the tables
 */
-class PKDictionary {
+class PKPatternBits {
 	public:
-		/**
-		* Creates a new dictionary of size `size'
-		*/
-		PKDictionary(int size) {
-			dictionary = new unsigned char[size];
-			this->size = size;
-			this->first = -1;
+		PKPatternBits(unsigned int pattern) : pattern(pattern), used(0) {}
+		
+		int readBit() { return readBits(1); }
+		
+		int readBits(int length) {
+			int result = (pattern >> used) & ((1 << length) - 1);
+			used += length;
+			return result;
 		}
 		
-		~PKDictionary() {
-			delete[] dictionary;
+		unsigned int pattern;
+		int used;
+};
+
+/**
+* Symbol tables indexed by the next 8 input bits. A zero bit count
+* means the code is longer than the lookahead and must go through
+* the tree.
+*/
+class PKTables {
+	public:
+		PKTables() {
+			for (unsigned int i = 0; i < 256; i++) {
+				PKPatternBits lengthBits(i);
+				length[i] = (unsigned short)copyLengthTree(lengthBits);
+				lengthSize[i] = (unsigned char)(lengthBits.used <= 8 ? lengthBits.used : 0);
+				
+				PKPatternBits offsetBits(i);
+				offsetHigh[i] = (unsigned char)copyOffsetHighTree(offsetBits);
+				offsetSize[i] = (unsigned char)offsetBits.used;
+			}
 		}
 		
+		unsigned short length[256];
+		unsigned char lengthSize[256];
+		unsigned char offsetHigh[256];
+		unsigned char offsetSize[256];
+};
+
+const PKTables& tables() {
+	static PKTables instance;
+	return instance;
+}
+
+/**
+* Reads bits in little endian order from the compressed chunk, whole
+* 32 bit words at a time. The data must be padded with 4 bytes.
+*/
+class PKBitReader {
+	public:
+		PKBitReader(const unsigned char *data, int length)
+			: data(data), total((unsigned int)length * 8), offset(0) {}
+		
 		/**
-		* Returns the byte at the specified position.
-		* Also does a PUT for this byte since the compression
-		* algorithm requires it
+		* Returns the next bits without consuming them, at least 24
+		* are valid
 		*/
-		unsigned char get(int position) {
-			int index = (size + first - position) % size;
-			put(dictionary[index]);
-			return dictionary[index];
+		unsigned int peek() const {
+			const unsigned char *p = data + (offset >> 3);
+			unsigned int word = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+			return word >> (offset & 7);
 		}
 		
-		/**
-		* Adds a byte to the dictionary
-		*/
-		void put(unsigned char b) {
-			first = (first + 1) % size;
-			dictionary[first] = b;
+		void consume(int length) {
+			offset += length;
+			if (offset > total) {
+				throw PKException("EOF (invalid)");
+			}
+		}
+		
+		int readBit() { return readBits(1); }
+		
+		int readBits(int length) {
+			int result = peek() & ((1 << length) - 1);
+			consume(length);
+			return result;
 		}
 	
 	private:
-		int size;
-		int first;
-		unsigned char *dictionary;
+		const unsigned char *data;
+		unsigned int total;
+		unsigned int offset;
 };
 
+}
+
 PKWareInputStream::PKWareInputStream(string filename, int file_length) {
 	ifstream *i = new ifstream();
 	i->open(filename.c_str(), ios::in|ios::binary);
 	if (!i->is_open()) {
+		delete i;
 		input = NULL;
 		throw PKException("File not readable");
 	}
@@ -114,85 +286,29 @@ PKWareInputStream::PKWareInputStream(istream *i, bool close_stream, int file_len
 }
 
 PKWareInputStream::~PKWareInputStream() {
-	delete dictionary;
-	delete buffer;
 	if (close_stream) {
 		delete input;
 	}
 }
 
 unsigned char PKWareInputStream::read() {
-	if (read_copying) {
-		//cout << "Copying bytes from offset " << read_offset << "; " << read_length << " bytes left" << endl;
-		read_length--;
-		if (read_length <= 0) {
-			read_copying = false;
-		}
-		unsigned char b = dictionary->get(read_offset);
-		return b;
-	} else {
-		if (readBit() == 0) {
-			// Copy byte verbatim
-			int result = readBits(8);
-			dictionary->put((unsigned char)result);
-			//cout << "Reading verbatim byte: " << result << endl;
-			return (unsigned char)result;
-		}
-		// Needs to copy stuff from the dictionary
-		read_length = getCopyLength();
-		if (read_length >= 519) {
-			//cout << "519 read: end of file" << endl;
-			throw PKException("EOF");
-		}
-		
-		read_offset = getCopyOffset(read_length);
-		//cout << "Copying " << read_length << " bytes from offset " << read_offset << endl;
-		unsigned char b = dictionary->get(read_offset);
-		read_length--;
-		read_copying = true;
-		return b;
-	}
+	checkEof((int)unpacked.size() - position, 1);
+	return unpacked[position++];
 }
 
 int PKWareInputStream::read(unsigned char *buf, int length) {
-	int current = 0;
-	try {
-		int max = length;
-		while (current < max) {
-			if (read_copying) {
-				while (current < max && read_copying) {
-					read_length--;
-					if (read_length <= 0) {
-						read_copying = false;
-					}
-					buf[current++] = dictionary->get(read_offset);
-				}
-			} else if (readBit() == 0) {
-				// Copy byte verbatim
-				int result = readBits(8);
-				dictionary->put((unsigned char)result);
-				buf[current++] = (unsigned char)result;
-			} else {
-				// Needs to copy stuff from the dictionary
-				read_length = getCopyLength();
-				if (read_length >= 519) {
-					return current;
-				}
-				
-				read_offset = getCopyOffset(read_length);
-				buf[current++] = dictionary->get(read_offset);
-				read_length--;
-				read_copying = true;
-			}
-		}
-		return current;
-	} catch (PKException e) {
-		if (e.msg == "EOF") {
-			//cout << "EOF thrown, current = " << current << endl;
-			return current;
+	int available = (int)unpacked.size() - position;
+	if (length > available) {
+		if (truncated) {
+			throw PKException("EOF (invalid)");
 		}
-		throw;
+		length = available;
 	}
+	if (length > 0) {
+		memcpy(buf, &unpacked[position], length);
+		position += length;
+	}
+	return length;
 }
 
 unsigned char PKWareInputStream::readByte() {
@@ -200,13 +316,13 @@ unsigned char PKWareInputStream::readByte() {
 }
 
 unsigned short PKWareInputStream::readShort() {
-	unsigned char data[2];
+	unsigned char data[2] = { 0, 0 };
 	read(data, 2);
 	return (unsigned short)(data[0] + (data[1] << 8));
 }
 
 unsigned int PKWareInputStream::readInt() {
-	unsigned char data[4];
+	unsigned char data[4] = { 0, 0, 0, 0 };
 	unsigned int number = 0;
 	
 	read(data, 4);
@@ -218,29 +334,17 @@ unsigned int PKWareInputStream::readInt() {
 
 /**
 * Skips length bytes from the input
-* @todo Make much more efficient
 */
 void PKWareInputStream::skip(int length) {
-	for (int i = 0; i < length; i++) {
-		read();
-	}
+	checkEof((int)unpacked.size() - position, length);
+	position += length;
 }
 
 void PKWareInputStream::empty() {
-	//int i = 0;
-	try {
-		bool success = true;
-		while (success) {
-			read();
-			//i++;
-		}
-	} catch (PKException e) {
-		if (e.msg == "EOF") {
-			//cout << "Emptied. " << i << " bytes discarded" << endl;
-			return;
-		}
-		throw;
+	if (truncated) {
+		throw PKException("EOF (invalid)");
 	}
+	position = (int)unpacked.size();
 }
 
 ///////////////////////////
@@ -262,18 +366,20 @@ void PKWareInputStream::init() {
 	if (file_length <= 2) {
 		throw PKException("File too small");
 	}
-	eof_reached = false;
 	readHeader();
-	fillBuffer();
-	// Init the remaining variables
-	bufBit = 0;
-	read_offset = 0;
-	read_length = 0;
-	read_copying = false;
+	
+	// Read the whole chunk at once, the padding lets the bit reader
+	// load full words at the very end of the data
+	packed.assign(file_length + 4, 0);
+	input->read((char*)&packed[0], file_length);
+	
+	position = 0;
+	truncated = false;
+	decompress();
 }
 
 /**
-* Reads the 2-byte header and initialises the dictionary
+* Reads the 2-byte header
 */
 void PKWareInputStream::readHeader() {
 	// Read the header to decide on the encoding type
@@ -285,221 +391,81 @@ void PKWareInputStream::readHeader() {
 	
 	input->read(&c, 1);
 	dictionary_bits = (int)c;
-	switch (dictionary_bits) {
-		case 4: dictSize = 1024; break;
-		case 5: dictSize = 2048; break;
-		case 6: dictSize = 4096; break;
-		default:
-			throw PKException("Unknown dictionary size");
+	if (dictionary_bits < 4 || dictionary_bits > 6) {
+		throw PKException("Unknown dictionary size");
 	}
-	dictionary = new PKDictionary(dictSize);
-	buffer = new char[BUFFER_SIZE];
-	//System.out.println("Dictionary size: "+dictSize);
 	file_length -= 2; // Subtract two header bytes from total file length
 }
 
 /**
-* Gets the amount of bytes to copy from the dictionary
+* Decompresses the whole chunk into the output buffer. Copy lengths
+* and offsets are resolved through the lookup tables, the output
+* itself serves as the dictionary.
 */
-int PKWareInputStream::getCopyLength() {
-	int bits;
+void PKWareInputStream::decompress() {
+	const PKTables& table = tables();
+	PKBitReader in(&packed[0], file_length);
 	
-	bits = readBits(2);
-	if (bits == 3) { // 11
-		return 3;
-	} else if (bits == 1) { // 10x
-		return 4 - 2 * readBit();
-	} else if (bits == 2) { // 01
-		if (readBit() == 1) { // 011
-			return 5;
-		} else { // 010x
-			return 7 - readBit();
-		}
-	} else if (bits == 0) { // 00
-		bits = readBits(2);
-		if (bits == 3) { // 0011
-			return 8;
-		} else if (bits == 1) { // 0010
-			if (readBit() == 1) { // 00101
-				return 9;
-			} else { // 00100x
-				return 10 + readBit();
+	unpacked.reserve(file_length * 4);
+	try {
+		for (;;) {
+			if (in.readBit() == 0) {
+				// Copy byte verbatim
+				unpacked.push_back((unsigned char)in.readBits(8));
+				continue;
 			}
-		} else if (bits == 2) { // 0001
-			if (readBit() == 1) { // 00011xx
-				return 12 + readBits(2);
-			} else { // 00010xxx
-				return 16 + readBits(3);
+			
+			// Needs to copy stuff from the dictionary
+			unsigned int code = in.peek() & 0xff;
+			int length;
+			if (table.lengthSize[code]) {
+				length = table.length[code];
+				in.consume(table.lengthSize[code]);
+			} else {
+				length = copyLengthTree(in);
 			}
-		} else if (bits == 0) { // 0000
-			bits = readBits(2);
-			if (bits == 3) { // 000011xxxx
-				return 24 + readBits(4);
-			} else if (bits == 1) { // 000010xxxxx
-				return 40 + readBits(5);
-			} else if (bits == 2) { // 000001xxxxxx
-				return 72 + readBits(6);
-			} else if (bits == 0) { // 000000
-				if (readBit() == 1) { // 0000001xxxxxxx
-					return 136 + readBits(7);
-				} else { // 0000000xxxxxxxx
-					return 264 + readBits(8);
+			if (length >= 519) {
+				// End of stream marker
+				break;
+			}
+			
+			code = in.peek() & 0xff;
+			int lower_bits = (length == 2) ? 2 : dictionary_bits;
+			int offset = table.offsetHigh[code] << lower_bits;
+			in.consume(table.offsetSize[code]);
+			offset |= in.readBits(lower_bits);
+			
+			size_t start = unpacked.size();
+			unpacked.resize(start + length);
+			unsigned char *dst = &unpacked[start];
+			if ((size_t)offset < start) {
+				// Byte by byte, source and destination may overlap
+				const unsigned char *src = dst - offset - 1;
+				for (int i = 0; i < length; i++) {
+					dst[i] = src[i];
+				}
+			} else {
+				// Reference before the start of the data, the old
+				// dictionary held no meaningful bytes there
+				for (int i = 0; i < length; i++) {
+					long from = (long)(start + i) - offset - 1;
+					dst[i] = from >= 0 ? unpacked[from] : 0;
 				}
 			}
 		}
+	} catch (PKException e) {
+		// Data ended without the end marker, bytes decoded so far
+		// are still readable
+		truncated = true;
 	}
-	throw PKException("Invalid copy length");
-}
-
-/**
-* Gets the offset at which to start copying bytes from the dictionary
-*/
-int PKWareInputStream::getCopyOffset(int length) {
-	int lower_bits, result;
-	if (length == 2) {
-		lower_bits = 2;
-	} else {
-		lower_bits = dictionary_bits;
-	}
-	
-	result = getCopyOffsetHigh() << lower_bits;
-	result |= readBits(lower_bits);
-	return result;
-}
-
-/**
-* Gets the "high" value of the copy offset, the lower N bits
-* are stored verbatim; N depends on the copy length and the
-* dictionary size.
-*/
-int PKWareInputStream::getCopyOffsetHigh() {
-	int bits;
-	
-	bits = readBits(2);
-	if (bits == 3) { // 11
-		return 0;
-	} else if (bits == 1) { // 10
-		bits = readBits(2);
-		if (bits == 3) { // 1011
-			return 0x1;
-		} else if (bits == 1) { // 1010
-			return 0x2;
-		} else if (bits == 2) { // 1001x
-			return 0x4 - readBit();
-		} else if (bits == 0) { // 1000x
-			return 0x6 - readBit();
-		}
-	} else if (bits == 2) { // 01
-		bits = readBits(4);
-		if (bits == 0) {
-			return 0x17 - readBit();
-		} else {
-			bits = reverse(bits, 4);
-			return 0x16 - bits;
-		}
-	} else if (bits == 0) { // 00
-		bits = readBits(2);
-		if (bits == 3) {
-			bits = reverse(readBits(3), 3);
-			return 0x1f - bits;
-		} else if (bits == 1) {
-			bits = reverse(readBits(3), 3);
-			return 0x27 - bits;
-		} else if (bits == 2) {
-			bits = reverse(readBits(3), 3);
-			return 0x2f - bits;
-		} else {
-			bits = reverse(readBits(4), 4);
-			return 0x3f - bits;
-		}
-	}
-	
-	throw PKException("Invalid copy offset");
-}
-
-/**
-* Reverse the bits in `number', essentially converting it from little
-* endian to big endian or vice versa.
-*/
-int PKWareInputStream::reverse(int number, int length) {
-	int result = 0;
-	for (int i = 0; i < length; i++) {
-		if (0 != (number & (1 << i))) {
-			// Set bit in result
-			result |= (1 << (length - 1 - i));
-		}
-	}
-	return result;
-}
-
-/**
-* Fill the internal buffer
-*/
-void PKWareInputStream::fillBuffer() {
-	bufOffset = 0;
-	if (file_length <= BUFFER_SIZE) {
-		input->read(buffer, file_length);
-		eof_reached = true;
-		eof_position = file_length;
-	} else {
-		input->read(buffer, BUFFER_SIZE);
-		file_length -= BUFFER_SIZE;
-	}
-}
-
-/**
-* Advances the data pointer one byte, filling the buffer
-* if necessary
-*/
-void PKWareInputStream::advanceByte() {
-	bufOffset++;
-	if (eof_reached && bufOffset >= eof_position) {
-		throw PKException("EOF (invalid)");
-	}
-	if (bufOffset >= BUFFER_SIZE) {
-		fillBuffer();
-	}
-	bufBit = 0;
-}
-
-/**
-* Reads one single bit
-*/
-unsigned char PKWareInputStream::readBit() {
-	if (bufBit == 8) {
-		advanceByte();
-	}
-	unsigned char b = (unsigned char)((buffer[bufOffset] & (1 << bufBit)) >> bufBit);
-	bufBit++;
-	return b;
 }
 
 /**
-* Reads bits in little endian order
-* @param length Number of bits to read. Should never be more than 8.
-* @return int Value of the bits read
+* Throws the EOF exception when fewer than `requested' bytes are left
 */
-int PKWareInputStream::readBits(int length) {
-	int result;
-	if (bufBit == 8) {
-		advanceByte();
+void PKWareInputStream::checkEof(int available, int requested) {
+	if (requested > available) {
+		position = (int)unpacked.size();
+		throw PKException(truncated ? "EOF (invalid)" : "EOF");
 	}
-	// Check to see if we span multiple bytes
-	if (bufBit + length > 8) {
-		// First take last remaining bits in this byte & put them in place
-		result = ((buffer[bufOffset] & 0xff) >> bufBit);
-		int length2 = length + bufBit - 8;
-		int length1 = length - length2;
-		advanceByte();
-		
-		// Read length2 bytes from the second byte & add them to the result
-		result |= ((buffer[bufOffset]) & ((1 << length2) - 1)) << length1;
-		bufBit = length2;
-	} else {
-		// Same byte, easy!
-		result = buffer[bufOffset] >> bufBit;
-		result &= (1 << length) - 1;
-		bufBit += length;
-	}
-	return result;
 }
@@ -20,6 +20,7 @@
 #define pkwareinputstream_h
 
 #include <string>
+#include <vector>
 //#include <istream>
 
 /**
@@ -33,14 +34,11 @@ class PKException {
 		}
 };
 
-/**
-* Internal class
-*/
-class PKDictionary;
-
 /**
 * Input class for reading files / blocks of data compressed with the
 * PKWare Compression Library.
+* The whole chunk is decompressed on construction, reads are served
+* from the output buffer.
 * All methods (including constructors) may throw a PKException
 */
 class PKWareInputStream {
@@ -108,35 +106,24 @@ class PKWareInputStream {
 	private:
 		void init();
 		void readHeader();
-		int getCopyLength();
-		int getCopyOffset(int length);
-		int getCopyOffsetHigh();
-		int reverse(int number, int length);
-		void fillBuffer();
-		void advanceByte();
-		unsigned char readBit();
-		int readBits(int length);
+		void decompress();
+		void checkEof(int available, int requested);
 		
 		// Class variables (comments is where they're initialised)
 		std::istream *input; // ctor
-		int dictSize; // readHeader
-		char *buffer; // fillBuffer
-		int bufOffset; // fillBuffer
-		int bufBit; // init
 		int dictionary_bits; // readHeader
-		PKDictionary *dictionary; // readHeader
-		
-		// For the reading of bytes:
-		int read_offset; // init
-		int read_length; // init
-		bool read_copying; // init
 		int file_length; // ctor or init
-		
-		// For detecting end of stream:
-		bool eof_reached; // init, fillBuffer
-		int eof_position; // fillBuffer
 		bool close_stream; // ctor
-		static const int BUFFER_SIZE = 4096;
+		
+		// Compressed chunk, read in one go and padded for word reads
+		std::vector<unsigned char> packed; // init
+		
+		// Whole decompressed chunk and read position in it
+		std::vector<unsigned char> unpacked; // decompress
+		int position; // init
+		
+		// Set when the data ended before the end-of-stream marker
+		bool truncated; // decompress
 };
 
 #endif /* pkwareinputstream_h */
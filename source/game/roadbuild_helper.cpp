@@ -76,49 +76,63 @@ TilesArray RoadPropagator::createPath(Tilemap& tileMap, TilePos startPos, TilePo
   }
   else
   {
-    bool yMoveFirst = stopPos.i() > startPos.i();
+    ret = straightPath( tileMap, startPos, stopPos );
+  }
 
-    //int mapSize = tileMap.getSize();;
-    TilePos midlPos;
-    midlPos = yMoveFirst
-                ? TilePos( startPos.i(), stopPos.j() )
-                : TilePos( startPos.i(), stopPos.j() );
+  if( ret.empty() )
+  {
+    ret = searchPath( tileMap, startPos, stopPos, roadAssignment );
+  }
 
-    if( yMoveFirst )
-    {
-      ret.append( tileMap.getRectangle( startPos, midlPos ) );
-      ret.append( tileMap.getRectangle( midlPos, stopPos ) );
-    }
-    else
-    {
-      ret.append( tileMap.getRectangle( stopPos, midlPos ) );
-      ret.append( tileMap.getRectangle( midlPos, startPos ) );
-    }
+  return ret;
+}
+
+TilesArray RoadPropagator::straightPath(Tilemap& tileMap, TilePos startPos, TilePos stopPos)
+{
+  TilesArray ret;
+  bool yMoveFirst = stopPos.i() > startPos.i();
+
+  //int mapSize = tileMap.getSize();;
+  TilePos midlPos;
+  midlPos = yMoveFirst
+              ? TilePos( startPos.i(), stopPos.j() )
+              : TilePos( startPos.i(), stopPos.j() );
 
-    foreach( it, ret )
+  if( yMoveFirst )
+  {
+    ret.append( tileMap.getRectangle( startPos, midlPos ) );
+    ret.append( tileMap.getRectangle( midlPos, stopPos ) );
+  }
+  else
+  {
+    ret.append( tileMap.getRectangle( stopPos, midlPos ) );
+    ret.append( tileMap.getRectangle( midlPos, startPos ) );
+  }
+
+  foreach( it, ret )
+  {
+    if( !(*it)->isWalkable( true ) )
     {
-      if( !(*it)->isWalkable( true ) )
-      {
-        ret.clear();
-        break;
-      }
+      ret.clear();
+      break;
     }
   }
 
-  if( ret.empty() )
-  {
-    Pathfinder& finder = Pathfinder::instance();
-    finder.setCondition( makeDelegate( &RoadPropagator::instance(), &RoadPropagator::canBuildRoad ) );
+  return ret;
+}
 
-    int flags = Pathfinder::fourDirection | Pathfinder::terrainOnly | Pathfinder::customCondition;
+TilesArray RoadPropagator::searchPath(Tilemap& tileMap, TilePos startPos, TilePos stopPos,
+                                      bool roadAssignment)
+{
+  Pathfinder& finder = Pathfinder::instance();
+  finder.setCondition( makeDelegate( &RoadPropagator::instance(), &RoadPropagator::canBuildRoad ) );
 
-    flags |= (roadAssignment ? 0 : Pathfinder::ignoreRoad );
-    const Tile& stile = tileMap.at( startPos );
-    const Tile& ftile = tileMap.at( stopPos );
-    Pathway way = finder.getPath( stile.pos(), ftile.pos(), flags );
+  int flags = Pathfinder::fourDirection | Pathfinder::terrainOnly | Pathfinder::customCondition;
 
-    ret = way.allTiles();
-  }
+  flags |= (roadAssignment ? 0 : Pathfinder::ignoreRoad );
+  const Tile& stile = tileMap.at( startPos );
+  const Tile& ftile = tileMap.at( stopPos );
+  Pathway way = finder.getPath( stile.pos(), ftile.pos(), flags );
 
-  return ret;
+  return way.allTiles();
 }
@@ -33,6 +33,15 @@ public:
                                 TilePos startTile, TilePos destination,
                                 bool roadAssignment=false, bool returnRect=false);
 
+  /** returns two-segment path without obstacles or empty array */
+  static gfx::TilesArray straightPath(gfx::Tilemap& tileMap,
+                                      TilePos startPos, TilePos stopPos);
+
+  /** runs pathfinder, tiles are ordered from start to stop */
+  static gfx::TilesArray searchPath(gfx::Tilemap& tileMap,
+                                    TilePos startPos, TilePos stopPos,
+                                    bool roadAssignment);
+
   void canBuildRoad(const gfx::Tile* tile, bool& ret);
 
 private:
@@ -68,9 +68,11 @@ __REG_PROPERTY(opengl_opts)
 __REG_PROPERTY(font)
 __REG_PROPERTY(walkerRelations)
 __REG_PROPERTY(freeplay_opts)
+__REG_PROPERTY(cachedir)
 #undef __REG_PROPERTY
 
 const vfs::Path defaultSaveDir = "saves";
+const vfs::Path defaultCacheDir = "cache";
 const vfs::Path defaultResDir = "resources";
 const vfs::Path defaultLocaleDir = "resources/locale";
 
@@ -157,14 +159,17 @@ void GameSettings::setwdir( const std::string& wdirstr )
   _d->options[ localePath ] = Variant( (wdir/defaultLocaleDir).toString() );
   _d->options[ savedir ] = Variant( (wdir/defaultSaveDir).toString() );
 
-  vfs::Directory saveDir;
+  vfs::Directory saveDir, cacheDir;
 #ifdef CAESARIA_PLATFORM_LINUX
   vfs::Path dirName = vfs::Path( ".caesaria/" ) + defaultSaveDir;
   saveDir = vfs::Directory::getUserDir()/dirName;
+  cacheDir = vfs::Directory::getUserDir()/(vfs::Path( ".caesaria/" ) + defaultCacheDir);
 #elif defined(CAESARIA_PLATFORM_WIN) || defined(CAESARIA_PLATFORM_HAIKU) || defined(CAESARIA_PLATFORM_MACOSX) || defined(CAESARIA_PLATFORM_ANDROID)
   saveDir = wdir/defaultSaveDir;
+  cacheDir = wdir/defaultCacheDir;
 #endif
   _d->options[ savedir ] = Variant( saveDir.toString() );
+  _d->options[ cachedir ] = Variant( cacheDir.toString() );
 }
 
 static vfs::Path __concatPath( vfs::Directory dir, vfs::Path fpath )
@@ -72,6 +72,7 @@ public:
   __GS_PROPERTY(font)
   __GS_PROPERTY(walkerRelations)
   __GS_PROPERTY(freeplay_opts)
+  __GS_PROPERTY(cachedir)
 #undef __GS_PROPERTY
 
   static GameSettings& instance();
@@ -20,10 +20,24 @@
 #include "core/foreach.hpp"
 #include "core/stringhelper.hpp"
 #include "core/logger.hpp"
+#include "core/referencecounted.hpp"
+#include "core/smartptr.hpp"
 
 namespace gfx
 {
 
+namespace {
+static const Pictures emptyFrames;
+}
+
+// frames are shared between copies of animation and are
+// duplicated only when one of the copies is going to change them
+class AnimationFrames : public ReferenceCounted
+{
+public:
+  Pictures pictures;
+};
+
 class Animation::Impl
 {
 public:
@@ -32,8 +46,27 @@ public:
   unsigned int lastTimeUpdate;
   Point offset;
   int index;  // index of the current frame
+  SmartPtr<AnimationFrames> frames;
+
+  const Pictures& pictures() const { return frames.isValid() ? frames->pictures : emptyFrames; }
+  Pictures& detach();
 };
 
+Pictures& Animation::Impl::detach()
+{
+  if( frames.isNull() || frames->rcount() > 1 )
+  {
+    AnimationFrames* copy = new AnimationFrames();
+    if( frames.isValid() )
+      copy->pictures = frames->pictures;
+
+    frames = copy;
+    copy->drop();
+  }
+
+  return frames->pictures;
+}
+
 void Animation::start(bool loop)
 {
   __D_IMPL(d, Animation)
@@ -42,28 +75,30 @@ void Animation::start(bool loop)
   d->loop = loop;
 }
 
-Pictures& Animation::frames() {  return _pictures;}
-const Pictures& Animation::frames() const{  return _pictures;}
-unsigned int Animation::frameCount() const{  return _pictures.size();}
+Pictures& Animation::frames() {  return _dfunc()->detach();}
+const Pictures& Animation::frames() const{  return _dfunc()->pictures();}
+unsigned int Animation::frameCount() const{  return frames().size();}
 
 void Animation::setOffset( const Point& offset )
 {
-  foreach( pic, _pictures ) { pic->setOffset( offset ); }
+  Pictures& pictures = frames();
+  foreach( pic, pictures ) { pic->setOffset( offset ); }
 }
 
 Point Animation::offset() const
 {
-  if( _pictures.empty() )
+  const Pictures& pictures = frames();
+  if( pictures.empty() )
   {
     return Point();
   }
 
-  return _pictures.front().offset();
+  return pictures.front().offset();
 }
 
 bool Animation::atEnd() const
 {
-  return _dfunc()->index == (int)( _pictures.size()-1 );
+  return _dfunc()->index == (int)( frames().size()-1 );
 }
 
 void Animation::update( unsigned int time )
@@ -82,7 +117,7 @@ void Animation::update( unsigned int time )
   _d->index += 1;
   _d->lastTimeUpdate = time;
 
-  if( _d->index >= (int)_pictures.size() )
+  if( _d->index >= (int)_d->pictures().size() )
   {
     _d->index = isLoop() ? 0 : -1;
   }
@@ -91,13 +126,14 @@ void Animation::update( unsigned int time )
 const Picture& Animation::currentFrame() const
 {
   __D_IMPL_CONST(d,Animation)
-  return ( d->index >= 0 && d->index < (int)_pictures.size())
-                  ? _pictures[d->index]
+  const Pictures& pictures = d->pictures();
+  return ( d->index >= 0 && d->index < (int)pictures.size())
+                  ? pictures[d->index]
                   : Picture::getInvalid();
 }
 
 int Animation::index() const { return _dfunc()->index;}
-void Animation::setIndex(int index){  _dfunc()->index = math::clamp<int>( index, -1, _pictures.size()-1 );}
+void Animation::setIndex(int index){  _dfunc()->index = math::clamp<int>( index, -1, _dfunc()->pictures().size()-1 );}
 
 Animation::Animation() : __INIT_IMPL(Animation)
 {
@@ -117,10 +153,11 @@ void Animation::load( const std::string &prefix, const int start, const int numb
                       bool reverse /*= false*/, const int step /*= 1*/ )
 {
   int revMul = reverse ? -1 : 1;
+  Pictures& pictures = frames();
   for( int i = 0; i < number; ++i)
   {
     const Picture& pic = Picture::load(prefix, start + revMul*i*step);
-    _pictures.push_back( pic );
+    pictures.push_back( pic );
   }
 }
 
@@ -133,7 +170,7 @@ VariantMap Animation::save() const
   VARIANT_SAVE_ANY_D( ret, d, loop )
 
   VariantList pics;
-  foreach( i, _pictures)
+  foreach( i, d->pictures() )
     pics << Variant( (*i).name() );
 
   ret[ "pictures" ] = pics;
@@ -155,15 +192,15 @@ void Animation::load(const VariantMap &stream)
     int start = range.get( "start" );
     int number = range.get( "number" );
     for( int k=0; k < number; k++ )
-      _pictures.push_back( Picture::load( rc, start + k ) );
+      frames().push_back( Picture::load( rc, start + k ) );
   }
 
   VariantList vl_pics = stream.get( "pictures" ).toList();
   foreach( i, vl_pics )
-    _pictures.push_back( Picture::load( (*i).toString() ) );
+    frames().push_back( Picture::load( (*i).toString() ) );
 }
 
-void Animation::clear() { _pictures.clear();}
+void Animation::clear() { _dfunc()->frames = SmartPtr<AnimationFrames>();}
 bool Animation::isRunning() const{  return _dfunc()->index >= 0;}
 bool Animation::isStopped() const{  return _dfunc()->index == -1;}
 void Animation::stop(){ _dfunc()->index = -1; }
@@ -171,7 +208,7 @@ void Animation::stop(){ _dfunc()->index = -1; }
 Animation& Animation::operator=( const Animation& other )
 {
   __D_IMPL(_d,Animation)
-  _pictures = other._pictures;
+  _d->frames = other._dfunc()->frames;
   _dfunc()->index = other._dfunc()->index;  // index of the current frame
   _d->delay = other.delay();
   _d->lastTimeUpdate = other._dfunc()->lastTimeUpdate;
@@ -180,24 +217,25 @@ Animation& Animation::operator=( const Animation& other )
   return *this;
 }
 
-int Animation::size() const {  return _pictures.size();}
-bool Animation::isValid() const{  return _pictures.size() > 0;}
+int Animation::size() const {  return frames().size();}
+bool Animation::isValid() const{  return frames().size() > 0;}
 
 void Animation::addFrame(const std::string& resource, int index)
 {
-  _pictures.push_back( Picture::load( resource, index ) );
+  frames().push_back( Picture::load( resource, index ) );
 }
 
 const Picture& Animation::getFrame(int index) const
 {
-  return ( index >= 0 && index < (int)_pictures.size() )
-           ? _pictures[ index ]
+  const Pictures& pictures = frames();
+  return ( index >= 0 && index < (int)pictures.size() )
+           ? pictures[ index ]
            : Picture::getInvalid();
 }
 
 void Animation::addFrame(const Picture& pic)
 {
-  _pictures.push_back( pic );
+  frames().push_back( pic );
 }
 
 }//end namespace gfx
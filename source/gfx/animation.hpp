@@ -80,8 +80,6 @@ public:
   void addFrame(const std::string& resource, int index);
   const Picture& getFrame( int index ) const;
 private:
-  Pictures _pictures;
-
   __DECLARE_IMPL(Animation)
 };
 
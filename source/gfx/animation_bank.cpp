@@ -25,7 +25,11 @@
 #include "core/saveadapter.hpp"
 #include "walker/helper.hpp"
 #include "picture_info_bank.hpp"
+#include "picture_bank.hpp"
+#include "core/stringhelper.hpp"
+#include "core/foreach.hpp"
 #include <map>
+#include <set>
 
 using namespace constants;
 
@@ -67,12 +71,16 @@ public:
   typedef std::map< int, ActionAnimation > Animations;
   typedef std::map< int, Pictures > CartPictures;
   typedef std::map< int, VariantMap > AnimationConfigs;
+  // animations indexed by action * countDirection + direction
+  typedef std::vector< const Animation* > ActionTable;
+  typedef std::vector< ActionTable > ActionTables;
 
   CartPictures carts;
   AnimationConfigs animConfigs;
   
   Animations animations;
-
+  ActionTables tables;
+  std::set<int> prefetched;
 
   // fills the cart pictures
   // prefix: image prefix
@@ -84,6 +92,7 @@ public:
                      const int step = defaultStepInFrame, int delay=0);
   void loadAnimation(int who, const VariantMap& desc );
   const AnimationBank::MovementAnimation& tryLoadAnimations(int wtype );
+  const ActionTable& actionTable( int wtype );
 
   void loadCarts();
 };
@@ -261,6 +270,83 @@ const AnimationBank::MovementAnimation& AnimationBank::find( int type )
   return it->second.actions;
 }
 
+const AnimationBank::Impl::ActionTable& AnimationBank::Impl::actionTable( int wtype )
+{
+  if( wtype >= (int)tables.size() )
+    tables.resize( wtype + 1 );
+
+  ActionTable& table = tables[ wtype ];
+  if( !table.empty() )
+    return table;
+
+  const MovementAnimation& actions = AnimationBank::find( wtype );
+  int maxAction = 0;
+  foreach( it, actions ) { maxAction = std::max( maxAction, it->first.action ); }
+
+  table.resize( (maxAction + 1) * countDirection, 0 );
+  foreach( it, actions )
+  {
+    table[ it->first.action * countDirection + it->first.direction ] = &it->second;
+  }
+
+  // walker without direction uses north animation
+  for( int action=0; action <= maxAction; action++ )
+  {
+    const Animation*& none = table[ action * countDirection + noneDirection ];
+    if( !none )
+      none = table[ action * countDirection + north ];
+  }
+
+  return table;
+}
+
+const Animation& AnimationBank::find( int type, const DirectedAction& action )
+{
+  static const Animation invalidAnimation;
+  if( type < 0 )
+    return invalidAnimation;
+
+  AnimationBank& inst = instance();
+  const Impl::ActionTable& table = inst._d->actionTable( type );
+
+  unsigned int index = action.action * countDirection + action.direction;
+  if( index < table.size() && table[ index ] )
+    return *table[ index ];
+
+  const MovementAnimation& actions = find( type );
+  CAESARIA_LOG_DEBUG( "AnimationBank: wrong direction detected" );
+  return actions.empty() ? invalidAnimation : actions.begin()->second;
+}
+
+void AnimationBank::prefetch( int type )
+{
+  AnimationBank& inst = instance();
+  if( !inst._d->prefetched.insert( type ).second )
+    return;
+
+  Impl::AnimationConfigs::iterator configIt = inst._d->animConfigs.find( type );
+
+  //animations already loaded or unknown
+  if( configIt == inst._d->animConfigs.end() )
+    return;
+
+  PictureBank& pb = PictureBank::instance();
+  foreach( ac, configIt->second )
+  {
+    VariantMap actionInfo = ac->second.toMap();
+    VARIANT_INIT_STR( rc, actionInfo )
+    VARIANT_INIT_ANY( int, start, actionInfo )
+    VARIANT_INIT_ANY( int, frames, actionInfo )
+    VARIANT_INIT_ANY( int, step, actionInfo )
+
+    int count = frames * ( step == 0 ? 1 : step );
+    for( int index=start; index < start + count; index++ )
+    {
+      pb.prefetch( StringHelper::format( 0xff, "%s_%05d", rc.c_str(), index ) );
+    }
+  }
+}
+
 void AnimationBank::loadAnimation(vfs::Path model)
 {
   Logger::warning( "AnimationBank: start loading animations from " + model.toString() );
@@ -53,6 +53,12 @@ public:
   static const Picture& getCart(int good, int capacity, constants::Direction direction );
 
   static const MovementAnimation& find( int type );
+
+  //! direct lookup of walker animation, frames are shared with the bank
+  static const Animation& find( int type, const DirectedAction& action );
+
+  //! start background loading of pictures for walker type, only first call for type does work
+  static void prefetch( int type );
 private:
   AnimationBank();
 
@@ -56,6 +56,8 @@
 #include "layerindigene.hpp"
 #include "core/timer.hpp"
 #include "pathway/pathway.hpp"
+#include "animation_bank.hpp"
+#include "picture_bank.hpp"
 
 using namespace constants;
 
@@ -77,6 +79,8 @@ public:
   int zoom;
   bool zoomChanged;
   int sumClockwiseTurns=0;
+  TilePos lastCenter;
+  unsigned int tilesRevision;  // camera draw list points to overlays of this revision
 
   Renderer::ModePtr changeCommand;
 
@@ -84,6 +88,7 @@ public:
   LayerPtr currentLayer;
   void setLayer( int type );
   void resetWalkersAfterTurn();
+  void prefetchAhead();
   int clockwiseRotationsToUndo = 0;
 
 public signals:
@@ -105,6 +110,7 @@ void CityRenderer::initialize(PlayerCityPtr city, Engine* engine, gui::Ui* guien
   _d->engine = engine;
   _d->zoom = 100;
   _d->zoomChanged = false;
+  _d->tilesRevision = city->tilesRevision();
 
   _d->engine->initViewport( 0, _d->engine->screenSize() );
 
@@ -151,6 +157,45 @@ void CityRenderer::Impl::resetWalkersAfterTurn()
   }
 }
 
+void CityRenderer::Impl::prefetchAhead()
+{
+  static const int prefetchDistance = 20;
+  static const int prefetchRadius = 6;
+
+  TilePos center = camera.center();
+  TilePos delta = center - lastCenter;
+  lastCenter = center;
+
+  // area is checked only when camera moves to other tile
+  if( delta == TilePos( 0, 0 ) )
+    return;
+
+  //start loading pictures which will be visible soon, bank skips loaded ones
+  TilePos direction( math::signnum( delta.i() ), math::signnum( delta.j() ) );
+  TilePos ahead = center + direction * prefetchDistance;
+  TilePos offset( prefetchRadius, prefetchRadius );
+  TilesArray area = tilemap->getArea( ahead - offset, ahead + offset );
+
+  PictureBank& bank = PictureBank::instance();
+  foreach( it, area )
+  {
+    Tile* tile = *it;
+    bank.prefetch( tile->picture().name() );
+
+    TileOverlayPtr overlay = tile->overlay();
+    if( overlay.isValid() && tile->isMasterTile() )
+    {
+      bank.prefetch( overlay->picture().name() );
+
+      const Pictures& animation = overlay->pictures( Renderer::overlayAnimation );
+      foreach( pic, animation ) { bank.prefetch( pic->name() ); }
+    }
+
+    const WalkerList& walkers = city->walkers( tile->pos() );
+    foreach( w, walkers ) { AnimationBank::prefetch( (*w)->type() ); }
+  }
+}
+
 void CityRenderer::Impl::setLayer(int type)
 {
   currentLayer = 0;
@@ -188,6 +233,14 @@ void CityRenderer::render()
     _d->city->setOption( PlayerCity::updateTiles, 0 );
   }
 
+  if( _d->tilesRevision != _d->city->tilesRevision() )
+  {
+    _d->tilesRevision = _d->city->tilesRevision();
+    _d->camera.refresh();
+  }
+
+  _d->prefetchAhead();
+
   LayerPtr layer = _d->currentLayer;
   Engine& engine = *_d->engine;
 
@@ -0,0 +1,103 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "drawlist.hpp"
+#include "picture.hpp"
+#include "core/foreach.hpp"
+
+namespace gfx
+{
+
+DrawList::DrawList() : _flatCount( 0 ), _mapSize( 0 ) {}
+
+void DrawList::clear( int mapSize )
+{
+  if( _mapSize != mapSize )
+  {
+    _mapSize = mapSize;
+    _slotIndex.assign( mapSize * mapSize, -1 );
+  }
+  else
+  {
+    foreach( it, _usedTiles ) { _slotIndex[ *it ] = -1; }
+  }
+
+  _usedTiles.clear();
+  _items.clear();
+  _slots.clear();
+  _flatCount = 0;
+}
+
+DrawList::Item& DrawList::_append( const Point& pos )
+{
+  _items.push_back( Item() );
+
+  Item& item = _items.back();
+  item.picture = 0;
+  item.pictures = 0;
+  item.animation = 0;
+  item.pos = pos;
+
+  return item;
+}
+
+void DrawList::addPicture( const Picture& pic, const Point& pos ) { _append( pos ).picture = &pic; }
+void DrawList::addPictures( const Pictures& pics, const Point& pos ) { _append( pos ).pictures = &pics; }
+void DrawList::addAnimation( const Animation& animation, const Point& pos ) { _append( pos ).animation = &animation; }
+
+void DrawList::addSlot( const TilePos& pos, const Slot& slot )
+{
+  int index = pos.i() * _mapSize + pos.j();
+  if( index < 0 || index >= (int)_slotIndex.size() )
+    return;
+
+  _slotIndex[ index ] = _slots.size();
+  _usedTiles.push_back( index );
+  _slots.push_back( slot );
+}
+
+const DrawList::Items& DrawList::items() const { return _items; }
+const DrawList::Slots& DrawList::tileSlots() const { return _slots; }
+unsigned int DrawList::flatCount() const { return _flatCount; }
+void DrawList::setFlatCount( unsigned int count ) { _flatCount = count; }
+RenderBuffer& DrawList::commands() { return _commands; }
+
+int DrawList::slot( const TilePos& pos ) const
+{
+  if( pos.i() < 0 || pos.j() < 0 || pos.i() >= _mapSize || pos.j() >= _mapSize )
+    return -1;
+
+  return _slotIndex[ pos.i() * _mapSize + pos.j() ];
+}
+
+void DrawList::draw( RenderBuffer& buffer, unsigned int begin, unsigned int end, const Point& offset ) const
+{
+  for( unsigned int k=begin; k < end; k++ )
+  {
+    const Item& item = _items[ k ];
+    Point screenPos = item.pos + offset;
+
+    if( item.picture ) { buffer.draw( *item.picture, screenPos ); }
+    else if( item.pictures ) { buffer.draw( *item.pictures, screenPos ); }
+    else if( item.animation && item.animation->isValid() )
+    {
+      buffer.draw( item.animation->currentFrame(), screenPos );
+    }
+  }
+}
+
+}//end namespace gfx
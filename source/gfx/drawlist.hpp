@@ -0,0 +1,94 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#ifndef __CAESARIA_DRAWLIST_H_INCLUDED__
+#define __CAESARIA_DRAWLIST_H_INCLUDED__
+
+#include "renderbuffer.hpp"
+#include "animation.hpp"
+#include "core/position.hpp"
+#include <vector>
+
+namespace gfx
+{
+
+//! depth ordered pictures of visible tiles and overlays. Items point to pictures
+//! owned by tiles and overlays, so animations and changed pictures are read
+//! every frame, and list is rebuilt only when visible tiles change
+class DrawList
+{
+public:
+  struct Item
+  {
+    const Picture* picture;
+    const Pictures* pictures;
+    const Animation* animation;
+    Point pos;  // position on map, camera offset is added when commands are emitted
+  };
+
+  //! items of one visible tile, walkers of tile are drawn between
+  //! [begin, walkers) and [walkers, end)
+  struct Slot
+  {
+    unsigned int begin;
+    unsigned int walkers;
+    unsigned int end;
+  };
+
+  typedef std::vector<Item> Items;
+  typedef std::vector<Slot> Slots;
+
+  DrawList();
+
+  void clear( int mapSize );
+
+  void addPicture( const Picture& pic, const Point& pos );
+  void addPictures( const Pictures& pics, const Point& pos );
+  void addAnimation( const Animation& animation, const Point& pos );
+  void addSlot( const TilePos& pos, const Slot& slot );
+
+  const Items& items() const;
+  const Slots& tileSlots() const;
+
+  //! first items are flat tiles, they are drawn before all slots
+  unsigned int flatCount() const;
+  void setFlatCount( unsigned int count );
+
+  //! slot of visible tile or -1
+  int slot( const TilePos& pos ) const;
+
+  //! appends commands of items [begin, end) to buffer
+  void draw( RenderBuffer& buffer, unsigned int begin, unsigned int end, const Point& offset ) const;
+
+  //! commands of last frame, kept to reuse memory
+  RenderBuffer& commands();
+
+private:
+  Item& _append( const Point& pos );
+
+  Items _items;
+  Slots _slots;
+  unsigned int _flatCount;
+  int _mapSize;
+  std::vector<int> _slotIndex;       // slot index for every tile of map
+  std::vector<int> _usedTiles;       // tiles which have slot now
+  RenderBuffer _commands;
+};
+
+}//end namespace gfx
+
+#endif //__CAESARIA_DRAWLIST_H_INCLUDED__
@@ -39,6 +39,8 @@ Engine& Engine::instance()
 Engine::Engine()
 {
   _srcSize = Size( 0 );
+  _commandsCount = _stateChanges = 0;
+  _lastCommandsCount = _lastStateChanges = 0;
   _instance = this;
 }
 
@@ -49,6 +51,42 @@ bool Engine::isFullscreen() const{  return getFlag( fullscreen ) > 0; }
 void Engine::setFullscreen(bool enabled){  setFlag( fullscreen, enabled ? 1 : 0 );}
 Size Engine::screenSize() const{  return _srcSize;}
 void Engine::setFlag( int flag, int value ){  _flags[ flag ] = value;}
+Picture* Engine::createTarget( const Size& size ) { return 0; }
+void Engine::setTarget( Picture* target, const Point& offset ) {}
+
+void Engine::draw(const Picture& pic, const int dx, const int dy, Rect* clipRect) { _commands.draw( pic, dx, dy, clipRect ); }
+void Engine::draw(const Picture& pic, const Point& pos, Rect* clipRect) { _commands.draw( pic, pos, clipRect ); }
+void Engine::draw(const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect) { _commands.draw( pic, srcRect, dstRect, clipRect ); }
+void Engine::draw(const Pictures& pic, const Point& pos, Rect* clipRect) { _commands.draw( pic, pos, clipRect ); }
+void Engine::drawLine(const NColor& color, const Point& p1, const Point& p2) { _commands.drawLine( color, p1, p2 ); }
+void Engine::setColorMask(int rmask, int gmask, int bmask, int amask) { _commands.setColorMask( rmask, gmask, bmask, amask ); }
+void Engine::resetColorMask() { _commands.resetColorMask(); }
+void Engine::setViewport(int index, bool render) { _commands.setViewport( index, render ); }
+void Engine::drawViewport(int index, Rect r) { _commands.drawViewport( index, r ); }
+unsigned int Engine::commandsCount() const { return _lastCommandsCount; }
+unsigned int Engine::stateChanges() const { return _lastStateChanges; }
+
+void Engine::flush()
+{
+  if( _commands.empty() )
+    return;
+
+  _execute( _commands );
+  _commands.clear();
+}
+
+void Engine::submit(const RenderBuffer& buffer)
+{
+  flush();
+  _execute( buffer );
+}
+
+void Engine::_finishFrameStats()
+{
+  _lastCommandsCount = _commandsCount;
+  _lastStateChanges = _stateChanges;
+  _commandsCount = _stateChanges = 0;
+}
 
 int Engine::getFlag(int flag) const
 {
@@ -20,6 +20,7 @@
 #define __CAESARIA_GFX_ENGINE_H_INCLUDE__
 
 #include "picturesarray.hpp"
+#include "renderbuffer.hpp"
 #include "core/size.hpp"
 #include <map>
 
@@ -57,21 +58,38 @@ public:
   virtual void unloadPicture( Picture& ioPicture) = 0;
 
   virtual void initViewport( int, Size s) = 0;
-  virtual void setViewport( int, bool render) = 0;
-  virtual void drawViewport( int, Rect r) = 0;
+  void setViewport( int index, bool render );
+  void drawViewport( int index, Rect r );
+
+  //! picture which can be used as target for drawing, 0 if engine can't do it
+  virtual Picture* createTarget( const Size& size );
+
+  //! redirect drawing into target, screen positions are shifted by -offset. 0 returns drawing to screen
+  virtual void setTarget( Picture* target, const Point& offset=Point() );
 
   virtual void startRenderFrame() = 0;  // start a new frame
   virtual void endRenderFrame() = 0;  // display the frame
 
-  virtual void draw(const Picture& pic, const int dx, const int dy, Rect* clipRect=0 ) = 0;
-  virtual void draw(const Picture& pic, const Point& pos, Rect* clipRect=0 ) = 0;
-  virtual void draw(const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect=0 ) = 0;
-  virtual void draw(const Pictures& pic, const Point& pos, Rect* clipRect=0 ) = 0;
+  // draw calls only record commands, they are executed on flush or at the end of frame
+  void draw(const Picture& pic, const int dx, const int dy, Rect* clipRect=0 );
+  void draw(const Picture& pic, const Point& pos, Rect* clipRect=0 );
+  void draw(const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect=0 );
+  void draw(const Pictures& pic, const Point& pos, Rect* clipRect=0 );
+
+  void drawLine( const NColor& color, const Point& p1, const Point& p2 );
+
+  void setColorMask( int rmask, int gmask, int bmask, int amask );
+  void resetColorMask();
 
-  virtual void drawLine( const NColor& color, const Point& p1, const Point& p2 ) = 0;
+  //! execute commands recorded since last flush
+  void flush();
 
-  virtual void setColorMask( int rmask, int gmask, int bmask, int amask ) = 0;
-  virtual void resetColorMask() = 0;
+  //! execute prepared buffer after recorded commands, buffer may be submitted again
+  void submit( const RenderBuffer& buffer );
+
+  //! commands executed and render state changes made during last frame
+  unsigned int commandsCount() const;
+  unsigned int stateChanges() const;
   
   virtual void deletePicture( Picture* pic ) = 0;
 
@@ -82,10 +100,17 @@ public:
   virtual Picture& screen() = 0;
 
 protected:
+  virtual void _execute( const RenderBuffer& buffer ) = 0;
+  void _finishFrameStats();
+
   static Engine* _instance;
 
   Size _srcSize;
   std::map< int, int > _flags;
+
+  RenderBuffer _commands;
+  unsigned int _commandsCount, _stateChanges;
+  unsigned int _lastCommandsCount, _lastStateChanges;
 };
 
 }//end namespace gfx
@@ -693,6 +693,8 @@ Point GlEngine::cursorPos() const
 
 void GlEngine::unloadPicture(Picture& ioPicture)
 {
+  flush();  // recorded commands may still use this texture
+
   GLuint& texture( ioPicture.textureID() );
   glDeleteTextures(1, &texture );
   SDL_FreeSurface(ioPicture.surface());
@@ -797,14 +799,19 @@ void GlEngine::startRenderFrame()
 
 void GlEngine::endRenderFrame()
 {
+  flush();
+
   if( getFlag( Engine::debugInfo ) )
   {
-    std::string debugText = StringHelper::format( 0xff, "fps:%d call:%d", _lastFps, _drawCall );
+    std::string debugText = StringHelper::format( 0xff, "fps:%d call:%d cmd:%d state:%d", _lastFps, _drawCall,
+                                                  commandsCount(), stateChanges() );
     _d->fpsText->fill( 0, Rect() );
     _d->debugFont.draw( *_d->fpsText, debugText, Point( 0, 0 ) );
     draw( *_d->fpsText, Point( _srcSize.width() / 2, 2 ) );
   }
 
+  flush();
+
 #ifdef CAESARIA_USE_FRAMEBUFFER
   if( getFlag( Engine::effects ) > 0 )
   {
@@ -824,98 +831,98 @@ void GlEngine::endRenderFrame()
   }
 
   _drawCall = 0;
+  _finishFrameStats();
 }
 
-void GlEngine::draw(const Picture &picture, const int dx, const int dy, Rect* clipRect)
+void GlEngine::_execute( const RenderBuffer& buffer )
 {
-  const GLuint& aTextureID( picture.textureID() );
-  if( aTextureID == 0 )
-    return;
-
-  _drawCall++;
-  float x0 = (float)( dx+picture.offset().x());
-  float x1 = x0+picture.width();
-  float y0 = (float)(dy-picture.offset().y());
-  float y1 = y0+picture.height();
+  GLuint bound = 0;
 
-  glBindTexture( GL_TEXTURE_2D, aTextureID);
-#ifdef USE_GLES
-  GLfloat vtx1[] = {
-    x0, y0,
-    x1, y0,
-    x1, y1,
-    x0, y1
-  };
-
-  GLfloat tex1[] = {
-    0, 0,
-    1, 0,
-    1, 1,
-    0, 1
-  };
-
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-  glVertexPointer(3, GL_FLOAT, 0, vtx1 );
-  glTexCoordPointer(2, GL_FLOAT, 0, tex1 );
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 4 );
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-#else
-  // Bind the texture to which subsequent calls refer to
-
-  glBegin( GL_QUADS );
+  foreach( it, buffer.commands() )
+  {
+    const RenderCommand& cmd = *it;
+    _commandsCount++;
 
-  //Bottom-left vertex (corner)
-  glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 0, 0 ); glVertex2f( x0, y0 );
-  glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 1, 0 ); glVertex2f( x1, y0 );
-  glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 1, 1 ); glVertex2f( x1, y1 );
-  glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 0, 1 ); glVertex2f( x0, y1 );
+    switch( cmd.type )
+    {
+    case RenderCommand::picture:
+    {
+      if( cmd.textureID == 0 )
+        break;
 
-  glEnd();
-#endif
-}
+      _drawCall++;
+      float x0 = (float)cmd.dst.left();
+      float x1 = (float)cmd.dst.right();
+      float y0 = (float)cmd.dst.top();
+      float y1 = (float)cmd.dst.bottom();
 
-void GlEngine::draw(const Pictures& pictures, const Point& pos, Rect* clipRect)
-{
-  foreach( it, pictures )
-  {
-    draw( *it, pos, clipRect );
-  }
-}
+      // Bind the texture to which subsequent calls refer to
+      if( bound != cmd.textureID )
+      {
+        glBindTexture( GL_TEXTURE_2D, cmd.textureID );
+        bound = cmd.textureID;
+        _stateChanges++;
+      }
+#ifdef USE_GLES
+      GLfloat vtx1[] = {
+        x0, y0,
+        x1, y0,
+        x1, y1,
+        x0, y1
+      };
+
+      GLfloat tex1[] = {
+        0, 0,
+        1, 0,
+        1, 1,
+        0, 1
+      };
 
-void GlEngine::drawLine(const NColor& color, const Point& p1, const Point& p2)
-{
-  int i=0;
-}
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 
-void GlEngine::draw( const Picture &picture, const Point& pos, Rect* clipRect )
-{
-  draw( picture, pos.x(), pos.y() );
-}
+      glVertexPointer(3, GL_FLOAT, 0, vtx1 );
+      glTexCoordPointer(2, GL_FLOAT, 0, tex1 );
+      glDrawArrays(GL_TRIANGLE_FAN, 0, 4 );
 
-void GlEngine::draw(const Picture& picture, const Rect& src, const Rect& dst, Rect* clipRect)
-{
-  int i=0;
-}
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+#else
+      glBegin( GL_QUADS );
 
-void GlEngine::setColorMask( int rmask, int gmask, int bmask, int amask )
-{
-  _rmask = (rmask ? 1.f : 0.f);
-  _gmask = (gmask ? 1.f : 0.f);
-  _bmask = (bmask ? 1.f : 0.f);
-  _amask = (amask ? 1.f : 0.f);
-}
+      //Bottom-left vertex (corner)
+      glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 0, 0 ); glVertex2f( x0, y0 );
+      glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 1, 0 ); glVertex2f( x1, y0 );
+      glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 1, 1 ); glVertex2f( x1, y1 );
+      glColor4f( _rmask, _gmask, _bmask, _amask ); glTexCoord2i( 0, 1 ); glVertex2f( x0, y1 );
 
-void GlEngine::resetColorMask()
-{
-  _rmask = _gmask = _bmask = _amask = 1.f;
+      glEnd();
+#endif
+    }
+    break;
+
+    case RenderCommand::colorMask:
+      _rmask = (cmd.values[ 0 ] ? 1.f : 0.f);
+      _gmask = (cmd.values[ 1 ] ? 1.f : 0.f);
+      _bmask = (cmd.values[ 2 ] ? 1.f : 0.f);
+      _amask = (cmd.values[ 3 ] ? 1.f : 0.f);
+    break;
+
+    case RenderCommand::resetMask:
+      _rmask = _gmask = _bmask = _amask = 1.f;
+    break;
+
+    default:
+      // partial pictures, lines and viewports are not supported by this engine yet
+    break;
+    }
+  }
 }
 
 void GlEngine::createScreenshot( const std::string& filename )
 {
+  flush();
+
   Picture* screen = createPicture( screenSize() );
 #ifdef USE_GLES
   glReadPixels( 0, 0, screenSize().width(), screenSize().height(), GL_RGBA, GL_UNSIGNED_BYTE, screen->surface()->pixels);
@@ -53,17 +53,6 @@ public:
   virtual void endRenderFrame();
 
   virtual void initViewport( int, Size s) {}
-  virtual void setViewport( int, bool render) {}
-  virtual void drawViewport( int, Rect r) {}
-
-  void draw(const Picture &picture, const int dx, const int dy, Rect* clipRect=0);
-  void draw(const Picture &picture, const Point& pos, Rect* clipRect=0 );
-  void draw(const Picture &picture, const Rect& src, const Rect& dst, Rect* clipRect=0 );
-  void draw(const Pictures& pictures, const Point& pos, Rect* clipRect);
-  void drawLine(const NColor &color, const Point &p1, const Point &p2);
-
-  void setColorMask( int rmask, int gmask, int bmask, int amask );
-  void resetColorMask();
 
   void createScreenshot( const std::string& filename );
   unsigned int fps() const;
@@ -75,6 +64,9 @@ public:
   Picture& screen();
   virtual void setFlag(int flag, int value);
 
+protected:
+  virtual void _execute( const RenderBuffer& buffer );
+
 private:
   void _createFramebuffer( unsigned int& id );
   void _initShaderProgramm(const char* vertSrc, const char* fragSrc,
@@ -34,6 +34,9 @@
 #include "walker_debuginfo.hpp"
 #include "core/timer.hpp"
 #include "core/logger.hpp"
+#include "drawlist.hpp"
+
+#include <algorithm>
 
 using namespace constants;
 
@@ -62,10 +65,70 @@ public:
   Font debugFont;
 
   int posMode;
+  bool drawListEnabled;
+
+  typedef std::pair< int, Walker* > SlotWalker;
+  std::vector< SlotWalker > frameWalkers;  // visible walkers sorted by slot of their tile
+
 public:
   void updateOutlineTexture( Tile* tile );
+  void renderDrawList( Engine& engine, const Layer::WalkerTypes& vWalkers );
 };
 
+namespace {
+bool __bySlot( const std::pair< int, Walker* >& a, const std::pair< int, Walker* >& b ) { return a.first < b.first; }
+}
+
+void Layer::Impl::renderDrawList( Engine& engine, const Layer::WalkerTypes& vWalkers )
+{
+  DrawList& list = camera->drawList();
+  Point camOffset = camera->offset();
+
+  // walkers outside visible tiles are skipped
+  frameWalkers.clear();
+  bool viewAll = vWalkers.count( walker::all ) > 0;
+  const WalkerList& walkers = city->walkers();
+  foreach( it, walkers )
+  {
+    Walker* w = it->object();
+    int slot = list.slot( w->pos() );
+    if( slot >= 0 && ( viewAll || vWalkers.count( w->type() ) > 0 ) )
+      frameWalkers.push_back( SlotWalker( slot, w ) );
+  }
+
+  std::stable_sort( frameWalkers.begin(), frameWalkers.end(), __bySlot );
+
+  RenderBuffer& buffer = list.commands();
+  buffer.clear();
+  list.draw( buffer, 0, list.flatCount(), camOffset );
+
+  if( LayerDrawOptions::instance().isFlag( LayerDrawOptions::shadowOverlay ) )
+  {
+    buffer.setColorMask( 0x00ff0000, 0x0000ff00, 0x000000ff, 0xc0000000 );
+  }
+
+  Pictures pics;
+  std::vector< SlotWalker >::iterator wIt = frameWalkers.begin();
+  const DrawList::Slots& tileSlots = list.tileSlots();
+  for( unsigned int k=0; k < tileSlots.size(); k++ )
+  {
+    const DrawList::Slot& slot = tileSlots[ k ];
+    list.draw( buffer, slot.begin, slot.walkers, camOffset );
+
+    for( ; wIt != frameWalkers.end() && wIt->first == (int)k; ++wIt )
+    {
+      pics.clear();
+      wIt->second->getPictures( pics );
+      buffer.draw( pics, wIt->second->mappos() + camOffset );
+    }
+
+    list.draw( buffer, slot.walkers, slot.end, camOffset );
+  }
+
+  buffer.resetColorMask();
+  engine.submit( buffer );
+}
+
 void Layer::registerTileForRendering(Tile& tile)
 {
   /*__D_IMPL(_d,Layer)
@@ -297,43 +360,50 @@ void Layer::_setTooltipText(const std::string& text)
 void Layer::render( Engine& engine)
 {
   __D_IMPL(_d,Layer)
-  const TilesArray& visibleTiles = _d->camera->tiles();
-  const TilesArray& flatTiles = _d->camera->flatTiles();
-  Point camOffset = _d->camera->offset();
-
-  _camera()->startFrame();
-
-  // FIRST PART: draw all flat land (walkable/boatable)
-  Tile* tile;
-  foreach( it, flatTiles )
-  {
-    drawTile( engine, **it, camOffset );
-  }
-
   LayerDrawOptions& opts = LayerDrawOptions::instance();
-  if( opts.isFlag( LayerDrawOptions::shadowOverlay ) )
+
+  if( _d->drawListEnabled )
   {
-    engine.setColorMask( 0x00ff0000, 0x0000ff00, 0x000000ff, 0xc0000000 );
+    _d->renderDrawList( engine, visibleTypes() );
   }
-  // SECOND PART: draw all sprites, impassable land and buildings
-  //int r0=0, r1=0, r2=0;
-  foreach( it, visibleTiles )
+  else
   {
-    tile = *it;
-    int z = tile->epos().z();
+    const TilesArray& visibleTiles = _d->camera->tiles();
+    const TilesArray& flatTiles = _d->camera->flatTiles();
+    Point camOffset = _d->camera->offset();
 
-    drawProminentTile( engine, *tile, camOffset, z, false );
-    drawWalkers( engine, *tile, camOffset );
-    drawWalkerOverlap( engine, *tile, camOffset, z );
-  }
+    _camera()->startFrame();
 
-  engine.resetColorMask();
+    // FIRST PART: draw all flat land (walkable/boatable)
+    Tile* tile;
+    foreach( it, flatTiles )
+    {
+      drawTile( engine, **it, camOffset );
+    }
+
+    if( opts.isFlag( LayerDrawOptions::shadowOverlay ) )
+    {
+      engine.setColorMask( 0x00ff0000, 0x0000ff00, 0x000000ff, 0xc0000000 );
+    }
+    // SECOND PART: draw all sprites, impassable land and buildings
+    foreach( it, visibleTiles )
+    {
+      tile = *it;
+      int z = tile->epos().z();
+
+      drawProminentTile( engine, *tile, camOffset, z, false );
+      drawWalkers( engine, *tile, camOffset );
+      drawWalkerOverlap( engine, *tile, camOffset, z );
+    }
+
+    engine.resetColorMask();
+  }
 
   if( opts.isFlag( LayerDrawOptions::showPath ) )
   {
     WalkerList overDrawWalkers;
 
-    const WalkerList& walkers = _city()->walkers( walker::all );
+    const WalkerList& walkers = _city()->walkers();
     foreach( it, walkers )
     {
       if( (*it)->getFlag( Walker::showPath ) )
@@ -588,6 +658,7 @@ Layer::Layer( Camera* camera, PlayerCityPtr city )
   _d->currentTile = 0;
 
   _d->posMode = 0;
+  _d->drawListEnabled = false;
   _d->tilePosText.init( Size( 240, 80 ) );
 }
 
@@ -600,6 +671,7 @@ int Layer::nextLayer() const{ return _dfunc()->nextLayer; }
 Camera* Layer::_camera(){ return _dfunc()->camera;}
 PlayerCityPtr Layer::_city(){ return _dfunc()->city;}
 void Layer::_setNextLayer(int layer) { _dfunc()->nextLayer = layer;}
+void Layer::_setDrawListEnabled( bool enabled ) { _dfunc()->drawListEnabled = enabled; }
 Layer::~Layer(){}
 void Layer::_setLastCursorPos(Point pos){ _dfunc()->lastCursorPos = pos; }
 void Layer::_setStartCursorPos(Point pos){ _dfunc()->startCursorPos = pos; }
@@ -94,6 +94,9 @@ protected:
   PlayerCityPtr _city();
   void _setNextLayer(int layer);
 
+  //! layer draws tiles with default passes only, so camera draw list can be used
+  void _setDrawListEnabled( bool enabled );
+
   __DECLARE_IMPL(Layer)
 };
 
@@ -37,6 +37,9 @@
 #include "walker/walker.hpp"
 #include "city_renderer.hpp"
 
+#include <map>
+#include <cstdlib>
+
 using namespace constants;
 using namespace gui;
 
@@ -66,22 +69,146 @@ public:
   Font textFont;
   PictureRef textPic;
   TilesArray buildTiles;  // these tiles have draw over "normal" tilemap tiles!
+
+  struct PreviewCell
+  {
+    TilesArray tiles;
+    int cost;
+    bool walkers;   // walkers stood on cell when it was checked
+  };
+
+  typedef std::map<TilePos, PreviewCell> PreviewCells;
+
+  struct PathCache
+  {
+    TilePos start;
+    TilePos stop;
+    bool roadAssignment;
+    bool kbShift;
+    bool searched;        // way was found by pathfinder
+    unsigned int revision;
+    TilesArray way;       // tiles from start to stop
+    TilesArray tiles;     // tiles in drawing order
+  };
+
+  PreviewCells cells;           // preview of rectangle area, reused between mouse moves
+  TileOverlayPtr cellsOverlay;  // construction which was used for cells
+  unsigned int cellsRevision;   // city tiles revision which was used for cells
+  PathCache lastPath;           // last path for border building
+  std::vector<Tile*> tilesPool; // free tiles for preview
+  Picture grnPicture;
+  Picture redPicture;
+
+public:
+  Tile* allocTile( const Tile& basicTile );
+  void releaseTile( Tile* tile );
+  void releaseCells( PreviewCells& cells );
+  bool haveWalkers( PlayerCityPtr city, const TilePos& pos, const Size& size );
+  TilesArray continuePath( Tilemap& tmap, const TilePos& stop );
+  ~Impl();
 };
 
-void LayerBuild::_discardPreview()
+Tile* LayerBuild::Impl::allocTile( const Tile& basicTile )
 {
-  __D_IMPL(d,LayerBuild)
-  foreach( tile, d->buildTiles )
+  Tile* tile = 0;
+  if( tilesPool.empty() )
+  {
+    tile = new Tile( basicTile.pos() );
+  }
+  else
   {
-    if( (*tile)->overlay().isValid() )
+    tile = tilesPool.back();
+    tilesPool.pop_back();
+    *tile = Tile( basicTile.pos() );
+  }
+
+  tile->setEPos( basicTile.epos() );
+  return tile;
+}
+
+void LayerBuild::Impl::releaseTile( Tile* tile )
+{
+  if( tile->overlay().isValid() )
+  {
+    tile->overlay()->deleteLater();
+  }
+
+  tile->setOverlay( 0 );
+  tile->setMasterTile( 0 );
+  tilesPool.push_back( tile );
+}
+
+void LayerBuild::Impl::releaseCells( PreviewCells& cells )
+{
+  foreach( it, cells )
+  {
+    foreach( tile, it->second.tiles ) { releaseTile( *tile ); }
+  }
+
+  cells.clear();
+}
+
+bool LayerBuild::Impl::haveWalkers( PlayerCityPtr city, const TilePos& pos, const Size& size )
+{
+  TilesArray tiles = city->tilemap().getArea( pos, pos + TilePos( size.width()-1, size.height()-1 ) );
+  foreach( t, tiles )
+  {
+    if( !city->walkers( (*t)->pos() ).empty() )
+      return true;
+  }
+
+  return false;
+}
+
+TilesArray LayerBuild::Impl::continuePath( Tilemap& tmap, const TilePos& stop )
+{
+  TilesArray ret;
+  if( lastPath.way.empty() || lastPath.way.front()->epos() != lastPath.start
+      || lastPath.way.back()->epos() != lastPath.stop )
+    return ret;
+
+  // cursor moved back along the path, part of path is still shortest
+  foreach( it, lastPath.way )
+  {
+    ret.push_back( *it );
+    if( (*it)->epos() == stop )
+      return ret;
+  }
+
+  // cursor moved to neighbour tile of path end
+  TilePos offset = stop - lastPath.stop;
+  if( std::abs( offset.i() ) + std::abs( offset.j() ) == 1 && tmap.isInside( stop ) )
+  {
+    bool mayBuild = false;
+    RoadPropagator::instance().canBuildRoad( &tmap.at( stop ), mayBuild );
+    if( mayBuild )
     {
-      (*tile)->overlay()->deleteLater();
+      ret.push_back( &tmap.at( stop ) );
+      return ret;
     }
+  }
+
+  ret.clear();
+  return ret;
+}
+
+LayerBuild::Impl::~Impl()
+{
+  foreach( tile, buildTiles ) { delete *tile; }
+  foreach( tile, tilesPool ) { delete *tile; }
+}
 
-    delete *tile;
+void LayerBuild::_discardPreview()
+{
+  __D_IMPL(d,LayerBuild)
+  foreach( tile, d->buildTiles )
+  {
+    d->releaseTile( *tile );
   }
 
   d->buildTiles.clear();
+  d->cells.clear();
+  d->cellsOverlay = TileOverlayPtr();
 }
 
 void LayerBuild::_checkPreviewBuild(TilePos pos)
@@ -103,21 +230,9 @@ void LayerBuild::_checkPreviewBuild(TilePos pos)
   Size size = overlay->size();
   int cost = MetaDataHolder::getData( overlay->type() ).getOption( MetaDataOptions::cost );
 
-  bool walkersOnTile = false;
-  if( bldCommand->isCheckWalkers() )
-  {
-    TilesArray tiles = _city()->tilemap().getArea( pos, pos + TilePos( size.width()-1, size.height()-1 )  );
-    foreach( t, tiles )
-    {
-      const WalkerList& walkers = _city()->walkers( (*t)->pos() );
-
-      if( !walkers.empty() )
-      {
-        walkersOnTile = true;
-        break;
-      }
-    }
-  }
+  bool walkersOnTile = bldCommand->isCheckWalkers()
+                        ? d->haveWalkers( _city(), pos, size )
+                        : false;
 
   if( !walkersOnTile && overlay->canBuild( _city(), pos, d->buildTiles ) )
   {
@@ -130,8 +245,7 @@ void LayerBuild::_checkPreviewBuild(TilePos pos)
       for (int di = 0; di < size.width(); ++di)
       {
         Tile& basicTile =  tmap.at( pos + TilePos( di, dj ) );
-        Tile* tile = new Tile( basicTile.pos() );  // make a copy of tile
-        tile->setEPos( basicTile.epos() );
+        Tile* tile = d->allocTile( basicTile );  // make a copy of tile
 
         if (di==0 && dj==0)
         {
@@ -150,9 +264,6 @@ void LayerBuild::_checkPreviewBuild(TilePos pos)
   {
     //bldCommand->setCanBuild(false);
 
-    const Picture& grnPicture = Picture::load(lc_oc3_land, 1);
-    const Picture& redPicture = Picture::load(lc_oc3_land, 2);
-
     //TilemapArea area = til
     Tilemap& tmap = _city()->tilemap();
     for (int dj = 0; dj < size.height(); ++dj)
@@ -165,8 +276,7 @@ void LayerBuild::_checkPreviewBuild(TilePos pos)
 
         const Tile& basicTile = tmap.at( rPos );
         const bool isConstructible = basicTile.getFlag( Tile::isConstructible );
-        Tile* tile = new Tile( basicTile.pos() );  // make a copy of tile
-        tile->setEPos( basicTile.epos() );
+        Tile* tile = d->allocTile( basicTile );  // make a copy of tile
 
         walkersOnTile = false;
         if( bldCommand->isCheckWalkers() )
@@ -174,7 +284,7 @@ void LayerBuild::_checkPreviewBuild(TilePos pos)
           walkersOnTile = !_city()->walkers( rPos ).empty();
         }
 
-        tile->setPicture( (!walkersOnTile && isConstructible) ? grnPicture : redPicture );
+        tile->setPicture( (!walkersOnTile && isConstructible) ? d->grnPicture : d->redPicture );
         tile->setMasterTile( 0 );
         tile->setFlag( Tile::clearAll, true );
         tile->setOverlay( 0 );
@@ -202,48 +312,72 @@ void LayerBuild::_updatePreviewTiles( bool force )
   }
 
   d->lastTilePos = curTile->epos();
-
-  _discardPreview();
   d->money4Construction = 0;
 
+  BuildModePtr bldCommand = ptr_cast<BuildMode>( d->renderer->mode() );
+  TileOverlayPtr overlay = bldCommand.isValid()
+                            ? ptr_cast<TileOverlay>( bldCommand->getContruction() )
+                            : TileOverlayPtr();
+
+  // border buildings check neighbours from preview, so they can't reuse cells,
+  // other cells are valid until city tiles changed
+  unsigned int revision = _city()->tilesRevision();
+  if( d->borderBuilding || overlay != d->cellsOverlay || revision != d->cellsRevision )
+  {
+    _discardPreview();
+  }
+  else
+  {
+    d->buildTiles.clear(); // tiles are owned by cells now
+  }
+
   if( d->borderBuilding )
   {
     Tile* startTile = _camera()->at( d->startTilePos );  // tile under the cursor (or NULL)
     Tile* stopTile  = _camera()->at( _lastCursorPos(),  true );
 
-    TilesArray pathWay = RoadPropagator::createPath( _city()->tilemap(),
-                                                     startTile->epos(), stopTile->epos(),
-                                                     d->roadAssignment, d->kbShift );
-    Tilemap& tmap = _city()->tilemap();
-    TilePos leftUpCorner = pathWay.leftUpCorner();
-    TilePos rigthDownCorner = pathWay.rightDownCorner();
-    TilePos leftDownCorner( leftUpCorner.i(), rigthDownCorner.j() );
-    TilesArray ret;
-
-    int mmapSize = std::max<int>( leftUpCorner.j() - rigthDownCorner.j() + 1,
-                                  rigthDownCorner.i() - leftUpCorner.i() + 1 );
-    for( int y=0; y < mmapSize; y++ )
+    Impl::PathCache& path = d->lastPath;
+    TilePos start = startTile->epos();
+    TilePos stop = stopTile->epos();
+    bool sameStart = ( path.start == start && path.roadAssignment == d->roadAssignment
+                       && path.kbShift == d->kbShift && path.revision == revision );
+
+    if( !sameStart || path.stop != stop )
     {
-      for( int t=0; t <= y; t++ )
+      Tilemap& tmap = _city()->tilemap();
+      TilesArray way;
+      bool searched = false;
+      if( d->kbShift || start == stop )
       {
-        TilePos tpos = leftDownCorner + TilePos( t, mmapSize - 1 - ( y - t ) );
-        if( pathWay.contain( tpos ) )
-          ret.push_back( &tmap.at( tpos ) );
+        way = RoadPropagator::createPath( tmap, start, stop, d->roadAssignment, d->kbShift );
       }
-    }
-
-    for( int x=1; x < mmapSize; x++ )
-    {
-      for( int t=0; t < mmapSize-x; t++ )
+      else
       {
-        TilePos tpos = leftDownCorner + TilePos( x + t, t );
-        if( pathWay.contain( tpos ) )
-          ret.push_back( &tmap.at( tpos ) );
+        way = RoadPropagator::straightPath( tmap, start, stop );
+        if( way.empty() )
+        {
+          // pathfinder is expensive, try to continue previous way first
+          if( sameStart && path.searched )
+            way = d->continuePath( tmap, stop );
+
+          if( way.empty() )
+            way = RoadPropagator::searchPath( tmap, start, stop, d->roadAssignment );
+
+          searched = true;
+        }
       }
+
+      path.start = start;
+      path.stop = stop;
+      path.roadAssignment = d->roadAssignment;
+      path.kbShift = d->kbShift;
+      path.revision = revision;
+      path.searched = searched;
+      path.way = way;
+      path.tiles = _sortPathTiles( way );
     }
 
-    pathWay = ret;
-    foreach( it, pathWay )
+    foreach( it, path.tiles )
     {
       _checkPreviewBuild( (*it)->epos() );
     }
@@ -252,7 +386,51 @@ void LayerBuild::_updatePreviewTiles( bool force )
   {
     TilesArray tiles = _getSelectedArea( d->startTilePos );
 
-    foreach( it, tiles ) { _checkPreviewBuild( (*it)->epos() ); }
+    // only cells which entered in selected area need check
+    Impl::PreviewCells lastCells;
+    lastCells.swap( d->cells );
+    d->cellsOverlay = overlay;
+    d->cellsRevision = revision;
+
+    bool checkWalkers = bldCommand.isValid() && overlay.isValid() && bldCommand->isCheckWalkers();
+    Size cellSize = overlay.isValid() ? overlay->size() : Size( 1 );
+    foreach( it, tiles )
+    {
+      TilePos cellPos = (*it)->epos();
+      Impl::PreviewCells::iterator cellIt = lastCells.find( cellPos );
+
+      // walkers move every tick, so cell which had or has walkers must be checked again
+      if( cellIt != lastCells.end() && checkWalkers
+          && ( cellIt->second.walkers || d->haveWalkers( _city(), cellPos, cellSize ) ) )
+      {
+        foreach( tile, cellIt->second.tiles ) { d->releaseTile( *tile ); }
+        lastCells.erase( cellIt );
+        cellIt = lastCells.end();
+      }
+
+      if( cellIt != lastCells.end() )
+      {
+        d->buildTiles.append( cellIt->second.tiles );
+        d->money4Construction += cellIt->second.cost;
+        d->cells[ cellPos ] = cellIt->second;
+        lastCells.erase( cellIt );
+      }
+      else
+      {
+        unsigned int firstTile = d->buildTiles.size();
+        int lastMoney = d->money4Construction;
+
+        _checkPreviewBuild( cellPos );
+
+        Impl::PreviewCell& cell = d->cells[ cellPos ];
+        cell.tiles.assign( d->buildTiles.begin() + firstTile, d->buildTiles.end() );
+        cell.cost = d->money4Construction - lastMoney;
+        cell.walkers = checkWalkers && d->haveWalkers( _city(), cellPos, cellSize );
+      }
+    }
+
+    // cells which left selected area
+    d->releaseCells( lastCells );
   }  
 
   d->textPic->fill( 0x0, Rect() );
@@ -260,6 +438,39 @@ void LayerBuild::_updatePreviewTiles( bool force )
   d->textFont.draw( *d->textPic, StringHelper::i2str( d->money4Construction ) + " Dn", Point() );
 }
 
+TilesArray LayerBuild::_sortPathTiles( const TilesArray& pathWay )
+{
+  Tilemap& tmap = _city()->tilemap();
+  TilePos leftUpCorner = pathWay.leftUpCorner();
+  TilePos rigthDownCorner = pathWay.rightDownCorner();
+  TilePos leftDownCorner( leftUpCorner.i(), rigthDownCorner.j() );
+  TilesArray ret;
+
+  int mmapSize = std::max<int>( leftUpCorner.j() - rigthDownCorner.j() + 1,
+                                rigthDownCorner.i() - leftUpCorner.i() + 1 );
+  for( int y=0; y < mmapSize; y++ )
+  {
+    for( int t=0; t <= y; t++ )
+    {
+      TilePos tpos = leftDownCorner + TilePos( t, mmapSize - 1 - ( y - t ) );
+      if( pathWay.contain( tpos ) )
+        ret.push_back( &tmap.at( tpos ) );
+    }
+  }
+
+  for( int x=1; x < mmapSize; x++ )
+  {
+    for( int t=0; t < mmapSize-x; t++ )
+    {
+      TilePos tpos = leftDownCorner + TilePos( x + t, t );
+      if( pathWay.contain( tpos ) )
+        ret.push_back( &tmap.at( tpos ) );
+    }
+  }
+
+  return ret;
+}
+
 void LayerBuild::_buildAll()
 {
   __D_IMPL(d,LayerBuild);
@@ -515,6 +726,10 @@ void LayerBuild::init(Point cursor)
 
   _d->lastTilePos = TilePos(-1, -1);
   _d->startTilePos = TilePos(-1, -1);
+  _d->lastPath.start = TilePos(-1, -1);
+  _d->lastPath.searched = false;
+  _d->lastPath.way.clear();
+  _d->lastPath.tiles.clear();
 
   BuildModePtr command = ptr_cast<BuildMode>( _d->renderer->mode() );
   _d->multiBuilding = command.isValid() ? command->isMultiBuilding() : false;
@@ -567,8 +782,17 @@ LayerBuild::LayerBuild(Renderer* renderer, PlayerCityPtr city)
   d->renderer = renderer;
   d->frameCount = 0;
   d->startTilePos = TilePos( -1, -1 );
+  d->lastPath.start = TilePos( -1, -1 );
+  d->lastPath.stop = TilePos( -1, -1 );
+  d->lastPath.roadAssignment = false;
+  d->lastPath.kbShift = false;
+  d->lastPath.searched = false;
+  d->lastPath.revision = 0;
+  d->cellsRevision = 0;
   d->textFont = Font::create( FONT_5 );
   d->textPic.init( Size( 100, 30 ) );
+  d->grnPicture = Picture::load( lc_oc3_land, 1 );
+  d->redPicture = Picture::load( lc_oc3_land, 2 );
   _addWalkerType( walker::all );
 
   CityRenderer* cRenderer = safety_cast<CityRenderer*>( d->renderer );
@@ -43,6 +43,7 @@ public:
 private:
   void _updatePreviewTiles(bool force);
   void _checkPreviewBuild(TilePos pos);
+  TilesArray _sortPathTiles( const TilesArray& pathWay );
   void _discardPreview();
   void _buildAll();
   void _finishBuild();
@@ -22,6 +22,7 @@
 #include "objects/house_level.hpp"
 #include "game/resourcegroup.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "layerconstants.hpp"
 #include "core/gettext.hpp"
 #include "core/event.hpp"
@@ -90,9 +91,9 @@ void LayerCrime::drawTile( Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
     {
-      HousePtr house = ptr_cast<House>( overlay );
-      crime = (int)house->getServiceValue( Service::crime );
-      needDrawAnimations = (house->spec().level() == 1) && house->habitants().empty(); // In case of vacant terrain
+      city::MetricsGrid& metrics = _city()->metrics();
+      crime = metrics.value( overlay.object(), city::MetricsGrid::crime );
+      needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0; // In case of vacant terrain
 
       city::Helper helper( _city() );
       drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase  );
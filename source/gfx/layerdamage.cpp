@@ -22,6 +22,7 @@
 #include "game/resourcegroup.hpp"
 #include "layerconstants.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "core/event.hpp"
 #include "tilemap_camera.hpp"
 
@@ -77,9 +78,9 @@ void LayerDamage::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-        damageLevel = (int)house->state( Construction::damage );
-        needDrawAnimations = (house->spec().level() == 1) && house->habitants().empty();
+        city::MetricsGrid& metrics = _city()->metrics();
+        damageLevel = metrics.value( overlay.object(), city::MetricsGrid::damage );
+        needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         if( !needDrawAnimations )
         {
@@ -92,11 +93,7 @@ void LayerDamage::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //other buildings
     default:
       {
-        BuildingPtr building = ptr_cast<Building>( overlay );
-        if( building.isValid() )
-        {
-          damageLevel = (int)building->state( Construction::damage );
-        }
+        damageLevel = _city()->metrics().value( overlay.object(), city::MetricsGrid::damage );
 
         city::Helper helper( _city() );
         drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
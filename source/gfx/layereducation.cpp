@@ -23,6 +23,7 @@
 #include "layerconstants.hpp"
 #include "tilemap_camera.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "core/event.hpp"
 #include "core/gettext.hpp"
 
@@ -33,27 +34,15 @@ namespace gfx
 
 int LayerEducation::type() const {  return _type; }
 
-int LayerEducation::_getLevelValue( HousePtr house ) const
+int LayerEducation::_getLevelValue( TileOverlay* overlay )
 {
+  city::MetricsGrid& metrics = _city()->metrics();
   switch(_type)
   {
-  case citylayer::education:
-  {
-    float acc = 0;
-    int level = house->spec().minEducationLevel();
-    switch(level)
-    {
-    case 3: acc += house->getServiceValue( Service::academy );
-    case 2: acc += house->getServiceValue( Service::library );
-    case 1: acc += house->getServiceValue( Service::school );
-      return static_cast<int>(acc / level);
-    default: return 0;
-    }
-  }
-
-  case citylayer::school: return (int) house->getServiceValue( Service::school );
-  case citylayer::library: return (int) house->getServiceValue( Service::library );
-  case citylayer::academy: return (int) house->getServiceValue( Service::academy );
+  case citylayer::education: return metrics.value( overlay, city::MetricsGrid::education );
+  case citylayer::school: return metrics.value( overlay, city::MetricsGrid::school );
+  case citylayer::library: return metrics.value( overlay, city::MetricsGrid::library );
+  case citylayer::academy: return metrics.value( overlay, city::MetricsGrid::academy );
   }
 
   return 0;
@@ -106,11 +95,8 @@ void LayerEducation::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-
-        educationLevel = _getLevelValue( house );
-
-        needDrawAnimations = (house->spec().level() == 1) && (house->habitants().empty());
+        educationLevel = _getLevelValue( overlay.object() );
+        needDrawAnimations = _city()->metrics().value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         city::Helper helper( _city() );
         drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
@@ -175,7 +161,7 @@ void LayerEducation::handleEvent(NEvent& event)
         if( house != 0 )
         {
           std::string typeName;
-          int lvlValue = _getLevelValue( house );
+          int lvlValue = _getLevelValue( house.object() );
           switch( _type )
           {
           case citylayer::education:
@@ -34,7 +34,7 @@ public:
 
 private:
   LayerEducation( Camera& camera, PlayerCityPtr city, int type );
-  int _getLevelValue(HousePtr house ) const;
+  int _getLevelValue( TileOverlay* overlay );
   std::string _getAccessLevel( int lvl ) const;
 
   std::set<int> _flags;
@@ -24,6 +24,7 @@
 #include "core/event.hpp"
 #include "tilemap_camera.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "core/gettext.hpp"
 #include "core/stringhelper.hpp"
 
@@ -34,20 +35,16 @@ namespace gfx
 
 int LayerEntertainment::type() const {  return _type; }
 
-int LayerEntertainment::_getLevelValue( HousePtr house )
+int LayerEntertainment::_getLevelValue( TileOverlay* overlay )
 {
+  city::MetricsGrid& metrics = _city()->metrics();
   switch( _type )
   {
-  case citylayer::entertainment:
-  {
-    int entLevel = house->spec().computeEntertainmentLevel( house );
-    int minLevel = house->spec().minEntertainmentLevel();
-    return math::percentage( entLevel, minLevel );
-  }
-  case citylayer::theater: return (int) house->getServiceValue( Service::theater );
-  case citylayer::amphitheater: return (int) house->getServiceValue( Service::amphitheater );
-  case citylayer::colloseum: return (int) house->getServiceValue( Service::colloseum );
-  case citylayer::hippodrome: return (int) house->getServiceValue( Service::hippodrome );
+  case citylayer::entertainment: return metrics.value( overlay, city::MetricsGrid::entertainment );
+  case citylayer::theater: return metrics.value( overlay, city::MetricsGrid::theater );
+  case citylayer::amphitheater: return metrics.value( overlay, city::MetricsGrid::amphitheater );
+  case citylayer::colloseum: return metrics.value( overlay, city::MetricsGrid::colloseum );
+  case citylayer::hippodrome: return metrics.value( overlay, city::MetricsGrid::hippodrome );
   }
 
   return 0;
@@ -104,10 +101,9 @@ void LayerEntertainment::drawTile(Engine& engine, Tile& tile, const Point& offse
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-        entertainmentLevel = _getLevelValue( house );
+        entertainmentLevel = _getLevelValue( overlay.object() );
+        needDrawAnimations = _city()->metrics().value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
-        needDrawAnimations = (house->spec().level() == 1) && (house->habitants().empty());
         city::Helper helper( _city() );
         drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
       }
@@ -169,7 +165,7 @@ void LayerEntertainment::handleEvent(NEvent& event)
           case citylayer::hippodrome: typeName = "hippodrome"; break;
           }
 
-          int lvlValue = _getLevelValue( house );
+          int lvlValue = _getLevelValue( house.object() );
           if( _type == citylayer::entertainment )
           {
             text = StringHelper::format( 0xff, "##%d_entertainment_access##", lvlValue / 10 );
@@ -33,7 +33,7 @@ public:
   virtual void handleEvent(NEvent& event);
 private:
   LayerEntertainment( Camera& camera, PlayerCityPtr city, int type );
-  int _getLevelValue(HousePtr house);
+  int _getLevelValue( TileOverlay* overlay );
 
   std::set<int> _flags;
   WalkerTypes _visibleWalkers;
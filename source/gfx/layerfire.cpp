@@ -20,6 +20,7 @@
 #include "objects/house_level.hpp"
 #include "game/resourcegroup.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "layerconstants.hpp"
 #include "tilemap_camera.hpp"
 #include "core/event.hpp"
@@ -79,9 +80,9 @@ void LayerFire::drawTile(Engine& engine, Tile& tile, const Point& offset)
 
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-        fireLevel = (int)house->state( Construction::fire );
-        needDrawAnimations = (house->spec().level() == 1) && house->habitants().empty();
+        city::MetricsGrid& metrics = _city()->metrics();
+        fireLevel = metrics.value( overlay.object(), city::MetricsGrid::fire );
+        needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         city::Helper helper( _city() );
         drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase  );
@@ -91,11 +92,7 @@ void LayerFire::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //other buildings
     default:
       {
-        ConstructionPtr constr = ptr_cast<Construction>( overlay );
-        if( constr != 0 )
-        {
-          fireLevel = (int)constr->state( Construction::fire );
-        }
+        fireLevel = _city()->metrics().value( overlay.object(), city::MetricsGrid::fire );
 
         city::Helper helper( _city() );
         drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base  );
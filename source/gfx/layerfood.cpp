@@ -20,6 +20,7 @@
 #include "objects/house_level.hpp"
 #include "game/resourcegroup.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "layerconstants.hpp"
 #include "core/event.hpp"
 #include "gfx/tilemap_camera.hpp"
@@ -73,10 +74,10 @@ void LayerFood::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        city::Helper helper( _city() );        
-        HousePtr house = ptr_cast<House>( overlay );
-        foodLevel = (int) house->state( (Construction::Param)House::food );
-        needDrawAnimations = (house->spec().level() == 1) && (house->habitants().empty());
+        city::Helper helper( _city() );
+        city::MetricsGrid& metrics = _city()->metrics();
+        foodLevel = metrics.value( overlay.object(), city::MetricsGrid::food );
+        needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0;
         if( !needDrawAnimations )
         {
           drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
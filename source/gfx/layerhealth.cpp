@@ -21,6 +21,7 @@
 #include "layerconstants.hpp"
 #include "tilemap_camera.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "core/gettext.hpp"
 #include "core/event.hpp"
 
@@ -31,14 +32,15 @@ namespace gfx
 
 int LayerHealth::type() const {  return _type; }
 
-int LayerHealth::_getLevelValue( HousePtr house )
+int LayerHealth::_getLevelValue( TileOverlay* overlay )
 {
+  city::MetricsGrid& metrics = _city()->metrics();
   switch(_type)
   {
-  case citylayer::health: return (int) house->state( House::health );
-  case citylayer::hospital: return (int) house->getServiceValue( Service::hospital );
-  case citylayer::barber: return (int) house->getServiceValue( Service::barber );
-  case citylayer::baths: return (int) house->getServiceValue( Service::baths );
+  case citylayer::health: return metrics.value( overlay, city::MetricsGrid::health );
+  case citylayer::hospital: return metrics.value( overlay, city::MetricsGrid::hospital );
+  case citylayer::barber: return metrics.value( overlay, city::MetricsGrid::barber );
+  case citylayer::baths: return metrics.value( overlay, city::MetricsGrid::baths );
   }
 
   return 0;
@@ -92,11 +94,8 @@ void LayerHealth::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-
-        healthLevel = _getLevelValue( house );
-
-        needDrawAnimations = (house->spec().level() == 1) && (house->habitants().empty());
+        healthLevel = _getLevelValue( overlay.object() );
+        needDrawAnimations = _city()->metrics().value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         if( !needDrawAnimations )
         {
@@ -163,7 +162,7 @@ void LayerHealth::handleEvent(NEvent& event)
           case citylayer::baths: typeName = "baths"; break;
           }
 
-          int lvlValue = _getLevelValue( house );
+          int lvlValue = _getLevelValue( house.object() );
           std::string levelName;
           if( lvlValue > 0 )
           {
@@ -32,7 +32,7 @@ public:
 
 private:
   LayerHealth(Camera& camera, PlayerCityPtr city, int type );
-  int _getLevelValue(HousePtr house);
+  int _getLevelValue( TileOverlay* overlay );
 
   std::set<int> _flags;
   int _type;
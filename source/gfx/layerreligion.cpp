@@ -20,6 +20,7 @@
 #include "objects/house_level.hpp"
 #include "layerconstants.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "core/stringhelper.hpp"
 #include "core/event.hpp"
 #include "tilemap_camera.hpp"
@@ -86,14 +87,9 @@ void LayerReligion::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-        religionLevel = (int) house->getServiceValue(Service::religionMercury);
-        religionLevel += house->getServiceValue(Service::religionVenus);
-        religionLevel += house->getServiceValue(Service::religionMars);
-        religionLevel += house->getServiceValue(Service::religionNeptune);
-        religionLevel += house->getServiceValue(Service::religionCeres);
-        religionLevel = math::clamp( religionLevel / (house->spec().minReligionLevel()+1), 0, 100 );
-        needDrawAnimations = (house->spec().level() == 1) && house->habitants().empty();
+        city::MetricsGrid& metrics = _city()->metrics();
+        religionLevel = metrics.value( overlay.object(), city::MetricsGrid::religion );
+        needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         if( !needDrawAnimations )
         {
@@ -64,6 +64,7 @@ LayerSimple::LayerSimple( Camera& camera, PlayerCityPtr city)
   : Layer( &camera, city ), _d( new Impl )
 {
   _addWalkerType( walker::all );
+  _setDrawListEnabled( true );
 }
 
 }//end namespace gfx
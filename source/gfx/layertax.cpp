@@ -25,6 +25,7 @@
 #include "camera.hpp"
 #include "core/gettext.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 
 using namespace constants;
 
@@ -73,16 +74,10 @@ void LayerTax::drawTile(Engine& engine, Tile& tile, const Point& offset)
       //houses
     case building::house:
       {
-        HousePtr house = ptr_cast<House>( overlay );
-        //taxLevel = house->getServiceValue( Service::forum );
-        taxLevel = math::clamp<int>( house->taxesThisYear(), 0, 100 );
-        needDrawAnimations = (house->spec().level() == 1) && (house->habitants().empty());
-
-        if( needDrawAnimations  )
-        {
-          int taxAccess = house->hasServiceAccess( Service::forum );
-          needDrawAnimations = (taxAccess < 25);
-        }
+        city::MetricsGrid& metrics = _city()->metrics();
+        taxLevel = metrics.value( overlay.object(), city::MetricsGrid::tax );
+        // forum access is a flag, so empty house always keeps own picture
+        needDrawAnimations = metrics.value( overlay.object(), city::MetricsGrid::vacant ) > 0;
 
         if( !needDrawAnimations )
         {
@@ -21,6 +21,7 @@
 #include "objects/house.hpp"
 #include "objects/constants.hpp"
 #include "city/helper.hpp"
+#include "city/metricsgrid.hpp"
 #include "objects/house_level.hpp"
 #include "good/goodhelper.hpp"
 #include "game/resourcegroup.hpp"
@@ -72,12 +73,7 @@ void LayerTroubles::drawTile(Engine& engine, Tile& tile, const Point& offset)
     //other buildings
     default:
     {
-      ConstructionPtr c = ptr_cast<Construction>( overlay );
-      if( c.isValid() )
-      {
-        std::string trouble = c->troubleDesc();
-        needDrawAnimations = !trouble.empty();
-      }
+      needDrawAnimations = _city()->metrics().value( overlay.object(), city::MetricsGrid::trouble ) > 0;
     }
     break;
     }
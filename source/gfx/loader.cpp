@@ -18,6 +18,7 @@
 #include "loader.hpp"
 #include "loader_png.hpp"
 #include "loader_bmp.hpp"
+#include "loader_raw.hpp"
 #include "core/foreach.hpp"
 #include "core/logger.hpp"
 #include "vfs/path.hpp"
@@ -29,6 +30,7 @@ class PictureLoader::Impl
 {
 public:
   void initLoaders();
+  AbstractPictureLoader* findLoader( vfs::NFile file );
 
   typedef std::vector< AbstractPictureLoader* > Loaders;
   typedef Loaders::iterator LoaderIterator;
@@ -44,6 +46,7 @@ void PictureLoader::Impl::initLoaders()
 {
   loaders.push_back( new PictureLoaderPng() );
   loaders.push_back( new PictureLoaderBmp() );
+  loaders.push_back( new PictureLoaderRaw() );
   //_d->loaders.push_back( new PixmapLoaderPsd() );
   //_d->loaders.push_back( new PixmapLoaderJpeg() );
 }
@@ -61,27 +64,53 @@ Picture PictureLoader::load( vfs::NFile file )
   if( !file.isOpen() )
      return Picture::getInvalid();
 
+  AbstractPictureLoader* loader = _d->findLoader( file );
+  if( loader )
+  {
+    // reset file position which might have changed due to previous format check
+    file.seek(0);
+    return loader->load( file );
+  }
+
+  return Picture::getInvalid(); // failed to load
+}
+
+bool PictureLoader::decode( vfs::NFile file, PictureData& data )
+{
+  if( !file.isOpen() )
+    return false;
+
+  AbstractPictureLoader* loader = _d->findLoader( file );
+  if( loader )
+  {
+    file.seek(0);
+    return loader->decode( file, data );
+  }
+
+  return false;
+}
+
+AbstractPictureLoader* PictureLoader::Impl::findLoader( vfs::NFile file )
+{
   // try to load file based on file extension
-  foreach( loader, _d->loaders )
+  foreach( loader, loaders )
   {
-    if( (*loader)->isALoadableFileExtension(file.path()) )
+    if( (*loader)->isALoadableFileExtension( file.path() ) )
     {
-      // reset file position which might have changed due to previous loadImage calls
       file.seek(0);
-      Picture ret = (*loader)->load( file );
-      return ret;
-    }
-    else
-    {
-      Logger::warning( "WARNING !!!: PictureLoader have unknown extension with " + file.path().absolutePath().toString() );
-      bool isMyFormat = (*loader)->isALoadableFileFormat(file);
-      if( isMyFormat )
-      {
-         file.seek(0);
-        return (*loader)->load( file );
-      }
+      if( (*loader)->isALoadableFileFormat( file ) )
+        return *loader;
     }
   }
 
-  return Picture::getInvalid(); // failed to load
+  // extension can lie (archives return decoded pictures with original names), check content
+  foreach( loader, loaders )
+  {
+    file.seek(0);
+    if( (*loader)->isALoadableFileFormat( file ) )
+      return *loader;
+  }
+
+  Logger::warning( "WARNING !!!: PictureLoader have unknown format with " + file.path().toString() );
+  return 0;
 }
@@ -22,6 +22,13 @@
 #include "core/scopedptr.hpp"
 #include "vfs/file.hpp"
 
+//! Decoded pixels (BGRA), which not uploaded to video memory yet
+struct PictureData
+{
+  Size size;
+  std::vector<unsigned char> pixels;
+};
+
 //! Class which is able to create a picture(sdl surface) from a file.
 class AbstractPictureLoader : public ReferenceCounted
 {
@@ -35,6 +42,10 @@ public:
 
     //! creates a surface from the file
     virtual gfx::Picture load( vfs::NFile file ) const = 0;
+
+    //! decodes the file to pixels without video memory usage,
+    //! returns false if loader can't do it
+    virtual bool decode( vfs::NFile, PictureData& ) const { return false; }
 };
 
 class PictureLoader
@@ -44,6 +55,9 @@ public:
 
     gfx::Picture load( vfs::NFile file );
 
+    //! thread safe decoding, if loader for this format support it
+    bool decode( vfs::NFile file, PictureData& data );
+
     ~PictureLoader(void);
 private:
 
@@ -58,13 +58,13 @@ bool PictureLoaderPng::isALoadableFileFormat( vfs::NFile file) const
 }
 
 
-// load in the image data
-Picture PictureLoaderPng::load( vfs::NFile file ) const
+// decode the image data
+bool PictureLoaderPng::decode( vfs::NFile file, PictureData& data ) const
 {
   if(!file.isOpen())
   {
     Logger::warning( "LOAD PNG: can't open file %s", file.path().toString().c_str() );
-    return Picture::getInvalid();
+    return false;
   }
 
   png_byte buffer[8];
@@ -72,14 +72,14 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   if( file.read(buffer, 8) != 8 )
   {
     Logger::warning( "LOAD PNG: can't read file %s", file.path().toString().c_str() );
-    return Picture::getInvalid();
+    return false;
   }
 
   // Check if it really is a PNG file
   if( png_sig_cmp(buffer, 0, 8) )
   {
     Logger::warning( "LOAD PNG: not really a png %s", file.path().toString().c_str() );
-    return Picture::getInvalid();
+    return false;
   }
 
   // Allocate the png read struct
@@ -89,7 +89,7 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   if( !png_ptr )
   {
     Logger::warning( "LOAD PNG: Internal PNG create read struct failure %s", file.path().toString().c_str() );
-    return Picture::getInvalid();
+    return false;
   }
 
   // Allocate the png info struct
@@ -98,7 +98,7 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   {
     Logger::warning( "LOAD PNG: Internal PNG create info struct failure 5s", file.path().toString().c_str() );
     png_destroy_read_struct(&png_ptr, NULL, NULL);
-    return Picture::getInvalid();
+    return false;
   }
 
   // for proper error handling
@@ -109,7 +109,7 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
         if( RowPointers )
                                 delete [] RowPointers;
                         */
-        return Picture::getInvalid();
+        return false;
   }
 
   // changed by zola so we don't need to have public FILE pointers
@@ -196,7 +196,7 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   {
     Logger::warning( "LOAD PNG: Internal PNG create row pointers failure %s", file.path().toString().c_str() );
     png_destroy_read_struct(&png_ptr, NULL, NULL);
-    return Picture::getInvalid();
+    return false;
   }
 
   // Create array of pointers to rows in image data
@@ -206,19 +206,19 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   ScopedPtr<unsigned char*> RowPointers( (unsigned char**)new png_bytep[ Height ] );
 
   // Fill array of pointers to rows in image data
-  unsigned char* data = &bytes[0];
+  unsigned char* rowData = &bytes[0];
 
   for(unsigned int i=0; i<Height; ++i)
   {
-    RowPointers.data()[i] = data;
-    data += Width * 4;
+    RowPointers.data()[i] = rowData;
+    rowData += Width * 4;
   }
 
   // for proper error handling
   if( setjmp( png_jmpbuf( png_ptr ) ) )
   {
     png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-    return Picture::getInvalid();
+    return false;
   }
 
   // Read data using the library function that handles all transformations including interlacing
@@ -227,8 +227,21 @@ Picture PictureLoaderPng::load( vfs::NFile file ) const
   png_read_end( png_ptr, NULL );
   png_destroy_read_struct( &png_ptr, &info_ptr, 0 ); // Clean up memory
 
+  data.size = Size( Width, Height );
+  data.pixels.swap( bytes );
+
+  return true;
+}
+
+// load in the image data
+Picture PictureLoaderPng::load( vfs::NFile file ) const
+{
+  PictureData data;
+  if( !decode( file, data ) )
+    return Picture::getInvalid();
+
   // Create the image structure to be filled by png data
-  Picture* pic = Picture::create( Size( Width, Height ), &bytes[0] );
+  Picture* pic = Picture::create( data.size, &data.pixels[0] );
 
   return *pic;
 }
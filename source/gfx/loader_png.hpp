@@ -20,6 +20,9 @@ public:
 
    //! creates a surface from the file
    virtual gfx::Picture load( vfs::NFile file ) const;
+
+   //! decodes file to pixels, may be called from worker thread
+   virtual bool decode( vfs::NFile file, PictureData& data ) const;
 };
 
 #endif //__OC3_PICTURELOADER_PNG_H_INCLUDED__
@@ -0,0 +1,78 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "loader_raw.hpp"
+#include "core/logger.hpp"
+#include "vfs/path.hpp"
+
+#include <cstring>
+
+using namespace gfx;
+
+bool PictureLoaderRaw::isALoadableFileExtension(const vfs::Path& filename) const
+{
+  return filename.isMyExtension( ".raw" );
+}
+
+bool PictureLoaderRaw::isALoadableFileFormat( vfs::NFile file) const
+{
+  if( !file.isOpen() )
+    return false;
+
+  RawPictureHeader header;
+  file.seek( 0 );
+  if( file.read( &header, sizeof(header) ) != sizeof(header) )
+    return false;
+
+  return memcmp( header.magic, RawPictureHeader::signature(), 4 ) == 0;
+}
+
+bool PictureLoaderRaw::decode( vfs::NFile file, PictureData& data ) const
+{
+  RawPictureHeader header;
+  file.seek( 0 );
+  if( file.read( &header, sizeof(header) ) != sizeof(header)
+      || memcmp( header.magic, RawPictureHeader::signature(), 4 ) != 0 )
+  {
+    Logger::warning( "LOAD RAW: wrong header in " + file.path().toString() );
+    return false;
+  }
+
+  unsigned int length = header.width * header.height * 4;
+  data.size = Size( header.width, header.height );
+  data.pixels.resize( length );
+  if( length > 0 && file.read( &data.pixels[0], length ) != (int)length )
+  {
+    Logger::warning( "LOAD RAW: not enough data in " + file.path().toString() );
+    return false;
+  }
+
+  return true;
+}
+
+Picture PictureLoaderRaw::load(vfs::NFile file) const
+{
+  PictureData data;
+  if( !decode( file, data ) || data.pixels.empty() )
+    return Picture::getInvalid();
+
+  Picture* pic = Picture::create( data.size, &data.pixels[0] );
+  Picture ret = *pic;
+  delete pic;
+
+  return ret;
+}
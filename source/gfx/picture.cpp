@@ -228,6 +228,7 @@ void Picture::update()
 {
   if( _d->texture && _d->surface )
   {
+    Engine::instance().flush();  // commands recorded before must see old pixels
     SDL_UpdateTexture(_d->texture, 0, _d->surface->pixels, _d->surface->pitch );
     return;
   }
@@ -238,6 +239,22 @@ void Picture::update()
   }
 }
 
+void Picture::update( const Rect& area )
+{
+  if( _d->texture && _d->surface )
+  {
+    const unsigned char* pixels = (const unsigned char*)_d->surface->pixels;
+    pixels += area.top() * _d->surface->pitch + area.left() * _d->surface->format->BytesPerPixel;
+
+    SDL_Rect r = { area.left(), area.top(), area.width(), area.height() };
+    Engine::instance().flush();
+    SDL_UpdateTexture(_d->texture, &r, pixels, _d->surface->pitch );
+    return;
+  }
+
+  update();
+}
+
 void Picture::fill( const NColor& color, Rect rect )
 {
   if( _d->surface )
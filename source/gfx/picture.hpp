@@ -92,6 +92,9 @@ public:
   static void destroy( Picture* ptr );
 
   void update();
+
+  //! upload only the given area of the surface to texture
+  void update( const Rect& area );
 private:
   class Impl;
   ScopedPtr< Impl > _d;
@@ -18,11 +18,13 @@
 #include "picture_bank.hpp"
 
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <memory>
 #include <sys/stat.h>
 #include <map>
 #include <set>
+#include <list>
 #include <SDL.h>
 
 #include "core/position.hpp"
@@ -37,91 +39,231 @@
 #include "loader.hpp"
 #include "core/saveadapter.hpp"
 #include "vfs/file.hpp"
+#include "vfs/memfile.hpp"
+#include "vfs/mappedfile.hpp"
 #include "core/color.hpp"
+#include "core/time.hpp"
+#include "thread/workerpool.hpp"
 
 using namespace gfx;
 
 namespace {
 const char* framesSection = "frames";
+static const int decoderStopTimeout = 5; // seconds
+
+//resource name is picture name without extension
+std::string __resourceName( const std::string& name )
+{
+  return name.substr( 0, name.find('.') );
+}
+
+//draw offset of picture, tiles and walkers are corrected by picture size
+Point __pictureOffset( const std::string& rcname, const Size& size )
+{
+  // decode the picture name => to set the offset manually
+  Point pic_info = PictureInfoBank::instance().getOffset( rcname );
+
+  if( pic_info == Point( -1, -1 ) )
+  {
+    // this is a tiled picture=> automatic offset correction
+    return Point( 0, size.height()-15*( (size.width()+2)/60 ) );   // (w+2)/60 is the size of the tile: (1x1, 2x2, 3x3, ...)
+  }
+  else if( pic_info == Point( -2, -2 ) )
+  {
+    // this is a walker picture=> automatic offset correction
+    return Point( -size.width()/2, int(size.height()*3./4.) );
+  }
+
+  return pic_info;
+}
 }
 
+//binary atlas index, written by dep/atlas/AtlasGenerator next to json description
+//layout: header, entries sorted by name hash, zero terminated strings
+struct AtlasIndexHeader
+{
+  char magic[4];
+  unsigned int version;
+  unsigned int count;
+  unsigned int texture;  // offset of texture name in strings
+  unsigned int strings;  // offset of strings from file start
+};
+
+struct AtlasIndexEntry
+{
+  unsigned int hash;
+  unsigned int name;     // offset of frame name in strings
+  unsigned short x, y, w, h;
+};
+
+//frame data which index file can't hold, filled once when index opened
+struct AtlasFrame
+{
+  std::string name;
+  Point offset;
+};
+
 struct AtlasPreview
 {
   std::string filename;
-  std::set<unsigned int> images;
+  std::set<unsigned int> images; // used when atlas have no binary index
+  vfs::MappedFile index;
+  const AtlasIndexEntry* entries;
+  unsigned int count;
+  const char* strings;
+  std::vector<AtlasFrame> frames;  // same order as entries
+
+  AtlasPreview() : entries( 0 ), count( 0 ), strings( 0 ) {}
+
+  inline bool indexed() const { return entries != 0; }
+  inline std::string texture() const { return strings + ((const AtlasIndexHeader*)index.data())->texture; }
+  inline std::string name( const AtlasIndexEntry& entry ) const { return strings + entry.name; }
+
+  bool find( unsigned int hash ) const
+  {
+    if( !indexed() )
+      return images.count( hash ) > 0;
+
+    unsigned int left = 0, right = count;
+    while( left < right )
+    {
+      unsigned int middle = (left + right) / 2;
+      if( entries[ middle ].hash < hash ) { left = middle + 1; }
+      else { right = middle; }
+    }
+
+    return left < count && entries[ left ].hash == hash;
+  }
 
-  inline bool find( unsigned int hash ) { return images.count( hash ) > 0; }
+  bool openIndex( const vfs::Path& path )
+  {
+    if( !path.exist() || !index.open( path ) )
+      return false;
+
+    const AtlasIndexHeader* header = (const AtlasIndexHeader*)index.data();
+    if( index.size() < sizeof(AtlasIndexHeader)
+        || memcmp( header->magic, "CAIX", 4 ) != 0 || header->version != 1
+        || header->strings < sizeof(AtlasIndexHeader) + header->count * sizeof(AtlasIndexEntry)
+        || header->strings >= index.size() || index.data()[ index.size()-1 ] != 0 )
+    {
+      Logger::warning( "PictureBank: wrong atlas index " + path.toString() );
+      index.close();
+      return false;
+    }
+
+    entries = (const AtlasIndexEntry*)(index.data() + sizeof(AtlasIndexHeader));
+    count = header->count;
+    strings = index.data() + header->strings;
+
+    frames.resize( count );
+    for( unsigned int k=0; k < count; k++ )
+    {
+      const AtlasIndexEntry& entry = entries[ k ];
+      frames[ k ].name = __resourceName( name( entry ) );
+      frames[ k ].offset = __pictureOffset( frames[ k ].name, Size( entry.w, entry.h ) );
+    }
+    return true;
+  }
+};
+
+//decodes picture on worker thread, file data was read in main thread
+class PictureDecoder : public CTask
+{
+public:
+  std::string name;   // picture name or atlas filename
+  vfs::Path path;     // real path, loader selected by extension
+  ByteArray bytes;
+  VariantMap frames;  // atlas frames, empty for single picture
+  const AtlasPreview* atlas; // indexed atlas frames
+  PictureData data;
+  Picture placeholder;  // empty texture given out while decoding, pixels are uploaded into it later
+  bool decoded;
+  volatile bool cancelled;
+
+  PictureDecoder() : atlas( 0 ), decoded( false ), cancelled( false ) {}
+
+  virtual bool task()
+  {
+    if( cancelled )
+      return true;
+
+    vfs::NFile file = vfs::MemoryFile::create( bytes, path );
+    decoded = PictureLoader::instance().decode( file, data );
+    return true;
+  }
 };
 
 class PictureBank::Impl
 {
 public:
   typedef std::map<unsigned int, Picture> CachedPictures;
-  typedef std::vector< AtlasPreview > AtlasPreviews;
+  typedef std::vector< AtlasPreview* > AtlasPreviews;
   typedef std::map<SDL_Texture*, int> TextureCounter;
   typedef CachedPictures::iterator ItPicture;
+  typedef std::list< PictureDecoder* > Decoders;
+  typedef std::list< std::string > PrefetchQueue;
 
   AtlasPreviews atlases;
   StringArray picExentions;
   TextureCounter txCounters;
   CachedPictures resources;  // key=image name, value=picture
+  Decoders decoders;
+  PrefetchQueue prefetchQueue;
+  std::set<unsigned int> prefetched;
 
 public:
   Picture tryLoadPicture( const std::string& name );
   void loadAtlas(const vfs::Path& filename );
   void setPicture( const std::string &name, const Picture& pic );
+  Picture& setPicture( unsigned int hash, const Picture& pic, const Point& offset );
   void destroyUnusableTextures();
+  bool findPictureFile( const std::string& name, vfs::Path& realPath );
+  const AtlasPreview* findAtlas( unsigned int hash ) const;
+  AtlasPreview* openAtlas( const std::string& filename );
+  PictureDecoder* findDecoder( const std::string& name ) const;
+  PictureDecoder* findDecoder( const std::string& name, unsigned int hash ) const;
+  void readForDecode( const std::string& name );
+  bool startDecode( PictureDecoder* decoder );
+  void finishDecode( PictureDecoder* decoder );
+  bool createPlaceholder( PictureDecoder* decoder );
+  void releaseSurface( Picture& placeholder );
+  void setAtlasFrames( const VariantMap& frames, const Picture& mainTexture );
+  void setAtlasFrames( const AtlasPreview& atlas, const Picture& mainTexture );
 };
 
 void PictureBank::Impl::setPicture( const std::string &name, const Picture& pic )
+{
+  std::string rcname = __resourceName( name );
+  Picture& ptrPic = setPicture( StringHelper::hash( name ), pic,
+                                __pictureOffset( rcname, pic.size() ) );
+  ptrPic.setName( rcname );
+}
+
+Picture& PictureBank::Impl::setPicture( unsigned int hash, const Picture& pic, const Point& offset )
 {
   // first: we deallocate the current picture, if any
-  unsigned int picId = StringHelper::hash( name );
   Picture* ptrPic = 0;
-  Impl::ItPicture it = resources.find( picId );
+  Impl::ItPicture it = resources.find( hash );
   if( it != resources.end() )
   {
     //SDL_DestroyTexture( it->second.texture() );
-    if( it->second.texture() > 0 )
+    if( it->second.texture() != 0 )
       txCounters[ it->second.texture() ]--;
 
     ptrPic = &it->second;
   }
   else
   {
-    resources[ picId ] = Picture();
-    ptrPic = &resources[ picId ];
+    resources[ hash ] = Picture();
+    ptrPic = &resources[ hash ];
   }
 
   *ptrPic = pic;
-  if( pic.texture() > 0 )
+  if( pic.texture() != 0 )
     txCounters[ pic.texture() ]++;
 
-  int dot_pos = name.find('.');
-  std::string rcname = name.substr(0, dot_pos);
-
-  Point offset( 0, 0 );
-
-  // decode the picture name => to set the offset manually
-  Point pic_info = PictureInfoBank::instance().getOffset( rcname );
-
-  if( pic_info == Point( -1, -1 ) )
-  {
-    // this is a tiled picture=> automatic offset correction
-    offset.setY( pic.height()-15*( (pic.width()+2)/60 ) );   // (w+2)/60 is the size of the tile: (1x1, 2x2, 3x3, ...)
-  }
-  else if( pic_info == Point( -2, -2 ) )
-  {
-     // this is a walker picture=> automatic offset correction
-     offset = Point( -pic.width()/2, int(pic.height()*3./4.) );
-  }
-  else
-  {
-     offset = pic_info;
-  }
-
   ptrPic->setOffset( offset );
-  ptrPic->setName( rcname );
+  return *ptrPic;
 }
 
 void PictureBank::Impl::destroyUnusableTextures()
@@ -158,23 +300,8 @@ void PictureBank::setPicture( const std::string &name, const Picture& pic )
 
 void PictureBank::addAtlas( const std::string& filename )
 {
-  VariantMap options = SaveAdapter::load( filename );
-  if( !options.empty() )
-  {
-    Logger::warning( "PictureBank: load atlas " + filename );
-
-    AtlasPreview atlas;
-    atlas.filename = filename;
-
-    VariantMap items = options.get( framesSection ).toMap();
-    foreach( i, items )
-    {
-      unsigned int hash = StringHelper::hash( i->first );
-      atlas.images.insert( hash );
-    }
-
-    _d->atlases.push_back( atlas );
-  }
+  Logger::warning( "PictureBank: load atlas " + filename );
+  _d->openAtlas( filename );
 }
 
 void PictureBank::loadAtlas(const std::string& filename)
@@ -208,20 +335,71 @@ Picture& PictureBank::getPicture(const std::string& prefix, const int idx)
   return getPicture(resource_name);
 }
 
+void PictureBank::prefetch( const std::string& name )
+{
+  if( name.empty() )
+    return;
+
+  const unsigned int hash = StringHelper::hash( name );
+  if( _d->resources.count( hash ) > 0 || !_d->prefetched.insert( hash ).second )
+    return;
+
+  //files are read later in update(), not on render path
+  _d->prefetchQueue.push_back( name );
+}
+
+void PictureBank::update( unsigned int timeLimit )
+{
+  unsigned int startTime = DateTime::elapsedTime();
+  for( Impl::Decoders::iterator it=_d->decoders.begin(); it != _d->decoders.end(); )
+  {
+    if( DateTime::elapsedTime() - startTime > timeLimit )
+      return;
+
+    PictureDecoder* decoder = *it;
+    if( decoder->getStatus() == TaskStatusCompleted )
+    {
+      it = _d->decoders.erase( it );
+      _d->finishDecode( decoder );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  while( !_d->prefetchQueue.empty() && DateTime::elapsedTime() - startTime <= timeLimit )
+  {
+    std::string name = _d->prefetchQueue.front();
+    _d->prefetchQueue.pop_front();
+    _d->readForDecode( name );
+  }
+}
+
 PictureBank::PictureBank() : _d( new Impl )
 {
   _d->picExentions << ".png";
   _d->picExentions << ".bmp";
+  PictureLoader::instance(); //loaders must be created before workers use it
+  WorkerPool::instance();    //and pool must outlive decoders which it runs
 }
 
-PictureBank::~PictureBank(){}
+PictureBank::~PictureBank()
+{
+  foreach( it, _d->decoders ) { (*it)->cancelled = true; }
+
+  foreach( it, _d->decoders )
+  {
+    if( (*it)->wait( decoderStopTimeout ) ) { delete *it; }
+    else { Logger::warning( "PictureBank: decoder not stopped for " + (*it)->name ); }
+  }
 
+  foreach( i, _d->atlases ) { delete *i; }
+}
 
-Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
+bool PictureBank::Impl::findPictureFile( const std::string& name, vfs::Path& realPath )
 {
-  vfs::Path realPath( name );  
-
-  bool fileExist = false;
+  realPath = name;
   if( realPath.extension().empty() )
   {
     foreach( itExt, picExentions )
@@ -230,11 +408,309 @@ Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
 
       if( realPath.exist() )
       {
-        fileExist = true;
-        break;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+const AtlasPreview* PictureBank::Impl::findAtlas( unsigned int hash ) const
+{
+  foreach( i, atlases )
+  {
+    if( (*i)->find( hash ) )
+      return *i;
+  }
+
+  return 0;
+}
+
+AtlasPreview* PictureBank::Impl::openAtlas( const std::string& filename )
+{
+  foreach( i, atlases )
+  {
+    if( (*i)->filename == filename )
+      return *i;
+  }
+
+  AtlasPreview* atlas = new AtlasPreview();
+  atlas->filename = filename;
+
+  if( !atlas->openIndex( filename + ".idx" ) )
+  {
+    //no prebuilt index, read frame names from json description
+    VariantMap options = SaveAdapter::load( filename );
+    if( options.empty() )
+    {
+      delete atlas;
+      return 0;
+    }
+
+    VariantMap items = options.get( framesSection ).toMap();
+    foreach( i, items )
+    {
+      atlas->images.insert( StringHelper::hash( i->first ) );
+    }
+  }
+
+  atlases.push_back( atlas );
+  return atlas;
+}
+
+void PictureBank::Impl::readForDecode( const std::string& name )
+{
+  const unsigned int hash = StringHelper::hash( name );
+  if( resources.count( hash ) > 0 || findDecoder( name, hash ) != 0 )
+    return;
+
+  vfs::Path realPath;
+  if( findPictureFile( name, realPath ) )
+  {
+    PictureDecoder* decoder = new PictureDecoder();
+    decoder->name = name;
+    decoder->path = realPath;
+    decoder->bytes = vfs::NFile::open( realPath ).readAll();
+
+    if( !startDecode( decoder ) )
+      delete decoder;
+
+    return;
+  }
+
+  const AtlasPreview* atlas = findAtlas( hash );
+  if( !atlas )
+    return;
+
+  PictureDecoder* decoder = new PictureDecoder();
+  decoder->name = atlas->filename;
+  decoder->atlas = atlas->indexed() ? atlas : 0;
+  if( atlas->indexed() )
+  {
+    decoder->path = atlas->texture();
+  }
+  else
+  {
+    VariantMap info = SaveAdapter::load( atlas->filename );
+    decoder->path = info.get( "texture" ).toString();
+    decoder->frames = info.get( framesSection ).toMap();
+  }
+  decoder->bytes = vfs::NFile::open( decoder->path ).readAll();
+
+  if( !startDecode( decoder ) )
+    delete decoder;
+}
+
+PictureDecoder* PictureBank::Impl::findDecoder( const std::string& name, unsigned int hash ) const
+{
+  PictureDecoder* decoder = findDecoder( name );
+  if( decoder )
+    return decoder;
+
+  const AtlasPreview* atlas = findAtlas( hash );
+  return atlas ? findDecoder( atlas->filename ) : 0;
+}
+
+PictureDecoder* PictureBank::Impl::findDecoder( const std::string& name ) const
+{
+  foreach( it, decoders )
+  {
+    if( (*it)->name == name )
+      return *it;
+  }
+
+  return 0;
+}
+
+bool PictureBank::Impl::startDecode( PictureDecoder* decoder )
+{
+  if( decoder->bytes.empty() )
+    return false;
+
+  if( !WorkerPool::instance().post( decoder ) )
+    return false;
+
+  decoders.push_back( decoder );
+  return true;
+}
+
+void PictureBank::Impl::finishDecode( PictureDecoder* decoder )
+{
+  bool haveData = decoder->decoded && !decoder->data.pixels.empty();
+  if( !haveData )
+  {
+    Logger::warning( "PictureBank: decode failed for " + decoder->name );
+  }
+
+  if( decoder->placeholder.isValid() )
+  {
+    //pictures already share placeholder texture, only fill it
+    Picture& pic = decoder->placeholder;
+    SDL_Surface* surface = pic.surface();
+    if( haveData && surface && decoder->data.size == pic.size() )
+    {
+      const unsigned char* src = &decoder->data.pixels[0];
+      unsigned char* dst = (unsigned char*)surface->pixels;
+      unsigned int lineSize = pic.width() * 4;
+      for( int y=0; y < pic.height(); y++ )
+      {
+        memcpy( dst + y * surface->pitch, src + y * lineSize, lineSize );
       }
+
+      pic.update();
     }
+
+    releaseSurface( pic );
+    delete decoder;
+    return;
+  }
+
+  Picture pic = Picture::getInvalid();
+  if( haveData )
+  {
+    Picture* ptr = Picture::create( decoder->data.size, &decoder->data.pixels[0] );
+    pic = *ptr;
+    delete ptr;
+  }
+
+  if( decoder->atlas )
+  {
+    setAtlasFrames( *decoder->atlas, pic );
+  }
+  else if( decoder->frames.empty() )
+  {
+    if( pic.isValid() ) { setPicture( decoder->name, pic ); }
   }
+  else
+  {
+    setAtlasFrames( decoder->frames, pic );
+  }
+
+  delete decoder;
+}
+
+bool PictureBank::Impl::createPlaceholder( PictureDecoder* decoder )
+{
+  if( decoder->placeholder.isValid() )
+    return true;
+
+  //size is read from file header, decoded pixels are not needed for it
+  const ByteArray& b = decoder->bytes;
+  const unsigned char* h = (const unsigned char*)b.data();
+  Size size;
+  if( b.size() >= 24 && memcmp( h, "\x89PNG", 4 ) == 0 )
+  {
+    size = Size( (h[16] << 24) | (h[17] << 16) | (h[18] << 8) | h[19],
+                 (h[20] << 24) | (h[21] << 16) | (h[22] << 8) | h[23] );
+  }
+  else if( b.size() >= 26 && h[0] == 'B' && h[1] == 'M' )
+  {
+    int height = h[22] | (h[23] << 8) | (h[24] << 16) | (h[25] << 24);
+    size = Size( h[18] | (h[19] << 8) | (h[20] << 16) | (h[21] << 24), abs( height ) );
+  }
+
+  if( size.area() <= 0 )
+    return false;
+
+  Picture* ptr = Picture::create( size, 0, true );
+  decoder->placeholder = *ptr;
+  delete ptr;
+
+  if( decoder->atlas )
+  {
+    setAtlasFrames( *decoder->atlas, decoder->placeholder );
+  }
+  else if( decoder->frames.empty() )
+  {
+    setPicture( decoder->name, decoder->placeholder );
+  }
+  else
+  {
+    setAtlasFrames( decoder->frames, decoder->placeholder );
+  }
+
+  return true;
+}
+
+void PictureBank::Impl::releaseSurface( Picture& placeholder )
+{
+  //texture has final pixels, surface is not needed more
+  SDL_Surface* surface = placeholder.surface();
+  if( !surface )
+    return;
+
+  foreach( it, resources )
+  {
+    Picture& pic = it->second;
+    if( pic.surface() == surface )
+      pic.init( pic.texture(), 0, pic.textureID() );
+  }
+
+  placeholder.init( placeholder.texture(), 0, placeholder.textureID() );
+  SDL_FreeSurface( surface );
+}
+
+void PictureBank::Impl::setAtlasFrames( const VariantMap& frames, const Picture& mainTexture )
+{
+  foreach( i, frames )
+  {
+    VariantList rInfo = i->second.toList();
+    Picture pic = mainTexture;
+    Point start(rInfo.get( 0 ).toInt(), rInfo.get( 1 ).toInt() );
+    Size size( rInfo.get( 2 ).toInt(), rInfo.get( 3 ).toInt() );
+
+    pic.setOriginRect( Rect( start, size ) );
+    setPicture( i->first, pic );
+  }
+}
+
+void PictureBank::Impl::setAtlasFrames( const AtlasPreview& atlas, const Picture& mainTexture )
+{
+  for( unsigned int k=0; k < atlas.count; k++ )
+  {
+    const AtlasIndexEntry& entry = atlas.entries[ k ];
+    const AtlasFrame& frame = atlas.frames[ k ];
+    Picture pic = mainTexture;
+    pic.setOriginRect( Rect( Point( entry.x, entry.y ), Size( entry.w, entry.h ) ) );
+    pic.setName( frame.name );
+    setPicture( entry.hash, pic, frame.offset );
+  }
+}
+
+
+Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
+{
+  unsigned int hash = StringHelper::hash( name );
+
+  //picture was requested, but file is not read yet
+  if( prefetched.count( hash ) > 0 && findDecoder( name, hash ) == 0 )
+  {
+    prefetchQueue.remove( name );
+    readForDecode( name );
+  }
+
+  //picture is decoding now, give empty texture which will be filled when decoder finish
+  PictureDecoder* decoder = findDecoder( name, hash );
+  if( decoder )
+  {
+    if( decoder->getStatus() == TaskStatusCompleted )
+    {
+      decoders.remove( decoder );
+      finishDecode( decoder );
+    }
+    else if( !createPlaceholder( decoder ) )
+    {
+      Logger::warning( "PictureBank: unknown size of decoding picture " + decoder->name );
+    }
+
+    CachedPictures::iterator it = resources.find( hash );
+    if( it != resources.end() )
+      return it->second;
+  }
+
+  vfs::Path realPath;
+  bool fileExist = findPictureFile( name, realPath );
 
   if( fileExist )
   {    
@@ -246,16 +722,10 @@ Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
     }
   }
 
-  unsigned int hash = StringHelper::hash( name );
-  foreach( i, atlases )
+  const AtlasPreview* atlas = findAtlas( hash );
+  if( atlas )
   {
-    bool found = i->find( hash );
-    if( found )
-    {
-      loadAtlas( (*i).filename );
-      //unloadAtlas.erase( i );
-      break;
-    }
+    loadAtlas( atlas->filename );
   }
 
   CachedPictures::iterator it = resources.find( hash );
@@ -270,15 +740,40 @@ Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
 
 void PictureBank::Impl::loadAtlas(const vfs::Path& filePath)
 {
-  if( !filePath.exist() )
+  PictureDecoder* decoder = findDecoder( filePath.toString() );
+  if( decoder )
+  {
+    if( decoder->getStatus() == TaskStatusCompleted )
+    {
+      decoders.remove( decoder );
+      finishDecode( decoder );
+      return;
+    }
+
+    if( createPlaceholder( decoder ) )
+      return;
+
+    //unknown texture size, load it now, decoder result will replace it later
+  }
+
+  AtlasPreview* atlas = openAtlas( filePath.toString() );
+  if( !atlas )
   {
     Logger::warning( "PictureBank: cant find atlas " + filePath.toString() );
     return;
   }
 
-  VariantMap info = SaveAdapter::load( filePath );
-
-  vfs::Path texturePath = info.get( "texture" ).toString();
+  VariantMap info;
+  vfs::Path texturePath;
+  if( atlas->indexed() )
+  {
+    texturePath = atlas->texture();
+  }
+  else
+  {
+    info = SaveAdapter::load( filePath );
+    texturePath = info.get( "texture" ).toString();
+  }
 
   vfs::NFile file = vfs::NFile::open( texturePath );
 
@@ -293,18 +788,12 @@ void PictureBank::Impl::loadAtlas(const vfs::Path& filePath)
     mainTexture = Picture::getInvalid();
   }
 
-  if( !info.empty() )
+  if( atlas->indexed() )
   {
-    VariantMap items = info.get( framesSection ).toMap();
-    foreach( i, items )
-    {
-      VariantList rInfo = i->second.toList();
-      Picture pic = mainTexture;
-      Point start(rInfo.get( 0 ).toInt(), rInfo.get( 1 ).toInt() );
-      Size size( rInfo.get( 2 ).toInt(), rInfo.get( 3 ).toInt() );
-
-      pic.setOriginRect( Rect( start, size ) );
-      setPicture( i->first, pic );
-    }
+    setAtlasFrames( *atlas, mainTexture );
+  }
+  else if( !info.empty() )
+  {
+    setAtlasFrames( info.get( framesSection ).toMap(), mainTexture );
   }
 }
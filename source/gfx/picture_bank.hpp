@@ -46,6 +46,12 @@ public:
   // show resource
   Picture& getPicture(const std::string &prefix, const int idx);
 
+  // queue picture (or atlas with it) for background decoding, file is read in update()
+  void prefetch( const std::string& name );
+
+  // upload decoded pictures and read queued files, but not longer than timeLimit (ms)
+  void update( unsigned int timeLimit );
+
   ~PictureBank();
 
 private:
@@ -0,0 +1,121 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "renderbuffer.hpp"
+#include "picture.hpp"
+#include "core/foreach.hpp"
+
+namespace gfx
+{
+
+void RenderBuffer::draw( const Picture& pic, const int dx, const int dy, Rect* clipRect )
+{
+  const Rect& orect = pic.originRect();
+  const Point& offset = pic.offset();
+  Rect dst( Point( dx + offset.x(), dy - offset.y() ), orect.size() );
+
+  _appendPicture( RenderCommand::picture, pic, orect, dst, clipRect );
+}
+
+void RenderBuffer::draw( const Picture& pic, const Point& pos, Rect* clipRect )
+{
+  draw( pic, pos.x(), pos.y(), clipRect );
+}
+
+void RenderBuffer::draw( const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect )
+{
+  const Point& offset = pic.offset();
+  _appendPicture( RenderCommand::pictureRect, pic, srcRect,
+                  dstRect + Point( offset.x(), -offset.y() ), clipRect );
+}
+
+void RenderBuffer::draw( const Pictures& pics, const Point& pos, Rect* clipRect )
+{
+  foreach( it, pics )
+  {
+    draw( *it, pos.x(), pos.y(), clipRect );
+  }
+}
+
+void RenderBuffer::drawLine( const NColor& color, const Point& p1, const Point& p2 )
+{
+  RenderCommand& cmd = _append( RenderCommand::line );
+  cmd.dst = Rect( p1, p2 );
+  cmd.values[ 0 ] = color.color;
+}
+
+void RenderBuffer::setColorMask( int rmask, int gmask, int bmask, int amask )
+{
+  RenderCommand& cmd = _append( RenderCommand::colorMask );
+  cmd.values[ 0 ] = rmask;
+  cmd.values[ 1 ] = gmask;
+  cmd.values[ 2 ] = bmask;
+  cmd.values[ 3 ] = amask;
+}
+
+void RenderBuffer::resetColorMask() { _append( RenderCommand::resetMask ); }
+
+void RenderBuffer::setViewport( int index, bool render )
+{
+  RenderCommand& cmd = _append( RenderCommand::viewport );
+  cmd.values[ 0 ] = index;
+  cmd.values[ 1 ] = render ? 1 : 0;
+}
+
+void RenderBuffer::drawViewport( int index, Rect r )
+{
+  RenderCommand& cmd = _append( RenderCommand::drawViewport );
+  cmd.dst = r;
+  cmd.values[ 0 ] = index;
+}
+
+const RenderBuffer::Commands& RenderBuffer::commands() const { return _commands; }
+unsigned int RenderBuffer::size() const { return _commands.size(); }
+bool RenderBuffer::empty() const { return _commands.empty(); }
+void RenderBuffer::clear() { _commands.clear(); }
+
+RenderCommand& RenderBuffer::_append( RenderCommand::Type type )
+{
+  _commands.push_back( RenderCommand() );
+
+  RenderCommand& cmd = _commands.back();
+  cmd.type = type;
+  cmd.texture = 0;
+  cmd.textureID = 0;
+  cmd.clipped = false;
+  cmd.values[ 0 ] = cmd.values[ 1 ] = cmd.values[ 2 ] = cmd.values[ 3 ] = 0;
+
+  return cmd;
+}
+
+void RenderBuffer::_appendPicture( RenderCommand::Type type, const Picture& pic,
+                                   const Rect& src, const Rect& dst, Rect* clipRect )
+{
+  if( !pic.isValid() )
+    return;
+
+  RenderCommand& cmd = _append( type );
+  cmd.texture = pic.texture();
+  cmd.textureID = pic.textureID();
+  cmd.src = src;
+  cmd.dst = dst;
+  cmd.clipped = (clipRect != 0);
+  if( clipRect )
+    cmd.clip = *clipRect;
+}
+
+}//end namespace gfx
@@ -0,0 +1,80 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#ifndef __CAESARIA_RENDERBUFFER_H_INCLUDED__
+#define __CAESARIA_RENDERBUFFER_H_INCLUDED__
+
+#include "picturesarray.hpp"
+#include "core/rectangle.hpp"
+#include "core/color.hpp"
+#include <vector>
+
+struct SDL_Texture;
+
+namespace gfx
+{
+
+struct RenderCommand
+{
+  typedef enum { picture=0, pictureRect, line, colorMask, resetMask, viewport, drawViewport } Type;
+
+  Type type;
+  SDL_Texture* texture;
+  unsigned int textureID;
+  Rect src;
+  Rect dst;  // screen rect for pictures, end points for lines
+  Rect clip;
+  bool clipped;
+  int values[4];  // mask channels, line color or viewport index and flag
+};
+
+//! list of render commands which engine executes in one call,
+//! keeps only texture handles, so pictures must outlive the buffer
+class RenderBuffer
+{
+public:
+  typedef std::vector<RenderCommand> Commands;
+
+  void draw( const Picture& pic, const int dx, const int dy, Rect* clipRect=0 );
+  void draw( const Picture& pic, const Point& pos, Rect* clipRect=0 );
+  void draw( const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect=0 );
+  void draw( const Pictures& pics, const Point& pos, Rect* clipRect=0 );
+
+  void drawLine( const NColor& color, const Point& p1, const Point& p2 );
+
+  void setColorMask( int rmask, int gmask, int bmask, int amask );
+  void resetColorMask();
+
+  void setViewport( int index, bool render );
+  void drawViewport( int index, Rect r );
+
+  const Commands& commands() const;
+  unsigned int size() const;
+  bool empty() const;
+  void clear();
+
+private:
+  RenderCommand& _append( RenderCommand::Type type );
+  void _appendPicture( RenderCommand::Type type, const Picture& pic,
+                       const Rect& src, const Rect& dst, Rect* clipRect );
+
+  Commands _commands;
+};
+
+}//end namespace gfx
+
+#endif //__CAESARIA_RENDERBUFFER_H_INCLUDED__
@@ -23,6 +23,7 @@
 #include <sstream>
 #include <list>
 #include <vector>
+#include <algorithm>
 #include <SDL.h>
 #include <SDL_ttf.h>
 
@@ -47,11 +48,6 @@
 namespace gfx
 {
 
-namespace {
-  unsigned int drawTime;
-  unsigned int drawTimeBatch;
-}
-
 class SdlEngine::Impl
 {
 public:
@@ -73,12 +69,26 @@ public:
   SDL_Renderer *renderer;
 
   std::map< int, SDL_Texture* > renderTargets;
+  Point targetOffset;
+
+  typedef std::vector<SDL_Texture*> Textures;
 
   MaskInfo mask;
   unsigned int fps, lastFps;
   unsigned int lastUpdateFps;
   unsigned int drawCall;
   Font debugFont;
+
+public:
+  void restoreTextures( Textures& textures )
+  {
+    foreach( it, textures )
+    {
+      SDL_SetTextureColorMod( *it, 0xff, 0xff, 0xff );
+      SDL_SetTextureAlphaMod( *it, 0xff );
+    }
+    textures.clear();
+  }
 };
 
 
@@ -86,7 +96,7 @@ Picture& SdlEngine::screen(){  return _d->screen; }
 
 SdlEngine::SdlEngine() : Engine(), _d( new Impl )
 {
-  resetColorMask();
+  _d->mask.reset();
 
   _d->lastUpdateFps = DateTime::elapsedTime();
   _d->fps = 0;
@@ -284,6 +294,8 @@ void SdlEngine::loadPicture(Picture& ioPicture, bool streaming)
 
 void SdlEngine::unloadPicture( Picture& ioPicture )
 {
+  flush();  // recorded commands may still use this texture
+
   try
   {
     if( ioPicture.surface() ) SDL_FreeSurface( ioPicture.surface() );
@@ -299,21 +311,24 @@ void SdlEngine::unloadPicture( Picture& ioPicture )
 
 void SdlEngine::startRenderFrame()
 {
-  drawTime =0;
-  drawTimeBatch = 0;
   SDL_RenderClear(_d->renderer);  // black background for a complete redraw
 }
 
 void SdlEngine::endRenderFrame()
 {
+  flush();
+
   if( getFlag( Engine::debugInfo ) )
   {
-    std::string debugText = StringHelper::format( 0xff, "fps:%d call:%d", _d->lastFps, _d->drawCall );
+    std::string debugText = StringHelper::format( 0xff, "fps:%d call:%d cmd:%d state:%d", _d->lastFps, _d->drawCall,
+                                                  commandsCount(), stateChanges() );
     _d->fpsText->fill( 0, Rect() );
     _d->debugFont.draw( *_d->fpsText, debugText, Point( 0, 0 ) );
     draw( *_d->fpsText, Point( _d->screen.width() / 2, 2 ) );
   }
 
+  flush();
+
   //Refresh the screen
   //SDL_SetRenderTarget( _d->renderer, NULL );
 
@@ -330,173 +345,129 @@ void SdlEngine::endRenderFrame()
   }
 
   _d->drawCall = 0;
-
-  //Logger::warning( "dt=%d  dtb=%d", drawTime, drawTimeBatch );
+  _finishFrameStats();
 }
 
-void SdlEngine::draw(const Picture &picture, const int dx, const int dy, Rect* clipRect )
+void SdlEngine::_execute( const RenderBuffer& buffer )
 {
-  if( !picture.isValid() )
-      return;
-
-  int t = DateTime::elapsedTime();
-  _d->drawCall++;
-
-  if( clipRect != 0 )
-  {
-    SDL_Rect r = { clipRect->left(), clipRect->top(), clipRect->width(), clipRect->height() };
-    SDL_RenderSetClipRect( _d->renderer, &r );
-  }
-
-  const Impl::MaskInfo& mask = _d->mask;
-  SDL_Texture* ptx = picture.texture();
-  const Rect& orect = picture.originRect();
-  Size picSize = orect.size();
-  const Point& offset = picture.offset();
-
-  if( mask.enabled )
-  {
-    SDL_SetTextureColorMod( ptx, mask.red >> 16, mask.green >> 8, mask.blue );
-    SDL_SetTextureAlphaMod( ptx, mask.alpha >> 24 );
-  }
-
-  SDL_Rect srcRect = { orect.left(), orect.top(), picSize.width(), picSize.height() };
-  SDL_Rect dstRect = { dx+offset.x(), dy-offset.y(), picSize.width(), picSize.height() };
-
-  SDL_RenderCopy( _d->renderer, ptx, &srcRect, &dstRect );
-
-  if( mask.enabled )
-  {
-    SDL_SetTextureColorMod( ptx, 0xff, 0xff, 0xff );
-    SDL_SetTextureAlphaMod( ptx, 0xff );
-  }
-
-  if( clipRect != 0 )
-  {
-    SDL_RenderSetClipRect( _d->renderer, 0 );
-  }
-  drawTime += DateTime::elapsedTime() - t;
-}
-
-void SdlEngine::draw( const Picture& picture, const Point& pos, Rect* clipRect )
-{
-  draw( picture, pos.x(), pos.y(), clipRect );
-}
-
-void SdlEngine::draw( const Pictures& pictures, const Point& pos, Rect* clipRect)
-{
-  if( pictures.empty() )
-      return;
-
-  int t = DateTime::elapsedTime();
-  _d->drawCall++;
-
-  if( clipRect != 0 )
-  {
-    SDL_Rect r = { clipRect->left(), clipRect->top(), clipRect->width(), clipRect->height() };
-    SDL_RenderSetClipRect( _d->renderer, &r );
-  }
+  const Point& toff = _d->targetOffset;
+  Impl::MaskInfo& mask = _d->mask;
+  Impl::Textures modulated;
+  const Rect* clip = 0;
 
-  const Impl::MaskInfo& mask = _d->mask;
-  foreach( it, pictures )
+  foreach( it, buffer.commands() )
   {
-    const Picture& picture = *it;
-    SDL_Texture* ptx = picture.texture();
-    const Rect& orect = picture.originRect();
-    Size size = orect.size();
-    const Point& offset = picture.offset();
+    const RenderCommand& cmd = *it;
+    _commandsCount++;
 
-    if( mask.enabled )
+    // only pictures are clipped, other commands work on whole target
+    const Rect* needClip = ( cmd.clipped && cmd.type <= RenderCommand::pictureRect ) ? &cmd.clip : 0;
+    if( needClip != clip && ( !needClip || !clip || *needClip != *clip ) )
     {
-      SDL_SetTextureColorMod( ptx, mask.red >> 16, mask.green >> 8, mask.blue );
-      SDL_SetTextureAlphaMod( ptx, mask.alpha >> 24 );
+      if( needClip )
+      {
+        SDL_Rect r = { needClip->left() - toff.x(), needClip->top() - toff.y(), needClip->width(), needClip->height() };
+        SDL_RenderSetClipRect( _d->renderer, &r );
+      }
+      else
+      {
+        SDL_RenderSetClipRect( _d->renderer, 0 );
+      }
+
+      clip = needClip;
+      _stateChanges++;
     }
 
-    SDL_Rect srcRect = { orect.left(), orect.top(), size.width(), size.height() };
-    SDL_Rect dstRect = { pos.x() + offset.x(), pos.y() - offset.y(), size.width(), size.height() };
-
-    SDL_RenderCopy( _d->renderer, ptx, &srcRect, &dstRect );
-
-    if( mask.enabled )
+    switch( cmd.type )
     {
-      SDL_SetTextureColorMod( ptx, 0xff, 0xff, 0xff );
-      SDL_SetTextureAlphaMod( ptx, 0xff );
+    case RenderCommand::picture:
+    case RenderCommand::pictureRect:
+    {
+      // texture keeps mask until it changes, so batch of masked pictures costs one switch per texture
+      if( mask.enabled && std::find( modulated.begin(), modulated.end(), cmd.texture ) == modulated.end() )
+      {
+        SDL_SetTextureColorMod( cmd.texture, mask.red >> 16, mask.green >> 8, mask.blue );
+        SDL_SetTextureAlphaMod( cmd.texture, mask.alpha >> 24 );
+        modulated.push_back( cmd.texture );
+        _stateChanges++;
+      }
+
+      SDL_Rect srcRect = { cmd.src.left(), cmd.src.top(), cmd.src.width(), cmd.src.height() };
+      SDL_Rect dstRect = { cmd.dst.left() - toff.x(), cmd.dst.top() - toff.y(), cmd.dst.width(), cmd.dst.height() };
+
+      SDL_RenderCopy( _d->renderer, cmd.texture, &srcRect, &dstRect );
+      _d->drawCall++;
     }
-  }
+    break;
 
-  if( clipRect != 0 )
-  {
-    SDL_RenderSetClipRect( _d->renderer, 0 );
-  }
-  drawTimeBatch += DateTime::elapsedTime() - t;
-}
-
-void SdlEngine::draw(const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect)
-{
-  if( !pic.isValid() )
-      return;
-
-  int t = DateTime::elapsedTime();
-
-  _d->drawCall++;
-  SDL_Texture* ptx = pic.texture();
-
-  if( clipRect != 0 )
-  {
-    SDL_Rect r = { clipRect->left(), clipRect->top(), clipRect->width(), clipRect->height() };
-    SDL_RenderSetClipRect( _d->renderer, &r );
-  }
+    case RenderCommand::line:
+    {
+      NColor color( (unsigned int)cmd.values[ 0 ] );
+      SDL_SetRenderDrawColor( _d->renderer, color.red(), color.green(), color.blue(), color.alpha() );
+      SDL_RenderDrawLine( _d->renderer, cmd.dst.left() - toff.x(), cmd.dst.top() - toff.y(),
+                                        cmd.dst.right() - toff.x(), cmd.dst.bottom() - toff.y() );
+      SDL_SetRenderDrawColor( _d->renderer, 0, 0, 0, 0 );
+    }
+    break;
+
+    case RenderCommand::colorMask:
+      if( !mask.enabled || mask.red != cmd.values[ 0 ] || mask.green != cmd.values[ 1 ]
+          || mask.blue != cmd.values[ 2 ] || mask.alpha != cmd.values[ 3 ] )
+      {
+        _d->restoreTextures( modulated );
+        mask.red = cmd.values[ 0 ];
+        mask.green = cmd.values[ 1 ];
+        mask.blue = cmd.values[ 2 ];
+        mask.alpha = cmd.values[ 3 ];
+        mask.enabled = true;
+      }
+    break;
+
+    case RenderCommand::resetMask:
+      _d->restoreTextures( modulated );
+      mask.reset();
+    break;
+
+    case RenderCommand::viewport:
+    {
+      SDL_Texture* target = _d->renderTargets.at( cmd.values[ 0 ] );
+      if( target )
+      {
+        bool render = cmd.values[ 1 ] > 0;
+        SDL_SetRenderTarget( _d->renderer, render ? target : 0 );
+        if( render )
+        {
+          SDL_RenderClear(_d->renderer);  // black background for a complete redraw
+        }
+        _stateChanges++;
+      }
+    }
+    break;
 
-  const Impl::MaskInfo& mask = _d->mask;
-  if( mask.enabled )
-  {
-    SDL_SetTextureColorMod( ptx, mask.red >> 16, mask.green >> 8, mask.blue );
-    SDL_SetTextureAlphaMod( ptx, mask.alpha >> 24 );
+    case RenderCommand::drawViewport:
+    {
+      SDL_Texture* target = _d->renderTargets[ cmd.values[ 0 ] ];
+      if( target )
+      {
+        SDL_RenderCopyEx(_d->renderer, target, 0, 0, 0, 0, SDL_FLIP_NONE );
+      }
+    }
+    break;
+    }
   }
 
-  const Point& offset = pic.offset();
-
-  SDL_Rect srcr = { srcRect.left(), srcRect.top(), srcRect.width(), srcRect.height() };
-  SDL_Rect dstr = { dstRect.left()+offset.x(), dstRect.top()-offset.y(), dstRect.width(), dstRect.height() };
-
-  SDL_RenderCopy( _d->renderer, ptx, &srcr, &dstr );
+  _d->restoreTextures( modulated );
 
-  if( mask.enabled )
-  {
-    SDL_SetTextureColorMod( ptx, 0xff, 0xff, 0xff );
-    SDL_SetTextureAlphaMod( ptx, 0xff );
-  }
-
-  if( clipRect != 0 )
+  if( clip )
   {
     SDL_RenderSetClipRect( _d->renderer, 0 );
   }
-
-  drawTime += DateTime::elapsedTime() - t;
-}
-
-void SdlEngine::drawLine(const NColor &color, const Point &p1, const Point &p2)
-{
-  SDL_SetRenderDrawColor( _d->renderer, color.red(), color.green(), color.blue(), color.alpha() );
-  SDL_RenderDrawLine( _d->renderer, p1.x(), p1.y(), p2.x(), p2.y() );
-
-  SDL_SetRenderDrawColor( _d->renderer, 0, 0, 0, 0 );
 }
 
-void SdlEngine::setColorMask( int rmask, int gmask, int bmask, int amask )
-{
-  Impl::MaskInfo& mask = _d->mask;
-  mask.red = rmask;
-  mask.green = gmask;
-  mask.blue = bmask;
-  mask.alpha = amask;
-  mask.enabled = true;
-}
-
-void SdlEngine::resetColorMask() { _d->mask.reset(); }
-
 void SdlEngine::initViewport(int index, Size s)
 {
+  flush();
+
   SDL_Texture*& target = _d->renderTargets[ index ];
   if( target != 0 )
   {
@@ -511,30 +482,43 @@ void SdlEngine::initViewport(int index, Size s)
   }
 }
 
-void SdlEngine::setViewport(int index, bool render)
+Picture* SdlEngine::createTarget( const Size& size )
 {
-  SDL_Texture* target = _d->renderTargets.at( index );
-  if( target )
+  SDL_Texture* tx = SDL_CreateTexture( _d->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                       SDL_TEXTUREACCESS_TARGET, size.width(), size.height() );
+  if( !tx )
   {
-    SDL_SetRenderTarget( _d->renderer, render ? target : 0 );
-    if( render )
-    {
-      SDL_RenderClear(_d->renderer);  // black background for a complete redraw
-    }
+    Logger::warning( "SdlEngine: cannot create target texture: %s", SDL_GetError() );
+    return 0;
   }
+
+  SDL_SetTextureBlendMode( tx, SDL_BLENDMODE_BLEND );
+
+  Picture* ret = new Picture();
+  ret->init( tx, 0, 0 );
+  ret->setOriginRect( Rect( Point( 0, 0 ), size ) );
+  return ret;
 }
 
-void SdlEngine::drawViewport(int index, Rect r)
+void SdlEngine::setTarget( Picture* target, const Point& offset )
 {
-  SDL_Texture* target = _d->renderTargets[ index ];
+  flush();
+
+  SDL_SetRenderTarget( _d->renderer, target ? target->texture() : 0 );
+  _d->targetOffset = target ? offset : Point();
+
   if( target )
   {
-    SDL_RenderCopyEx(_d->renderer, target, 0, 0, 0, 0, SDL_FLIP_NONE );
+    // transparent background, so target can be drawn over anything
+    SDL_SetRenderDrawColor( _d->renderer, 0, 0, 0, 0 );
+    SDL_RenderClear( _d->renderer );
   }
 }
 
 void SdlEngine::createScreenshot( const std::string& filename )
 {
+  flush();
+
   SDL_Surface* surface = SDL_CreateRGBSurface( 0, _srcSize.width(), _srcSize.height(), 24, 0, 0, 0, 0 );
   if( surface )
   {
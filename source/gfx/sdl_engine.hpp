@@ -46,25 +46,16 @@ public:
 
   virtual void setFlag( int flag, int value );
 
-  virtual void setColorMask( int rmask, int gmask, int bmask, int amask );
-  virtual void resetColorMask();
-
   virtual void initViewport( int, Size s);
-  virtual void setViewport( int, bool render);
-  virtual void drawViewport( int, Rect r);
+
+  virtual Picture* createTarget( const Size& size );
+  virtual void setTarget( Picture* target, const Point& offset );
 
   // deletes a picture (deallocate memory)
   virtual void deletePicture(Picture* pic);
   virtual void loadPicture(Picture& ioPicture, bool streaming);
   virtual void unloadPicture(Picture& ioPicture);
 
-  virtual void draw(const Picture& picture, const int dx, const int dy, Rect* clipRect=0);
-  virtual void draw(const Picture& picture, const Point& pos, Rect* clipRect=0 );
-  virtual void draw(const Pictures& pictures, const Point& pos, Rect* clipRect=0 );
-  virtual void draw(const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect=0 );
-
-  virtual void drawLine(const NColor &color, const Point &p1, const Point &p2);
-
   virtual unsigned int fps() const;
   virtual void createScreenshot( const std::string& filename );
 
@@ -77,6 +68,8 @@ public:
   virtual void debug( const std::string& text, const Point& pos );
 
 protected:
+  virtual void _execute( const RenderBuffer& buffer );
+
   class Impl;
   ScopedPtr< Impl > _d;
 };
@@ -68,6 +68,7 @@ Tile::Tile( const TilePos& pos) //: _terrain( 0, 0, 0, 0, 0, 0 )
   _terrain.reset();
   _terrain.imgid = 0;
   _height = 0;
+  _revision = 0;
   setEPos( pos );
 }
 
@@ -179,6 +180,9 @@ bool Tile::getFlag(Tile::Type type) const
 
 void Tile::setFlag(Tile::Type type, bool value)
 {
+  if( type != wasDrawn )
+    _revision++;
+
   switch( type )
   {
   case tlRoad: _terrain.road = value; break;
@@ -199,9 +203,9 @@ void Tile::setFlag(Tile::Type type, bool value)
 }
 
 TileOverlayPtr Tile::overlay() const{ return _overlay;}
-void Tile::setOverlay(TileOverlayPtr overlay){  _overlay = overlay;}
+void Tile::setOverlay(TileOverlayPtr overlay){  _overlay = overlay; _revision++; }
 unsigned int Tile::originalImgId() const{ return _terrain.imgid;}
-void Tile::setOriginalImgId(unsigned short id){  _terrain.imgid = id;}
+void Tile::setOriginalImgId(unsigned short id){  _terrain.imgid = id; _revision++; }
 void Tile::setParam( Param param, int value) { _terrain.params[ param ] = value; }
 void Tile::changeParam( Param param, int value) { _terrain.params[ param ] += value; }
 
@@ -93,6 +93,9 @@ public:
   inline int height() const { return _height; }
   void setHeight( int value ) { _height = value; }
 
+  // grows on every terrain flag, overlay or original image change
+  inline unsigned int revision() const { return _revision; }
+
   void setParam( Param param, int value );
   void changeParam( Param param, int value );
   int param( Param param ) const;
@@ -132,6 +135,7 @@ private:
   Picture _picture; // main picture
   bool _wasDrawn;
   int _height;
+  unsigned int _revision;
   gfx::Animation _animation;
   TileOverlayPtr _overlay;
 
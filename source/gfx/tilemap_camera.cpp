@@ -25,6 +25,7 @@
 #include "gfx/tile.hpp"
 #include "core/foreach.hpp"
 #include "tileoverlay.hpp"
+#include "drawlist.hpp"
 
 #include <set>
 
@@ -58,6 +59,8 @@ public:
                       // height of the view(in tiles) nb_tilesY = 1+2*_view_height
   TilesArray tiles;   // cached list of visible tiles
   TilesArray flatTiles;
+  DrawList drawList;
+  bool drawListDirty;
 
   MovableOrders mayMove( PointF point );
   void resetDrawn();
@@ -69,6 +72,8 @@ public:
   } 
 
   void cacheFlatTiles();
+  void buildDrawList();
+  void appendTile( Tile& tile );
 
 public signals:
   Signal1<Point> onPositionChangedSignal;
@@ -84,6 +89,7 @@ TilemapCamera::TilemapCamera() : _d( new Impl )
   _d->virtualSize = Size( 0 );
   _d->centerMapXZ = PointF( 0, 0 );
   _d->borderSize = Size( 90 );
+  _d->drawListDirty = true;
 }
 
 TilemapCamera::~TilemapCamera() {}
@@ -262,6 +268,7 @@ const TilesArray& TilemapCamera::tiles() const
     }
 
     _d->cacheFlatTiles();
+    _d->drawListDirty = true;
   }
 
   return _d->tiles;
@@ -321,6 +328,71 @@ void TilemapCamera::Impl::cacheFlatTiles()
   }
 }
 
+DrawList& TilemapCamera::drawList()
+{
+  tiles();  // visible tiles may be outdated
+  if( _d->drawListDirty )
+  {
+    _d->buildDrawList();
+    _d->drawListDirty = false;
+  }
+
+  return _d->drawList;
+}
+
+void TilemapCamera::Impl::appendTile( Tile& tile )
+{
+  // same passes as Layer::drawTile
+  if( tile.rwd() )
+    return;
+
+  tile.setWasDrawn();
+  drawList.addPicture( tile.picture(), tile.mappos() );
+  drawList.addAnimation( tile.animation(), tile.mappos() );  // validity is checked every frame
+
+  if( tile.rov().isValid() )
+  {
+    drawList.addPicture( tile.rov()->picture(), tile.mappos() );
+    drawList.addPictures( tile.rov()->pictures( Renderer::overlayAnimation ), tile.mappos() );
+  }
+}
+
+void TilemapCamera::Impl::buildDrawList()
+{
+  drawList.clear( tilemap->size() );
+
+  resetDrawn();
+  foreach( it, flatTiles ) { appendTile( **it ); }
+  drawList.setFlatCount( drawList.items().size() );
+
+  // same order as Layer::drawProminentTile, walkers and overWalker pass
+  foreach( it, tiles )
+  {
+    Tile* tile = *it;
+    Tile* master = tile->masterTile();
+    DrawList::Slot slot;
+
+    slot.begin = drawList.items().size();
+    if( !tile->isFlat() )
+    {
+      if( 0 == master ) { appendTile( *tile ); }
+      else if( master->epos().z() == tile->epos().z() ) { appendTile( *master ); }
+    }
+
+    slot.walkers = drawList.items().size();
+    Tile* overTile = master ? master : tile;
+    if( overTile->rov().isValid() )
+    {
+      const Pictures& pics = overTile->rov()->pictures( Renderer::overWalker );
+      if( !pics.empty() )
+        drawList.addPictures( pics, overTile->mappos() );
+    }
+
+    slot.end = drawList.items().size();
+    drawList.addSlot( tile->pos(), slot );
+  }
+}
+
 Point TilemapCamera::offset() const{  return _d->offset;}
 
 }//end namespace gfx
@@ -55,6 +55,9 @@ public:
   virtual const TilesArray& tiles() const;
   virtual const TilesArray& flatTiles() const;
 
+  // pictures of visible tiles in order of depth, rebuilt together with tiles
+  virtual DrawList& drawList();
+
   int centerX() const;
   int centerZ() const;
   TilePos center() const;
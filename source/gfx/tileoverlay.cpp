@@ -75,6 +75,7 @@ void TileOverlay::setType(const Type type)
 }
 
 void TileOverlay::timeStep(const unsigned long) {}
+void TileOverlay::computeStep(const unsigned long) {}
 
 void TileOverlay::changeDirection( Tile* masterTile, constants::Direction direction)
 {
@@ -28,6 +28,7 @@
 #include "core/direction.hpp"
 #include "game/predefinitions.hpp"
 #include "core/debug_queue.hpp"
+#include "core/objectpool.hpp"
 
 struct Desirability
 {
@@ -43,6 +44,7 @@ namespace gfx
 
 class TileOverlay : public Serializable, public ReferenceCounted
 {
+  CAESARIA_POOL_ALLOCATED
 public:
   typedef int Type;
   typedef int Group;
@@ -68,6 +70,10 @@ public:
 
   virtual Point offset(const Tile &tile, const Point& subpos ) const;
   virtual void timeStep(const unsigned long time);  // perform one simulation step
+
+  //! part of simulation step which changes only own state of overlay,
+  //! runs on worker threads before timeStep(), city may be read but not changed
+  virtual void computeStep(const unsigned long time);
   virtual void changeDirection(Tile *masterTile, constants::Direction direction);
 
   // graphic
@@ -408,6 +408,7 @@ void ContextMenu::beforeDraw(gfx::Engine& painter )
   {
     _d->needRecalculateItems = false;
     _recalculateSize();
+    invalidate();
   }
 
   Widget::beforeDraw( painter );
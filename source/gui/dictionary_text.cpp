@@ -584,6 +584,7 @@ void DictionaryText::beforeDraw(gfx::Engine& painter )
   if( _d->needUpdatePicture )
   {
     _updateTexture( painter );
+    invalidate();
 
     _d->needUpdatePicture = false;
   }
@@ -49,6 +49,7 @@ public:
 	int markBegin;
 	int markEnd;
   bool needUpdateTexture;
+  bool cursorShown;
 	NColor overrideColor;
 
 	int cursorPos, oldCursorPos;
@@ -115,6 +116,7 @@ std::string __ucs2utf8( const std::wstring& text )
 
 void EditBox::_init()
 {
+  _d->cursorShown = false;
   _d->lastBreakFont = activeFont();
 
   #ifdef _DEBUG
@@ -769,10 +771,19 @@ void EditBox::beforeDraw(Engine& painter)
 {
   int startPos = 0;
 
+  // cursor blinks twice per second, the widget has to be recomposed when it switches
+  bool cursorShown = isFocused() && (DateTime::elapsedTime() % 1000 < 500);
+  if( cursorShown != _d->cursorShown )
+  {
+    _d->cursorShown = cursorShown;
+    invalidate();
+  }
+
   bool needUpdateCursor = _d->needUpdateTexture;
   if( _d->needUpdateTexture )
   {
     _d->needUpdateTexture = false;
+    invalidate();
 
     if( !_d->textPicture || ( _d->textPicture && size() != _d->textPicture->size()) )
     {
@@ -175,6 +175,12 @@ bool Ui::setFocus( Widget* element )
       }
     }
 
+    if( _d->focusedElement.isValid() )
+      _d->focusedElement->invalidate();
+
+    if( element )
+      element->invalidate();
+
     // element is the new focus so it doesn't have to be dropped
     _d->focusedElement = element;
 
@@ -335,11 +341,13 @@ void Ui::_updateHovered( const Point& mousePos )
   {
     if( lastHovered.isValid() )
     {
+      lastHovered->invalidate();
       lastHovered->onEvent( NEvent::Gui( lastHovered.object(), 0, guiElementLeft ) );
     }
 
     if( _d->hovered.isValid() )
     {
+      _d->hovered->invalidate();
       _d->hovered->onEvent( NEvent::Gui( _d->hovered.object(), _d->hovered.object(), guiElementHovered ) );
     }
   }
@@ -425,6 +433,13 @@ bool Ui::handleEvent( const NEvent& event )
         _updateHovered( _d->cursorPos );
 #endif
 //!!! end android fix
+        // clicks and drags may change look of widgets under the cursor and in focus
+        if( event.mouse.type != mouseMoved || event.mouse.buttonStates != 0 )
+        {
+          if( _d->hovered.isValid() ) { _d->hovered->invalidate(); }
+          if( getFocus() ) { getFocus()->invalidate(); }
+        }
+
         switch( event.mouse.type )
         {
         case mouseLbtnPressed:
@@ -488,6 +503,9 @@ bool Ui::handleEvent( const NEvent& event )
               return true;
           }*/
 
+          if( getFocus() )
+            getFocus()->invalidate();
+
           if( getFocus() && getFocus()->onEvent(event))
             return true;
 
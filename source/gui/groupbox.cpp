@@ -104,6 +104,7 @@ void GroupBox::beforeDraw(gfx::Engine& painter )
   if( _d->needUpdateTexture )
   {
     _d->needUpdateTexture = false;
+    invalidate();
 
     if( !_d->backgroundImage.isValid() )
     {
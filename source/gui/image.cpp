@@ -116,6 +116,7 @@ Signal0<>& Image::onClicked(){  return _d->onClickedSignal;}
 void Image::setPicture( Picture picture )
 {
   _d->bgPicture = picture;
+  invalidate();
 
 	if( _d->mode == image )
 	{
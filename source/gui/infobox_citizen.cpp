@@ -67,6 +67,15 @@ public:
     emit _onClickedSignal( _walker );
   }
 
+  virtual void beforeDraw(gfx::Engine &painter)
+  {
+    // walker animation changes every frame, window with it can't stay cached
+    if( visible() )
+      invalidate();
+
+    Label::beforeDraw( painter );
+  }
+
   virtual void draw(gfx::Engine &painter)
   {
     if ( !visible() )
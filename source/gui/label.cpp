@@ -61,12 +61,14 @@ public:
   bool lmbPressed;
   string prefix;
   bool needUpdatePicture;
+  bool needUpdateText;
   int lineIntervalOffset;
   Point textOffset, iconOffset;
   Picture bgPicture;
   Picture icon;
   Pictures background;
   PictureRef textPicture;
+  Font::Glyphs glyphs;
   unsigned int opaque;
 
   Impl() : textMargin( Rect( 0, 0, 0, 0) ),
@@ -74,7 +76,7 @@ public:
            OverrideBGColorEnabled(false), isWordwrap(false),
            backgroundMode( Label::bgNone ),
            RestrainTextInside(true), RightToLeft(false),
-           needUpdatePicture(false), lineIntervalOffset( 0 )
+           needUpdatePicture(false), needUpdateText(false), lineIntervalOffset( 0 )
   {
     font = Font::create( FONT_2 );
     lmbPressed = false;
@@ -143,45 +145,12 @@ void Label::_updateTexture(gfx::Engine& painter )
     _updateBackground( painter, useAlpha4Text );
   }
 
-  if( _d->font.isValid() )
+  // text is drawn from glyph atlas over this picture, but translucent
+  // label must have it inside to fade together with background
+  if( _d->opaque != 0xff )
   {
-    Rect frameRect( Point( 0, 0 ), size() );
-    string rText = _d->prefix + text();
-
-    if( rText.size() && _d->font.isValid() )
-    {
-      //eColor = GetResultColor( eColor );
-      if( !_d->isWordwrap )
-      {
-        Rect textRect = _d->font.getTextRect( rText, frameRect, horizontalTextAlign(), verticalTextAlign() );
-
-        textRect += _d->textOffset;
-        _d->font.draw( *_d->textPicture, text(), textRect.lefttop(), useAlpha4Text, false );
-      }
-      else
-      {
-        if( _d->font != _d->lastBreakFont )
-        {
-            _d->breakText( text(), size() );
-        }
-
-        Rect r = frameRect;
-        int height = _d->font.getTextSize("A").height();
-
-        if( verticalTextAlign() == align::center )
-        {
-          r -= Point( 0, height * _d->brokenText.size() / 2 );
-        }
-
-        foreach( it, _d->brokenText )
-        {
-          Rect textRect = _d->font.getTextRect( *it, r, horizontalTextAlign(), verticalTextAlign() );
-          textRect += _d->textOffset;
-          _d->font.draw( *_d->textPicture, *it, textRect.lefttop(), useAlpha4Text, false );
-          r += Point( 0, height + _d->lineIntervalOffset );
-        }        
-      }
-    }
+    _updateText();
+    _d->font.draw( *_d->textPicture, _d->glyphs, Point(), false );
   }
 
   if( _d->textPicture )
@@ -191,6 +160,52 @@ void Label::_updateTexture(gfx::Engine& painter )
   }
 }
 
+void Label::_updateText()
+{
+  _d->glyphs.clear();
+  _d->needUpdateText = false;
+
+  if( !_d->font.isValid() )
+    return;
+
+  Rect frameRect( Point( 0, 0 ), size() );
+  string rText = _d->prefix + text();
+
+  if( rText.empty() )
+    return;
+
+  if( !_d->isWordwrap )
+  {
+    Rect textRect = _d->font.getTextRect( rText, frameRect, horizontalTextAlign(), verticalTextAlign() );
+
+    textRect += _d->textOffset;
+    _d->font.layout( text(), textRect.lefttop(), _d->glyphs );
+  }
+  else
+  {
+    if( _d->font != _d->lastBreakFont )
+    {
+        _d->breakText( text(), size() );
+    }
+
+    Rect r = frameRect;
+    int height = _d->font.getTextSize("A").height();
+
+    if( verticalTextAlign() == align::center )
+    {
+      r -= Point( 0, height * _d->brokenText.size() / 2 );
+    }
+
+    foreach( it, _d->brokenText )
+    {
+      Rect textRect = _d->font.getTextRect( *it, r, horizontalTextAlign(), verticalTextAlign() );
+      textRect += _d->textOffset;
+      _d->font.layout( *it, textRect.lefttop(), _d->glyphs );
+      r += Point( 0, height + _d->lineIntervalOffset );
+    }
+  }
+}
+
 void Label::_updateBackground(Engine& painter, bool& useAlpha4Text )
 {
   Rect r( Point( 0, 0 ), size() );
@@ -255,6 +270,11 @@ void Label::draw(gfx::Engine& painter )
     painter.draw( *_d->textPicture, absoluteRect().UpperLeftCorner, &absoluteClippingRectRef() );
   }
 
+  if( _d->opaque == 0xff )
+  {
+    _d->font.draw( painter, _d->glyphs, absoluteRect().UpperLeftCorner, &absoluteClippingRectRef() );
+  }
+
   Widget::draw( painter );
 }
 
@@ -533,6 +553,7 @@ void Label::setText(const string& newText)
 
   _d->breakText( text(), size() );
   _d->needUpdatePicture = true;
+  _d->needUpdateText = true;
 }
 
 Signal0<>& Label::onClicked() {  return _d->onClickedSignal; }
@@ -586,8 +607,23 @@ void Label::beforeDraw(gfx::Engine& painter )
   if( _d->needUpdatePicture )
   {
     _updateTexture( painter );
+    invalidate();
 
     _d->needUpdatePicture = false;
+    // translucent label has text inside of picture already
+    _d->needUpdateText = (_d->opaque == 0xff);
+  }
+
+  // new text only moves glyphs, picture stays the same
+  if( _d->needUpdateText )
+  {
+    invalidate();
+    if( _d->opaque == 0xff )
+      _updateText();
+    else
+      _updateTexture( painter );
+
+    _d->needUpdateText = false;
   }
 
   Widget::beforeDraw( painter );
@@ -690,7 +726,11 @@ void Label::setupUI(const VariantMap& ui)
     setBackgroundMode( mode );
 }
 
-void Label::setTextOffset(Point offset) {  _d->textOffset = offset;}
+void Label::setTextOffset(Point offset)
+{
+  _d->textOffset = offset;
+  _d->needUpdateText = true;
+}
 PictureRef& Label::_textPictureRef(){  return _d->textPicture; }
 gfx::Pictures&Label::_backgroundRef(){ return _d->background; }
 
@@ -123,6 +123,9 @@ protected:
   virtual void _updateBackground(gfx::Engine& painter , bool& useAlpha4Text);
   virtual void _handleClick();
 
+  //! place glyphs of text for drawing, picture is not touched
+  void _updateText();
+
   gfx::PictureRef& _textPictureRef();
   gfx::Pictures& _backgroundRef();
 
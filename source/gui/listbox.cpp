@@ -566,6 +566,7 @@ void ListBox::beforeDraw(gfx::Engine& painter)
 
   if( _d->needItemsRepackTextures )
   {
+    invalidate();
     bool hl = ( isFlag( hightlightNotinfocused ) || isFocused() || _d->scrollBar->isFocused() );
     Rect frameRect = _itemsRect();
     frameRect.rbottom() = frameRect.top() + _d->itemHeight;
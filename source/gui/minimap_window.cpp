@@ -39,7 +39,17 @@ namespace gui
 class Minimap::Impl
 {
 public:
+  struct WalkerDot
+  {
+    Point pos;
+    bool enemy;
+  };
+
+  typedef std::vector<WalkerDot> WalkerDots;
+
   PictureRef minimap;
+  PictureRef enemyDot;
+  PictureRef friendDot;
 
   PlayerCityPtr city;
   Camera const* camera;
@@ -49,8 +59,23 @@ public:
   int lastTimeUpdate;
   Point center;
 
+  // colors of whole map, two pixels per tile, updated for changed tiles only
+  std::vector<unsigned int> fullmap;
+  std::vector<unsigned int> revisions;
+  int fullmapWidth;
+  Rect dirtyArea;
+
+  // fullmap position of minimap left top corner, when it was drawn last time
+  Point windowOffset;
+  bool windowValid;
+
+  WalkerDots walkers;
+
   void getTerrainColours(const Tile& tile, int &c1, int &c2);
   void getBuildingColours(const Tile& tile, int &c1, int &c2);
+  void updateFullmap();
+  void updateWindow();
+  void updateWalkers();
   void updateImage();
 
 public signals:
@@ -63,7 +88,15 @@ Minimap::Minimap(Widget* parent, Rect rect, PlayerCityPtr city, const gfx::Camer
   _d->city = city;
   _d->camera = &camera;
   _d->lastTimeUpdate = 0;
+  _d->fullmapWidth = 0;
+  _d->windowValid = false;
   _d->minimap.reset( Picture::create( Size( 144, 110 ), 0, true ) );
+  _d->enemyDot.reset( Picture::create( Size( 2 ), 0, true ) );
+  _d->enemyDot->fill( DefaultColors::red, Rect() );
+  _d->enemyDot->update();
+  _d->friendDot.reset( Picture::create( Size( 2 ), 0, true ) );
+  _d->friendDot->fill( DefaultColors::blue, Rect() );
+  _d->friendDot->update();
   _d->colors = new MinimapColors( (ClimateType)city->climate() );
   setTooltipText( _("##minimap_tooltip##") );
 }
@@ -209,105 +242,131 @@ void Minimap::Impl::getBuildingColours(const Tile& tile, int &c1, int &c2)
 #endif
 }
 
-void Minimap::Impl::updateImage()
+void Minimap::Impl::updateFullmap()
 {
   Tilemap& tilemap = city->tilemap();
   int mapsize = tilemap.size();
 
-  // here we can draw anything
-  mapsize = std::min( mapsize, 42 );
-  TilePos tpos = camera->center();
-  TilePos offset = TilePos( 80, 80 );
-  TilePos startPos = tpos - offset;
-  TilePos stopPos = tpos + offset;
-
-  int w = minimap->width()-1;
-  int h = minimap->height();
-  unsigned int* pixels = minimap->lock();
+  if( fullmap.empty() )
+  {
+    fullmapWidth = mapsize * 2;
+    fullmap.resize( fullmapWidth * fullmapWidth, 0xff000000 );
+    revisions.resize( mapsize * mapsize, 0xffffffff );
+  }
 
-  if( pixels != 0)
+  // tile (i,j) is placed to (i+j, i-j+mapsize-1), walk through all tiles
+  // but recompute colors only when tile changed since last time
+  for( int i = 0; i < mapsize; i++ )
   {
-    minimap->fill( 0xff000000, Rect() );
-    for( int i = startPos.i(); i < stopPos.i(); i++)
+    unsigned int* revision = &revisions[ i * mapsize ];
+    for( int j = 0; j < mapsize; j++, revision++ )
     {
-      for (int j = startPos.j(); j < stopPos.j(); j++)
-      {
-        const Tile& tile = tilemap.at(i, j);
+      const Tile& tile = tilemap.at( i, j );
+      if( tile.revision() == *revision )
+        continue;
+
+      *revision = tile.revision();
 
-        Point pnt = getBitmapCoordinates(i-startPos.i() - 40, j-startPos.j()-60, mapsize);
-        int c1, c2;
-        getTerrainColours( tile, c1, c2);
+      int c1, c2;
+      getTerrainColours( tile, c1, c2 );
 
-        if( pnt.y() < 0 || pnt.x() < 0 || pnt.x() >= w || pnt.y() >= h )
-          continue;
+      Point pnt( i + j, i - j + mapsize - 1 );
+      unsigned int* bufp32 = &fullmap[ pnt.y() * fullmapWidth + pnt.x() ];
+      *bufp32 = c1;
+      *(bufp32+1) = c2;
 
-        unsigned int* bufp32;
-        bufp32 = pixels + pnt.y() * minimap->width() + pnt.x();
-        *bufp32 = c1;
-        *(bufp32+1) = c2;
+      if( dirtyArea.width() == 0 )
+        dirtyArea = Rect( pnt, Size( 2, 1 ) );
+      else
+      {
+        dirtyArea.addInternalPoint( pnt );
+        dirtyArea.addInternalPoint( pnt + Point( 2, 1 ) );
       }
     }
+  }
+}
 
+void Minimap::Impl::updateWindow()
+{
+  int mapsize = city->tilemap().size();
+  TilePos tpos = camera->center();
+  Point offset( tpos.i() + tpos.j() - 60, tpos.i() - tpos.j() + mapsize - 1 - 61 );
 
-    const WalkerList& walkers = city->walkers();
-    TileRect trect( startPos, stopPos );
-    //TilePos leftBottomPos = TilePos(std::min(startPos.i(), stopPos.i()), std::min(startPos.j(), stopPos.j()));
-    //TilePos rightTopPos = TilePos(std::max(startPos.i(), stopPos.i()), std::max(startPos.j(), stopPos.j()));
-    foreach( w, walkers)
+  Rect area( Point(), minimap->size() );
+  if( windowValid && offset == windowOffset )
+  {
+    // camera didn't move, copy only changed part of map
+    Rect changed = dirtyArea - offset;
+    if( changed.width() == 0 || !area.isRectCollided( changed ) )
     {
-      TilePos pos = (*w)->pos();
-      if( trect.contain( pos ) )
-      {
-        NColor cl;
-        if ((*w)->agressive() != 0)
-        {
+      dirtyArea = Rect();
+      return;
+    }
 
-          if ((*w)->agressive() > 0)
-          {
-            cl = DefaultColors::red;
-          }
-          else
-          {
-            cl = DefaultColors::blue;
-          }
+    area.clipAgainst( changed );
+  }
 
-          if (cl.color != 0)
-          {
-            Point pnt = getBitmapCoordinates(pos.i() - startPos.i() - 40, pos.j() - startPos.j() - 60, mapsize);
-            minimap->fill(cl, Rect(pnt, Size(2)));
-          }
-        }        
+  dirtyArea = Rect();
+  windowOffset = offset;
+  windowValid = true;
+
+  unsigned int* pixels = minimap->lock();
+  if( pixels != 0 )
+  {
+    int pitch = minimap->width();
+    for( int y = area.top(); y < area.bottom(); y++ )
+    {
+      unsigned int* bufp32 = pixels + y * pitch;
+      int fy = y + offset.y();
+      for( int x = area.left(); x < area.right(); x++ )
+      {
+        int fx = x + offset.x();
+        bool inside = fx >= 0 && fy >= 0 && fx < fullmapWidth && fy < fullmapWidth;
+        bufp32[ x ] = inside ? fullmap[ fy * fullmapWidth + fx ] : 0xff000000;
       }
     }
   }
 
   minimap->unlock();
-  minimap->update();
+  minimap->update( area );
+}
 
-  // show center of screen on minimap
-  // Exit out of image size on small carts... please fix it
+void Minimap::Impl::updateWalkers()
+{
+  int mapsize = std::min( city->tilemap().size(), 42 );
+  TilePos tpos = camera->center();
+  TilePos offset = TilePos( 80, 80 );
+  TilePos startPos = tpos - offset;
+  TilePos stopPos = tpos + offset;
 
-  /*sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX(),     mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ(), kWhite);
-  sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX() + 1, mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ(), kWhite);
-  sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX(),     mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() + 1, kWhite);
-  sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX() + 1, mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() + 1, kWhite);
+  walkers.clear();
 
-  for ( int i = TilemapRenderer::instance().getMapArea().getCenterX() - 18; i <= TilemapRenderer::instance().getMapArea().getCenterX() + 18; i++ )
+  const WalkerList& cityWalkers = city->walkers();
+  TileRect trect( startPos, stopPos );
+  Rect area( Point(), minimap->size() - Size( 2 ) );
+  foreach( w, cityWalkers )
   {
-    sdlFacade.setPixel(surface, i, mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() + 34, kYellow);
-    sdlFacade.setPixel(surface, i, mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() - 34, kYellow);
-  }
+    if( (*w)->agressive() == 0 )
+      continue;
 
-  for ( int j = mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() - 34; j <= mapsize * 2 - TilemapRenderer::instance().getMapArea().getCenterZ() + 34; j++ )
-  {
-    sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX() - 18, j, kYellow);
-    sdlFacade.setPixel(surface, TilemapRenderer::instance().getMapArea().getCenterX() + 18, j, kYellow);
-  }
-  */
+    TilePos pos = (*w)->pos();
+    if( trect.contain( pos ) )
+    {
+      WalkerDot dot;
+      dot.pos = getBitmapCoordinates(pos.i() - startPos.i() - 40, pos.j() - startPos.j() - 60, mapsize);
+      dot.enemy = (*w)->agressive() > 0;
 
-  //fullmap->unlock();
+      if( area.isPointInside( dot.pos ) )
+        walkers.push_back( dot );
+    }
+  }
+}
 
-  // this is window where minimap is displayed
+void Minimap::Impl::updateImage()
+{
+  updateFullmap();
+  updateWindow();
+  updateWalkers();
 }
 
 /* end of helper functions */
@@ -317,19 +376,33 @@ namespace {
   static const int kYellow = 0xFFFF00;
 }
 
-void Minimap::draw(Engine& painter)
+void Minimap::beforeDraw(Engine& painter)
 {
-  if( !visible() )
-    return;
-
-  if( DateTime::elapsedTime() - _d->lastTimeUpdate > 250 )
+  // minimap follows the city, so cached window must be recomposed on every update
+  if( visible() && DateTime::elapsedTime() - _d->lastTimeUpdate > 250 )
   {
     _d->updateImage();
     _d->lastTimeUpdate = DateTime::elapsedTime();
+    invalidate();
   }
 
+  Widget::beforeDraw( painter );
+}
+
+void Minimap::draw(Engine& painter)
+{
+  if( !visible() )
+    return;
+
   painter.draw( *_d->minimap, screenLeft(), screenTop() ); // 152, 145
 
+  // walkers are drawn over terrain, so moving them don't touch minimap texture
+  foreach( it, _d->walkers )
+  {
+    const Picture& dot = it->enemy ? *_d->enemyDot : *_d->friendDot;
+    painter.draw( dot, screenLeft() + it->pos.x(), screenTop() + it->pos.y() );
+  }
+
   Widget::draw( painter );
 }
 
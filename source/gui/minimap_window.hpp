@@ -39,6 +39,7 @@ public:
   Minimap(Widget* parent, Rect rect, PlayerCityPtr tilemap, const gfx::Camera& camera );
 
   virtual void draw( gfx::Engine& painter);
+  virtual void beforeDraw( gfx::Engine& painter );
 
   void setCenter( Point pos );
 
@@ -167,6 +167,7 @@ void PushButton::_updateBackground( ElementState state )
   Pictures& drawStack = _d->buttonStates[ state ].style;
 
   drawStack.clear();
+  invalidate();
 
   // draw button background
   Decorator::Mode mode = Decorator::pure;
@@ -296,6 +297,7 @@ void PushButton::setPicture(const std::string& rcname, int index, ElementState s
 void PushButton::setIcon( const std::string& rcname, int index, ElementState state)
 {
   _dfunc()->buttonStates[ state ].icon = Picture::load( rcname, index );
+  invalidate();
 }
 
 void PushButton::setIconOffset(Point offset)
@@ -305,6 +307,7 @@ void PushButton::setIconOffset(Point offset)
   {
     _d->buttonStates[ i ].iconOffset = offset;
   }
+  invalidate();
 }
 
 void PushButton::setIcon(const std::string& rcname, int index)
@@ -315,6 +318,7 @@ void PushButton::setIcon(const std::string& rcname, int index)
   {
     _d->buttonStates[ i ].icon = pic;
   }
+  invalidate();
 }
 
 void PushButton::setPicture( const std::string& rcname, int index )
@@ -482,10 +486,17 @@ void PushButton::beforeDraw( gfx::Engine& painter )
   // Point spritePos = AbsoluteRect.getCenter();
   __D_IMPL(_d,PushButton);
 
-	_d->currentButtonState = _state();
+  ElementState state = _state();
+  if( state != _d->currentButtonState )
+  {
+    _d->currentButtonState = state;
+    invalidate();
+  }
+
 	if( _d->needUpdateTextPic )
 	{
 		_updateTextPic();
+    invalidate();
 		_d->needUpdateTextPic = false;
 	}
 
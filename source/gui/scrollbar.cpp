@@ -269,6 +269,8 @@ void ScrollBar::beforeDraw(gfx::Engine& painter )
   if( !(_d->needRecalculateParams || needRecalculateSliderParams) )
       return;
 
+  invalidate();
+
   if( _d->needRecalculateParams )
   {
     _d->backgroundRect = absoluteRect();
@@ -89,6 +89,7 @@ void SmkViewer::beforeDraw( gfx::Engine& painter )
   {
     _d->needUpdateTexture = false;
     _d->updateTexture( painter, size() );
+    invalidate();
   }
 
   Widget::beforeDraw( painter );
@@ -57,6 +57,7 @@ void Widget::setTextAlignment(align::Type horizontal, align::Type vertical )
   __D_IMPL(d,Widget)
   d->textHorzAlign = horizontal;
   d->textVertAlign = vertical;
+  invalidate();
 }
 
 void Widget::setMaxWidth( unsigned int width ) { __D_IMPL(d,Widget) d->maxSize.setWidth( width );}
@@ -72,6 +73,7 @@ Widget::Widget( Widget* parent, int id, const Rect& rectangle )
   _d->alignTop = align::upperLeft;
   _d->alignBottom = align::upperLeft;
   _d->isVisible = true;
+  _d->dirty = true;
   _d->maxSize = Size(0,0);
   _d->minSize = Size(1,1);
   _d->parent = parent;
@@ -238,6 +240,11 @@ void Widget::updateAbsolutePosition()
     _resizeEvent();
   }
 
+  if( oldRect != _d->absoluteRect )
+  {
+    invalidate();
+  }
+
   // update all children
   foreach( widget, _d->children ) { (*widget)->updateAbsolutePosition(); }
 }
@@ -297,6 +304,7 @@ void Widget::removeChild( Widget* child )
       (*it)->setParent( 0 );
       (*it)->drop();
       _d->children.erase(it);
+      invalidate();
       return;
     }
 }
@@ -380,6 +388,7 @@ bool Widget::bringChildToFront( Widget* element )
     {
       children.erase(it);
       children.push_back(element);
+      invalidate();
       return true;
     }
   }
@@ -400,6 +409,7 @@ bool Widget::sendChildToBack( Widget* child )
     {
       children.erase(it);
       children.push_front(child);
+      invalidate();
       return true;
     }
   }
@@ -664,6 +674,7 @@ void Widget::_addChild( Widget* child )
     child->_dfunc()->lastParentRect = absoluteRect();
     child->setParent( this );
     _dfunc()->children.push_back(child);
+    invalidate();
   }
 }
 
@@ -789,9 +800,25 @@ void Widget::remove()
       parent()->removeChild( this );
 }
 
+// plain cursor moves and hover changes don't change widgets look,
+// hovered widgets are invalidated by Ui when hover switches
+static bool __isStateChanging( const NEvent& event )
+{
+  switch( event.EventType )
+  {
+  case sEventMouse: return event.mouse.type != mouseMoved || event.mouse.buttonStates != 0;
+  case sEventGui: return event.gui.type != guiElementHovered && event.gui.type != guiElementLeft;
+  default: return true;
+  }
+}
+
 bool Widget::onEvent( const NEvent& event )
 {
   __D_IMPL(_d,Widget)
+  // handlers change state which is visible on the next frame
+  if( __isStateChanging( event ) )
+    invalidate();
+
   foreach( item, _d->eventHandlers )
   {
     bool handled = (*item)->onEvent( event );
@@ -806,6 +833,28 @@ bool Widget::onEvent( const NEvent& event )
   return parent() ? parent()->onEvent(event) : false;
 }
 
+void Widget::invalidate()
+{
+  Widget* widget = this;
+  while( widget && !widget->_dfunc()->dirty )
+  {
+    widget->_dfunc()->dirty = true;
+    widget = widget->parent();
+  }
+}
+
+bool Widget::isDirty() const { return _dfunc()->dirty; }
+
+void Widget::_validate()
+{
+  __D_IMPL(_d,Widget)
+  if( !_d->dirty )
+    return;
+
+  _d->dirty = false;
+  foreach( widget, _d->children ) { (*widget)->_validate(); }
+}
+
 bool Widget::isMyChild( Widget* child ) const
 {
     if (!child)
@@ -832,16 +881,16 @@ void Widget::setHeight( unsigned int height )
   setGeometry( rectangle );
 }
 
-void Widget::setEnabled(bool enabled){  _dfunc()->isEnabled = enabled;}
+void Widget::setEnabled(bool enabled){  _dfunc()->isEnabled = enabled; invalidate(); }
 std::string Widget::internalName() const{    return _dfunc()->internalName;}
 void Widget::setInternalName( const std::string& name ){    _dfunc()->internalName = name;}
 Widget* Widget::parent() const {    return _dfunc()->parent;}
 Rect Widget::relativeRect() const{  return _dfunc()->relativeRect;}
 bool Widget::isNotClipped() const{  return _dfunc()->noClip;}
-void Widget::setVisible( bool visible ){  _dfunc()->isVisible = visible;}
+void Widget::setVisible( bool visible ){  _dfunc()->isVisible = visible; invalidate(); }
 bool Widget::isTabStop() const{  return _dfunc()->isTabStop;}
 bool Widget::hasTabgroup() const{  return _dfunc()->isTabGroup;}
-void Widget::setText( const std::string& text ){  _dfunc()->text = text;}
+void Widget::setText( const std::string& text ){  _dfunc()->text = text; invalidate(); }
 void Widget::setTooltipText( const std::string& text ) {  _dfunc()->toolTipText = text;}
 std::string Widget::text() const{  return _dfunc()->text;}
 std::string Widget::tooltipText() const{  return _dfunc()->toolTipText;}
@@ -386,6 +386,12 @@ public:
 
   void setRight(int newRight);
 
+  //! Marks the element and all its parents as needing to be redrawn
+  void invalidate();
+
+  //! Returns true if the element or one of its children changed since the last composition
+  bool isDirty() const;
+
 protected:
 
   /*!
@@ -405,6 +411,9 @@ protected:
   // not virtual because needed in constructor
   void _recalculateAbsolutePosition(bool recursive);
 
+  //! Clears the dirty flag of the element and all its children
+  void _validate();
+
   __DECLARE_IMPL(Widget)
 
   //! GUI Environment
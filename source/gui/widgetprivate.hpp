@@ -65,6 +65,9 @@ public:
   //! is visible?
   bool isVisible;
 
+  //! something inside this element changed since the last composition
+  bool dirty;
+
   std::string internalName;
 
   std::string toolTipText;
@@ -24,6 +24,7 @@
 #include "modal_widget.hpp"
 #include "gfx/decorator.hpp"
 #include "gfx/picturesarray.hpp"
+#include "environment.hpp"
 
 using namespace gfx;
 
@@ -59,8 +60,23 @@ public:
 	NColor captionColor;
 
 	FlagHolder<Window::FlagName> flags;
+
+	//! composed window, redrawn only when something inside changed
+	PictureRef cache;
 };
 
+static bool __hasUnclippedChildren( const Widget* widget )
+{
+  foreach( child, widget->children() )
+  {
+    if( (*child)->visible()
+        && ( (*child)->isNotClipped() || __hasUnclippedChildren( *child ) ) )
+      return true;
+  }
+
+  return false;
+}
+
 //! constructor
 Window::Window( Widget* parent, const Rect& rectangle, const std::string& title, int id, BackgroundType type )
 	: Widget( parent, id, rectangle ),
@@ -232,6 +248,43 @@ void Window::beforeDraw( Engine& painter )
 
 //! draws the element and its children
 void Window::draw( Engine& painter )
+{
+  // top-level windows are composed once into a texture and drawn from it
+  // until some widget inside calls invalidate(), nested windows and
+  // popups which may leave the window area are drawn directly
+  if( visible() && parent() == ui()->rootWidget()
+      && !__hasUnclippedChildren( this ) )
+  {
+    if( _d->cache && _d->cache->size() != size() )
+    {
+      _d->cache.reset();
+      invalidate();
+    }
+
+    if( !_d->cache )
+    {
+      _d->cache.reset( painter.createTarget( size() ) );
+    }
+
+    if( _d->cache )
+    {
+      if( isDirty() )
+      {
+        painter.setTarget( _d->cache.data(), absoluteRect().lefttop() );
+        _drawWindow( painter );
+        painter.setTarget( 0 );
+        _validate();
+      }
+
+      painter.draw( *_d->cache, absoluteRect().lefttop(), &absoluteClippingRectRef() );
+      return;
+    }
+  }
+
+  _drawWindow( painter );
+}
+
+void Window::_drawWindow( Engine& painter )
 {
 	if( visible() )
 	{
@@ -263,7 +316,7 @@ PushButton* Window::button(ButtonName btn) const
 }
 
 //! Set if the window background will be drawn
-void Window::setBackgroundVisible(bool draw) {	_d->flags.setFlag( fbackgroundVisible, draw ); }
+void Window::setBackgroundVisible(bool draw) {	_d->flags.setFlag( fbackgroundVisible, draw ); invalidate(); }
 
 //! Get if the window background will be drawn
 bool Window::backgroundVisible() const {	return _d->flags.isFlag( fbackgroundVisible ); }
@@ -284,6 +337,7 @@ void Window::setBackground( Picture texture )
   _d->backgroundImage = texture;
   _d->backgroundType = bgNone;
   _d->bgStyle.clear();
+  invalidate();
 }
 
 void Window::setBackground(Window::BackgroundType type)
@@ -296,6 +350,7 @@ void Window::setBackground(Window::BackgroundType type)
   case bgWhiteFrame: Decorator::draw( _d->bgStyle, Rect( 0, 0, width(), height()), Decorator::whiteFrame ); break;
   default: break;
   }
+  invalidate();
 }
 
 void Window::setModal()
@@ -85,6 +85,9 @@ protected:
 	void _init();
   virtual void _resizeEvent();
 
+  //! draws background and children without the composition cache
+  void _drawWindow( gfx::Engine& painter );
+
 private:
 	class Impl;
 	ScopedPtr<Impl> _d;
@@ -197,6 +197,7 @@ void Factory::timeStep(const unsigned long time)
     return;
   }
   
+  //daily progress was added in computeStep()
   if( _d->progress >= 100.0 )
   {
     _d->produceGood = false;
@@ -210,18 +211,6 @@ void Factory::timeStep(const unsigned long time)
       _d->store.store( tmpStock, qty );
     }
   }
-  else
-  {
-    if( _d->produceGood && GameDate::isDayChanged() )
-    {
-      //ok... factory is work, produce goods
-      float timeKoeff = _d->productionRate / 365.f;
-      float laborAccessKoeff = laborAccessPercent() / 100.f;
-      float dayProgress = productivity() * timeKoeff * laborAccessKoeff;  // work is proportional to time and factory speed
-
-      _d->progress += dayProgress;
-    }
-  }
 
   if( !_d->produceGood )
   {
@@ -240,6 +229,24 @@ void Factory::timeStep(const unsigned long time)
   }
 }
 
+void Factory::computeStep(const unsigned long time)
+{
+  WorkingBuilding::computeStep( time );
+
+  if( !mayWork() || _d->progress >= 100.0 )
+    return;
+
+  if( _d->produceGood && GameDate::isDayChanged() )
+  {
+    //ok... factory is work, produce goods
+    float timeKoeff = _d->productionRate / 365.f;
+    float laborAccessKoeff = laborAccessPercent() / 100.f;
+    float dayProgress = productivity() * timeKoeff * laborAccessKoeff;  // work is proportional to time and factory speed
+
+    _d->progress += dayProgress;
+  }
+}
+
 void Factory::deliverGood()
 {
   // make a cart pusher and send him away
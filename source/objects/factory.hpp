@@ -59,6 +59,7 @@ public:
   virtual bool standIdle() const;
 
   virtual void timeStep(const unsigned long time);
+  virtual void computeStep(const unsigned long time);
 
   virtual void save( VariantMap& stream) const;
   virtual void load( const VariantMap& stream);
@@ -78,7 +78,7 @@ public:
   int changeCondition;
 
 public:
-  void updateHealthLevel( HousePtr house );
+  void updateHealthLevel( House& house );
   void initGoodStore( int size );
   void consumeServices();
   void consumeGoods(HousePtr house);
@@ -381,13 +381,6 @@ void House::timeStep(const unsigned long time)
     _d->taxesThisYear = 0;
   }
 
-  if( time % spec().getServiceConsumptionInterval() == 0 )
-  {
-    _d->consumeServices();
-    _d->updateHealthLevel( this );
-    cancelService( Service::recruter );
-  }
-
   if( time % spec().foodConsumptionInterval() == 0 )
   {
     _d->consumeFoods( this );
@@ -420,6 +413,22 @@ void House::timeStep(const unsigned long time)
   Building::timeStep( time );
 }
 
+void House::computeStep(const unsigned long time)
+{
+  Building::computeStep( time );
+
+  if( _d->habitants.empty() )
+    return;
+
+  // services decay touches only own state, so it runs in parallel phase
+  if( time % spec().getServiceConsumptionInterval() == 0 )
+  {
+    _d->consumeServices();
+    _d->updateHealthLevel( *this );
+    cancelService( Service::recruter );
+  }
+}
+
 bool House::_tryEvolve_1_to_12_lvl( int level4grow, int growSize, const char desirability )
 {
   city::Helper helper( _city() );
@@ -1329,7 +1338,7 @@ std::string House::levelName() const
   return ret;
 }
 
-void House::Impl::updateHealthLevel( HousePtr house )
+void House::Impl::updateHealthLevel( House& house )
 {
   float delim = 1 + (((services[Service::well] > 0 || services[Service::fountain] > 0) ? 1 : 0))
       + ((services[Service::doctor] > 0 || services[Service::hospital] > 0) ? 1 : 0)
@@ -1338,7 +1347,7 @@ void House::Impl::updateHealthLevel( HousePtr house )
 
   float decrease = 2.f / delim;
 
-  house->updateState( (Construction::Param)House::health, -decrease );
+  house.updateState( (Construction::Param)House::health, -decrease );
 }
 
 void House::Impl::initGoodStore(int size)
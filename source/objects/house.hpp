@@ -52,6 +52,7 @@ public:
   House( HouseLevel::ID level=HouseLevel::vacantLot );
 
   virtual void timeStep(const unsigned long time);
+  virtual void computeStep(const unsigned long time);
 
   virtual GoodStore& goodStore();
 
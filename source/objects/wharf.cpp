@@ -141,7 +141,7 @@ std::string Wharf::troubleDesc() const
 {
   if( _d->boat.isValid() )
   {
-    WalkerList places = _city()->walkers( walker::fishPlace );
+    const WalkerList& places = _city()->walkers( walker::fishPlace );
     if( places.empty() )
     {
       return "##no_fishplace_in_city##";
@@ -171,6 +171,11 @@ void WorkingBuilding::timeStep( const unsigned long time )
 
     _d->laborAccessKoeff = math::clamp( math::percentage( averageDistance, 8 ) * 2, 25, 100 );
   }
+}
+
+void WorkingBuilding::computeStep( const unsigned long time )
+{
+  Building::computeStep( time );
 
   _updateAnimation( time );
 }
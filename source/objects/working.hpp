@@ -49,6 +49,7 @@ public:
   virtual void burn();
 
   virtual void timeStep(const unsigned long time);
+  virtual void computeStep(const unsigned long time);
 
   virtual void save( VariantMap& stream) const;
   virtual void load( const VariantMap& stream);
@@ -224,14 +224,14 @@ bool Pathfinder::Impl::aStar( const TilePos& startPos, TilesArray arrivedArea, P
 {
   if( arrivedArea.empty() )
   {
-    Logger::warning( "AStarPathfinder: no arrived area" );
+    CAESARIA_LOG_DEBUG( "AStarPathfinder: no arrived area" );
     return false;
   }  
 
   AStarPoint* ap = at( startPos );
   if( !ap || !ap->tile )
   {
-    Logger::warning( "AStarPathfinder: wrong start pos at %d,%d", startPos.i(), startPos.j()  );
+    CAESARIA_LOG_DEBUG( "AStarPathfinder: wrong start pos at %d,%d", startPos.i(), startPos.j()  );
     return false;
   }
 
@@ -387,7 +387,7 @@ bool Pathfinder::Impl::aStar( const TilePos& startPos, TilesArray arrivedArea, P
   {
     if( verbose > 0 )
     {
-      Logger::warning( "AStarPathfinder: maxLoopCount reached from [%d,%d] to [%d,%d]",
+      CAESARIA_LOG_DEBUG( "AStarPathfinder: maxLoopCount reached from [%d,%d] to [%d,%d]",
                      startPos.i(), startPos.j(), endPoints.front()->getPos().i(), endPoints.front()->getPos().j() );
       Stacktrace::print();
     }
@@ -22,11 +22,12 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <list>
 #include <SDL.h>
 #include <SDL_mixer.h>
 #include "game/settings.hpp"
 #include "core/exception.hpp"
-#include "thread/mutex.hpp"
+#include "thread/thread.hpp"
 #include "core/logger.hpp"
 #include "core/foreach.hpp"
 #include "core/stringhelper.hpp"
@@ -41,6 +42,76 @@ static void _resolveChannelFinished( int channel )
 namespace audio
 {
 
+namespace {
+static const unsigned int maxCacheSize = 24 * 1024 * 1024;
+}
+
+//sdl_mixer reads music from vfs file by parts, while playing
+static Sint64 SDLCALL _rwSize( SDL_RWops* ctx )
+{
+  vfs::NFile* file = (vfs::NFile*)ctx->hidden.unknown.data1;
+  return file->size();
+}
+
+static Sint64 SDLCALL _rwSeek( SDL_RWops* ctx, Sint64 offset, int whence )
+{
+  vfs::NFile* file = (vfs::NFile*)ctx->hidden.unknown.data1;
+  long pos = (long)offset;
+  switch( whence )
+  {
+  case RW_SEEK_CUR: pos += file->getPos(); break;
+  case RW_SEEK_END: pos += file->size(); break;
+  default: break;
+  }
+
+  return file->seek( pos ) ? file->getPos() : -1;
+}
+
+static size_t SDLCALL _rwRead( SDL_RWops* ctx, void* ptr, size_t size, size_t maxnum )
+{
+  vfs::NFile* file = (vfs::NFile*)ctx->hidden.unknown.data1;
+  if( size == 0 )
+    return 0;
+
+  int readed = file->read( ptr, size * maxnum );
+  return readed > 0 ? readed / size : 0;
+}
+
+static size_t SDLCALL _rwWrite( SDL_RWops*, const void*, size_t, size_t ) { return 0; }
+
+static int SDLCALL _rwClose( SDL_RWops* ctx )
+{
+  delete (vfs::NFile*)ctx->hidden.unknown.data1;
+  SDL_FreeRW( ctx );
+  return 0;
+}
+
+static SDL_RWops* _createStreamRW( const vfs::Path& filename )
+{
+  vfs::NFile* file = new vfs::NFile( vfs::NFile::open( filename ) );
+  if( !file->isOpen() )
+  {
+    delete file;
+    return 0;
+  }
+
+  SDL_RWops* rw = SDL_AllocRW();
+  if( !rw )
+  {
+    delete file;
+    return 0;
+  }
+
+  rw->size = _rwSize;
+  rw->seek = _rwSeek;
+  rw->read = _rwRead;
+  rw->write = _rwWrite;
+  rw->close = _rwClose;
+  rw->hidden.unknown.data1 = file;
+
+  return rw;
+}
+
 struct Sample
 {
   int channel;
@@ -51,21 +122,73 @@ struct Sample
   Mix_Chunk* chunk;
 };
 
+struct CachedChunk
+{
+  Mix_Chunk* chunk;
+  unsigned int size;
+  unsigned int lastUse;
+};
+
+struct PendingPlay
+{
+  int volume;
+  audio::SoundType type;
+};
+
+//file is read on main thread, because vfs is not thread safe, loader only decodes it
+class SampleLoader : public CTask
+{
+public:
+  vfs::Path filename;
+  ByteArray data;
+  Mix_Chunk* chunk;
+  bool needPlay;
+  PendingPlay play;
+
+  SampleLoader( const vfs::Path& path, const ByteArray& bytes )
+    : filename( path ), data( bytes ), chunk( 0 ), needPlay( false ) {}
+
+  virtual bool task()
+  {
+    if( !data.empty() )
+    {
+      chunk = Mix_LoadWAV_RW( SDL_RWFromMem( data.data(), data.size() ), 1 );
+    }
+
+    data.clear();
+    return true;
+  }
+};
+
 class Engine::Impl
 {
 public:
-  static const int maxSamplesNumner = 64;
   bool useSound;
 
   typedef std::map< std::string, Sample > Samples;
+  typedef std::map< std::string, CachedChunk > Chunks;
+  typedef std::list< SampleLoader* > Loaders;
   typedef std::map< audio::SoundType, int > Volumes;
   Samples samples;
+  Chunks chunks;
+  Loaders loaders;
   Volumes volumes;
+  unsigned int cacheSize;
+  unsigned int useCounter;
+  ThreadPtr loaderThread;
+
+  Mix_Music* music;
   vfs::Path currentTheme;
+  int themeVolume;
 
 public:
   void clearFinishedChannels();
   void checkFilename( vfs::Path& path );
+  void updateLoaders();
+  void freeChunks( unsigned int needSize );
+  bool isChunkPlaying( const std::string& name ) const;
+  SampleLoader* findLoader( const std::string& name ) const;
+  void stopMusic();
 };
 
 Engine& Engine::instance()
@@ -91,6 +214,10 @@ int Engine::maxVolumeValue() const {  return 100; }
 Engine::Engine() : _d( new Impl )
 {
   _d->useSound = false;
+  _d->cacheSize = 0;
+  _d->useCounter = 0;
+  _d->music = 0;
+  _d->themeVolume = 0;
   _d->volumes[ gameSound ] = maxVolumeValue();
   _d->volumes[ themeSound ] = maxVolumeValue() / 2;
   _d->volumes[ ambientSound ] = maxVolumeValue() / 4;
@@ -134,6 +261,10 @@ void Engine::init()
 
         Logger::warning( "Game: bind ChannelFinished" );
         Mix_ChannelFinished( &_resolveChannelFinished );
+
+        Logger::warning( "Game: start sound loader thread" );
+        _d->loaderThread = ThreadPtr( new Thread() );
+        _d->loaderThread->drop();
       }
       else
       {
@@ -160,95 +291,184 @@ void Engine::init()
 
 void Engine::exit()
 {
+  bool loaderStopped = true;
+  if( _d->loaderThread.isValid() )
+  {
+    loaderStopped = _d->loaderThread->Stop();
+  }
+
+  foreach( it, _d->loaders )
+  {
+    // if thread did not stop in time, it can still reach queued loaders
+    if( !loaderStopped && (*it)->getStatus() != TaskStatusCompleted )
+    {
+      Logger::warning( "SoundEngine: loader thread still works with " + (*it)->filename.toString() );
+      continue;
+    }
+
+    if( (*it)->chunk ) { Mix_FreeChunk( (*it)->chunk ); }
+    delete *it;
+  }
+
+  _d->loaders.clear();
+  _d->stopMusic();
+  Mix_HaltChannel( -1 );
+
+  foreach( it, _d->chunks ) { Mix_FreeChunk( it->second.chunk ); }
+  _d->chunks.clear();
+  _d->samples.clear();
+  _d->cacheSize = 0;
+
   Mix_CloseAudio();
 }
 
+void Engine::update()
+{
+  if( _d->useSound )
+  {
+    _d->updateLoaders();
+  }
+}
+
 bool Engine::_loadSound(vfs::Path filename)
 {
-  if(_d->useSound && _d->samples.size()<Impl::maxSamplesNumner)
+  if( !_d->useSound )
+    return false;
+
+  std::string name = filename.toString();
+  Impl::Chunks::iterator i = _d->chunks.find( name );
+
+  if( i != _d->chunks.end() )
   {
-    Impl::Samples::iterator i = _d->samples.find( filename.toString() );    
+    i->second.lastUse = ++_d->useCounter;
+    return true;
+  }
 
-    if( i != _d->samples.end() )
-    {
-      return true;
-    }
+  //sample already loading
+  if( _d->findLoader( name ) != 0 )
+    return false;
 
-    if( !filename.exist() )
-    {
-      return false;
-    }
+  vfs::NFile soundFile = vfs::NFile::open( filename );
+  if( !soundFile.isOpen() )
+  {
+    return false;
+  }
 
-    Sample sample;
+  SampleLoader* loader = new SampleLoader( filename, soundFile.readAll() );
+  if( !_d->loaderThread.isValid() || !_d->loaderThread->Event( loader ) )
+  {
+    Logger::warning( "SoundEngine: can't start loading sound " + name );
+    delete loader;
+    return false;
+  }
 
-    /* load the sample */
-    vfs::NFile soundFile = vfs::NFile::open( filename );
-    ByteArray data = soundFile.readAll();
+  _d->loaders.push_back( loader );
+  return false;
+}
 
-    if( data.empty() )
-    {
-      return false;
-    }
+void Engine::preload( vfs::Path filename )
+{
+  if( !_d->useSound )
+    return;
 
-    sample.channel = -1;
-    sample.chunk = Mix_LoadWAV_RW( SDL_RWFromMem( data.data(), data.size() ), 1 );
-    sample.sound = filename.toString();
-    if(sample.chunk == NULL)
-    {
-      Logger::warning( "SoundEngine: could not load sound (%s)", SDL_GetError() );
-      return false;
-    }
+  _d->checkFilename( filename );
+  _loadSound( filename );
+}
+
+void Engine::preload( std::string rc, int index )
+{
+  preload( StringHelper::format( 0xff, "%s_%05d.ogg", rc.c_str(), index ) );
+}
 
-    _d->samples[ filename.toString() ] = sample;
+int Engine::_playMusic( vfs::Path filename, int volValue )
+{
+  if( filename.toString() == _d->currentTheme.toString() && Mix_PlayingMusic() > 0 )
+  {
+    _d->themeVolume = volValue;
+    _updateSamplesVolume();
+    return 0;
   }
 
-  return true;
+  _d->stopMusic();
+
+  SDL_RWops* rw = _createStreamRW( filename );
+  if( !rw )
+  {
+    return -1;
+  }
+
+  _d->music = Mix_LoadMUS_RW( rw, 1 );
+  if( !_d->music )
+  {
+    Logger::warning( "SoundEngine: could not open music (%s)", SDL_GetError() );
+    return -1;
+  }
+
+  _d->currentTheme = filename;
+  _d->themeVolume = volValue;
+  _updateSamplesVolume();
+  Mix_PlayMusic( _d->music, 0 );
+
+  return 0;
 }
 
 int Engine::play( vfs::Path filename, int volValue, SoundType type )
 {
   if(_d->useSound )
   {
+    _d->updateLoaders();
     _d->clearFinishedChannels();
     _d->checkFilename( filename );
 
     if( type == themeSound )
     {
-      stop( _d->currentTheme );
-      _d->currentTheme = filename;
+      return _playMusic( filename, volValue );
     }
 
     bool isLoading = _loadSound( filename );   
 
-    if( isLoading )
+    if( !isLoading )
     {
-      Impl::Samples::iterator i = _d->samples.find( filename.toString() );
-
-      if( i == _d->samples.end() )
+      //sample will be played when loader finish work
+      SampleLoader* loader = _d->findLoader( filename.toString() );
+      if( loader )
       {
-        return -1;
+        loader->needPlay = true;
+        loader->play.volume = volValue;
+        loader->play.type = type;
       }
 
-      if( (i->second.channel == -1 )
-          || (i->second.channel >= 0 && Mix_Playing( i->second.channel ) <= 0) )
-      {
-
-        // sdl_mixer finds free channel, we then play at correct volume
-        i->second.channel = Mix_PlayChannel(-1, i->second.chunk, 0);
-      }
+      return -1;
+    }
 
-      i->second.typeSound = type;
-      i->second.volume = volValue;
-      i->second.finished = false;
+    std::string name = filename.toString();
+    Sample& sample = _d->samples[ name ];
+    if( sample.sound.empty() )
+    {
+      sample.channel = -1;
+      sample.sound = name;
+    }
 
-      float result = math::clamp( volValue, 0, maxVolumeValue() ) / 100.f;
-      float typeVolume = volume( type ) / 100.f;
-      float gameVolume = volume( audio::gameSound ) / 100.f;
+    sample.chunk = _d->chunks[ name ].chunk;
 
-      result = ( result * typeVolume * gameVolume ) * (2 * MIX_MAX_VOLUME);
-      Mix_Volume( i->second.channel, (int)result);
-      return i->second.channel;
+    if( (sample.channel == -1 )
+        || (sample.channel >= 0 && Mix_Playing( sample.channel ) <= 0) )
+    {
+      // sdl_mixer finds free channel, we then play at correct volume
+      sample.channel = Mix_PlayChannel(-1, sample.chunk, 0);
     }
+
+    sample.typeSound = type;
+    sample.volume = volValue;
+    sample.finished = false;
+
+    float result = math::clamp( volValue, 0, maxVolumeValue() ) / 100.f;
+    float typeVolume = volume( type ) / 100.f;
+    float gameVolume = volume( audio::gameSound ) / 100.f;
+
+    result = ( result * typeVolume * gameVolume ) * (2 * MIX_MAX_VOLUME);
+    Mix_Volume( sample.channel, (int)result);
+    return sample.channel;
   }
 
   return -1;
@@ -266,6 +486,11 @@ bool Engine::isPlaying(vfs::Path filename) const
     return false;
 
   _d->checkFilename( filename );
+  if( filename.toString() == _d->currentTheme.toString() )
+  {
+    return Mix_PlayingMusic() > 0;
+  }
+
   Impl::Samples::iterator i = _d->samples.find( filename.toString() );
 
   if( i == _d->samples.end() )
@@ -281,6 +506,12 @@ void Engine::stop( vfs::Path filename )
   if( !_d->useSound )
     return;
 
+  if( filename.toString() == _d->currentTheme.toString() )
+  {
+    _d->stopMusic();
+    return;
+  }
+
   Impl::Samples::iterator i = _d->samples.find( filename.toString() );
 
   if( i == _d->samples.end() )
@@ -324,6 +555,13 @@ void Engine::_updateSamplesVolume()
       Mix_Volume( sample.channel, (int)result );
     }
   }
+
+  float result = math::clamp<int>( _d->themeVolume, 0, maxVolumeValue() ) / 100.f;
+  float typeVolume = volume( audio::themeSound ) / 100.f;
+  float gameVolume = volume( audio::gameSound ) / 100.f;
+
+  result = ( result * typeVolume * gameVolume ) * ( 2 * MIX_MAX_VOLUME );
+  Mix_VolumeMusic( math::clamp<int>( (int)result, 0, MIX_MAX_VOLUME ) );
 }
 
 void Helper::initTalksArchive(const vfs::Path& filename)
@@ -338,12 +576,11 @@ void Helper::initTalksArchive(const vfs::Path& filename)
 
 void Engine::Impl::clearFinishedChannels()
 {
+  //chunks stay in cache, they will be freed when cache is full
   for( Samples::iterator it=samples.begin(); it != samples.end();  )
   {
     if( it->second.finished )
     {
-      Mix_FreeChunk( it->second.chunk );
-
       samples.erase( it++ );
     }
     else
@@ -353,6 +590,109 @@ void Engine::Impl::clearFinishedChannels()
   }
 }
 
+void Engine::Impl::updateLoaders()
+{
+  typedef std::pair< std::string, PendingPlay > PlayInfo;
+  std::vector< PlayInfo > needPlay;
+
+  for( Loaders::iterator it=loaders.begin(); it != loaders.end(); )
+  {
+    SampleLoader* loader = *it;
+    if( loader->getStatus() != TaskStatusCompleted )
+    {
+      ++it;
+      continue;
+    }
+
+    std::string name = loader->filename.toString();
+    if( loader->chunk != 0 )
+    {
+      CachedChunk cached;
+      cached.chunk = loader->chunk;
+      cached.size = loader->chunk->alen;
+      cached.lastUse = ++useCounter;
+
+      freeChunks( cached.size );
+      chunks[ name ] = cached;
+      cacheSize += cached.size;
+    }
+    else
+    {
+      Logger::warning( "SoundEngine: could not load sound " + name );
+    }
+
+    if( loader->needPlay && loader->chunk != 0 )
+    {
+      needPlay.push_back( PlayInfo( name, loader->play ) );
+    }
+
+    it = loaders.erase( it );
+    delete loader;
+  }
+
+  foreach( it, needPlay )
+  {
+    Engine::instance().play( it->first, it->second.volume, it->second.type );
+  }
+}
+
+void Engine::Impl::freeChunks( unsigned int needSize )
+{
+  while( cacheSize + needSize > maxCacheSize )
+  {
+    //find least recently used chunk, which is not playing now
+    Chunks::iterator lru = chunks.end();
+    foreach( it, chunks )
+    {
+      if( isChunkPlaying( it->first ) )
+        continue;
+
+      if( lru == chunks.end() || it->second.lastUse < lru->second.lastUse )
+        lru = it;
+    }
+
+    if( lru == chunks.end() )
+      return;
+
+    samples.erase( lru->first );
+    cacheSize -= lru->second.size;
+    Mix_FreeChunk( lru->second.chunk );
+    chunks.erase( lru );
+  }
+}
+
+bool Engine::Impl::isChunkPlaying( const std::string& name ) const
+{
+  Samples::const_iterator it = samples.find( name );
+  if( it == samples.end() )
+    return false;
+
+  return it->second.channel >= 0 && Mix_Playing( it->second.channel ) > 0;
+}
+
+SampleLoader* Engine::Impl::findLoader( const std::string& name ) const
+{
+  foreach( it, loaders )
+  {
+    if( (*it)->filename.toString() == name )
+      return *it;
+  }
+
+  return 0;
+}
+
+void Engine::Impl::stopMusic()
+{
+  if( music )
+  {
+    Mix_HaltMusic();
+    Mix_FreeMusic( music );
+    music = 0;
+  }
+
+  currentTheme = vfs::Path();
+}
+
 void Engine::Impl::checkFilename(vfs::Path& path)
 {
   std::string ext = path.extension().empty() ? ".ogg" : "";
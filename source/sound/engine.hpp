@@ -46,6 +46,13 @@ public:
   int play( vfs::Path filename, int volume, SoundType type );
   int play( std::string rc, int index, int volume, SoundType type );
 
+  //! start loading sample in background, so next play() will not wait decoding
+  void preload( vfs::Path filename );
+  void preload( std::string rc, int index );
+
+  //! take samples which loaded in background
+  void update();
+
   bool isPlaying( vfs::Path filename ) const;
 
   void stop( vfs::Path filename );
@@ -53,6 +60,7 @@ public:
 private:
   Engine();
   bool _loadSound( vfs::Path filename );
+  int _playMusic( vfs::Path filename, int volValue );
   void _updateSamplesVolume();
 
   class Impl;
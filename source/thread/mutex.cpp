@@ -83,6 +83,30 @@ void Mutex::lock()
 
 }
 
+/**
+ *
+ * TryLock
+ * locks the mutex only if it is free,
+ * returns false instead of waiting
+ *
+ **/
+bool Mutex::tryLock()
+{
+	ThreadID id = Thread::getID();
+	if( Thread::ThreadIdsEqual(&m_owner,&id) )
+		return false;
+
+#ifdef CAESARIA_PLATFORM_WIN
+	if( WaitForSingleObject(m_mutex,0) != WAIT_OBJECT_0 )
+		return false;
+#else
+	if( pthread_mutex_trylock(&m_mutex) != 0 )
+		return false;
+#endif
+	m_owner = id;
+	return true;
+}
+
 /**
  *
  * Unlock
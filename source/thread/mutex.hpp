@@ -40,6 +40,7 @@ public:
 	bool m_bCreated;
 
 	void lock();
+	bool tryLock();
 	void unlock();
 
 	Mutex(void);
@@ -150,7 +150,7 @@ bool Thread::FromSameThread()
  **/
 bool Thread::OnTask( void* lpvData )
 {
-	_CAESARIA_DEBUG_BREAK_IF(lpvData && m_type == ThreadTypeHomogeneous);
+	_CAESARIA_DEBUG_BREAK_IF(!lpvData || m_type != ThreadTypeHomogeneous);
 
 	if( m_type != ThreadTypeHomogeneous )
 	{
@@ -200,8 +200,8 @@ bool Thread::Event(CTask *pvTask )
 {
 	m_mutex.lock();
 
-	_CAESARIA_DEBUG_BREAK_IF(m_type == ThreadTypeHomogeneous ||
-													 m_type == ThreadTypeNotDefined );
+	_CAESARIA_DEBUG_BREAK_IF(m_type == ThreadTypeSpecialized ||
+													 m_type == ThreadTypeIntervalDriven );
 
 	try 
 	{
@@ -0,0 +1,274 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "workerpool.hpp"
+#include "thread.hpp"
+#include "core/foreach.hpp"
+
+#include <algorithm>
+
+#ifdef CAESARIA_PLATFORM_UNIX
+  #include <unistd.h>
+#endif
+
+#ifndef CAESARIA_PLATFORM_WIN
+  #include <pthread.h>
+#endif
+
+namespace
+{
+static const int maxWorkers = 7;
+
+int cpuCount()
+{
+#ifdef CAESARIA_PLATFORM_WIN
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  return info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  return sysconf( _SC_NPROCESSORS_ONLN );
+#else
+  return 1;
+#endif
+}
+
+// counter of jobs given to workers, calling thread sleeps in wait()
+// until last worker calls done()
+class Countdown
+{
+public:
+  Countdown();
+  ~Countdown();
+
+  void add();
+  void done();
+  void wait();
+
+private:
+  int _count;
+#ifdef CAESARIA_PLATFORM_WIN
+  Mutex _mutex;
+  HANDLE _ready;
+#else
+  pthread_mutex_t _mutex;
+  pthread_cond_t _ready;
+#endif
+};
+
+#ifdef CAESARIA_PLATFORM_WIN
+Countdown::Countdown() : _count( 0 ) { _ready = CreateEvent( NULL, FALSE, FALSE, NULL ); }
+Countdown::~Countdown() { CloseHandle( _ready ); }
+
+void Countdown::add()
+{
+  MutexLocker locker( &_mutex );
+  _count++;
+}
+
+void Countdown::done()
+{
+  MutexLocker locker( &_mutex );
+  if( --_count == 0 )
+    SetEvent( _ready );
+}
+
+void Countdown::wait()
+{
+  while( true )
+  {
+    _mutex.lock();
+    int count = _count;
+    _mutex.unlock();
+
+    if( count == 0 )
+      return;
+
+    // event may stay signaled from previous batch, counter is checked again
+    WaitForSingleObject( _ready, INFINITE );
+  }
+}
+#else
+Countdown::Countdown() : _count( 0 )
+{
+  pthread_mutex_init( &_mutex, NULL );
+  pthread_cond_init( &_ready, NULL );
+}
+
+Countdown::~Countdown()
+{
+  pthread_cond_destroy( &_ready );
+  pthread_mutex_destroy( &_mutex );
+}
+
+void Countdown::add()
+{
+  pthread_mutex_lock( &_mutex );
+  _count++;
+  pthread_mutex_unlock( &_mutex );
+}
+
+void Countdown::done()
+{
+  pthread_mutex_lock( &_mutex );
+  if( --_count == 0 )
+    pthread_cond_signal( &_ready );
+  pthread_mutex_unlock( &_mutex );
+}
+
+void Countdown::wait()
+{
+  pthread_mutex_lock( &_mutex );
+  while( _count > 0 )
+    pthread_cond_wait( &_ready, &_mutex );
+  pthread_mutex_unlock( &_mutex );
+}
+#endif
+
+// task status is changed by thread after job was taken from queue,
+// so completion is counted here
+class PoolTask : public CTask
+{
+public:
+  CTask* job;
+  Countdown* pending;
+
+  virtual bool task()
+  {
+    job->task();
+    pending->done();
+    return true;
+  }
+};
+
+}
+
+class WorkerPool::Impl
+{
+public:
+  struct Posted
+  {
+    CTask* task;
+    unsigned int worker;
+  };
+
+  std::vector< ThreadPtr > workers;
+  std::vector< PoolTask* > queued;
+  std::vector< Posted > posted;  // background tasks which are not completed yet
+  Countdown pending;
+
+  void updatePosted();
+};
+
+void WorkerPool::Impl::updatePosted()
+{
+  for( std::vector< Posted >::iterator it=posted.begin(); it != posted.end(); )
+  {
+    if( it->task->getStatus() == TaskStatusCompleted ) { it = posted.erase( it ); }
+    else { ++it; }
+  }
+}
+
+WorkerPool& WorkerPool::instance()
+{
+  static WorkerPool inst;
+  return inst;
+}
+
+WorkerPool::WorkerPool() : _d( new Impl )
+{
+  int count = std::min( cpuCount() - 1, maxWorkers );
+  for( int k=0; k < count; k++ )
+  {
+    ThreadPtr worker( new Thread() );
+    worker->drop();
+    _d->workers.push_back( worker );
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  foreach( it, _d->queued ) { delete *it; }
+}
+
+unsigned int WorkerPool::concurrency() const { return _d->workers.size() + 1; }
+
+void WorkerPool::execute( const Tasks& tasks )
+{
+  if( tasks.empty() )
+    return;
+
+  // workers with background tasks may be busy for long time
+  _d->updatePosted();
+  std::vector< unsigned int > freeWorkers;
+  for( unsigned int k=0; k < _d->workers.size(); k++ )
+  {
+    bool busy = false;
+    foreach( it, _d->posted ) { busy |= (it->worker == k); }
+
+    if( !busy )
+      freeWorkers.push_back( k );
+  }
+
+  const unsigned int workersCount = freeWorkers.size();
+  // every concurrency-th task stays on calling thread
+  const unsigned int step = workersCount + 1;
+
+  while( _d->queued.size() < tasks.size() )
+    _d->queued.push_back( new PoolTask() );
+
+  for( unsigned int k=0; k < tasks.size(); k++ )
+  {
+    unsigned int worker = k % step;
+    if( worker == workersCount )
+      continue;
+
+    PoolTask& ptask = *_d->queued[ k ];
+    ptask.job = tasks[ k ];
+    ptask.pending = &_d->pending;
+    _d->pending.add();
+
+    if( !_d->workers[ freeWorkers[ worker ] ]->Event( &ptask ) )
+    {
+      // worker is not running, do job here
+      ptask.task();
+    }
+  }
+
+  for( unsigned int k=workersCount; k < tasks.size(); k += step )
+  {
+    tasks[ k ]->task();
+  }
+
+  _d->pending.wait();
+}
+
+bool WorkerPool::post( CTask* task )
+{
+  if( _d->workers.empty() )
+    return false;
+
+  // worker with less background tasks
+  _d->updatePosted();
+  std::vector< int > load( _d->workers.size(), 0 );
+  foreach( it, _d->posted ) { load[ it->worker ]++; }
+
+  unsigned int worker = std::min_element( load.begin(), load.end() ) - load.begin();
+  if( !_d->workers[ worker ]->Event( task ) )
+    return false;
+
+  Impl::Posted info = { task, worker };
+  _d->posted.push_back( info );
+  return true;
+}
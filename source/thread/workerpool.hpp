@@ -0,0 +1,52 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef _CAESARIA_WORKERPOOL_H_INCLUDE_
+#define _CAESARIA_WORKERPOOL_H_INCLUDE_
+
+#include "threadtask.hpp"
+#include "core/scopedptr.hpp"
+
+#include <vector>
+
+// fixed set of worker threads for short jobs inside one game frame,
+// calling thread takes part in work and waits while all jobs are done.
+// Long background jobs may be posted too, frame jobs skip workers busy with them
+class WorkerPool
+{
+public:
+  typedef std::vector< CTask* > Tasks;
+
+  static WorkerPool& instance();
+
+  //! number of threads which execute tasks, including the calling one
+  unsigned int concurrency() const;
+
+  //! runs every task and returns when all of them are completed
+  void execute( const Tasks& tasks );
+
+  //! gives task to worker and returns at once, task must live until its status
+  //! is TaskStatusCompleted. Returns false when there are no workers
+  bool post( CTask* task );
+
+  ~WorkerPool();
+private:
+  WorkerPool();
+
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //_CAESARIA_WORKERPOOL_H_INCLUDE_
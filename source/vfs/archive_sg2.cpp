@@ -19,16 +19,23 @@
 
 #include "core/stringhelper.hpp"
 #include "core/logger.hpp"
-#include "gfx/picture.hpp"
-#include "gfx/engine.hpp"
-#include "gfx/pictureconverter.hpp"
 #include "filenative_impl.hpp"
 #include "core/rectangle.hpp"
 #include "core/color.hpp"
 #include "vfs/directory.hpp"
 #include "vfs/memfile.hpp"
+#include "vfs/mappedfile.hpp"
+#include "core/foreach.hpp"
+#include "core/math.hpp"
+#include "gfx/loader_raw.hpp"
+#include "thread/thread.hpp"
 
 #include <sstream>
+#include <algorithm>
+#include <vector>
+#include <set>
+#include <sys/stat.h>
+#include <SDL.h>
 #include <iomanip>
 #include <iostream>
 
@@ -52,8 +59,140 @@ enum {
 
 namespace {
 static const std::string readerTypename=CAESARIA_STR_EXT(Sg2ArchiveReader);
+
+unsigned int convert555toRGBA( unsigned short color )
+{
+  if(color == 0xf81f)
+  {
+    return 0;
+  }
+
+  NColor rgb( 0xff000000 );
+
+  // Red: bits 11-15, should go to bits 17-24
+  unsigned int red = ((color & 0x7c00) << 9) | ((color & 0x7000) << 4);
+
+  // Green: bits 6-10, should go to bits 9-16
+  unsigned int green = ((color & 0x3e0) << 6) | ((color & 0x300));
+
+  // Blue: bits 1-5, should go to bits 1-8
+  unsigned int blue = ((color & 0x1f) << 3) | ((color & 0x1c) >> 2);
+
+  rgb.setRed( (red >> 16) & 0xff );
+  rgb.setGreen( (green >> 8) & 0xff );
+  rgb.setBlue( blue & 0xff );
+
+  return rgb.abgr();
 }
 
+//all 555 colors converted once, decoding is a table lookup per pixel
+const unsigned int* colorTable()
+{
+  static std::vector<unsigned int> table;
+  if( table.empty() )
+  {
+    table.resize( 0x10000 );
+    for( unsigned int color=0; color < 0x10000; color++ )
+      table[ color ] = convert555toRGBA( color );
+  }
+
+  return &table[0];
+}
+
+inline void convertRow( unsigned int* dst, const unsigned char* src, int count, const unsigned int* table )
+{
+  for( int k=0; k < count; k++, src += 2 )
+    dst[ k ] = table[ src[0] | (src[1] << 8) ];
+}
+
+static const unsigned int cacheVersion = 1;
+static const unsigned int cachePageSize = 4096;
+static const unsigned int imagesPerTask = 256;
+static const int maxDecodeThreads = 4;
+static Path cacheFolder;
+
+void addFileStamp( const Path& path, unsigned int& size, unsigned int& time )
+{
+  struct stat st;
+  if( ::stat( path.toString().c_str(), &st ) == 0 )
+  {
+    size += (unsigned int)st.st_size;
+    time = std::max<unsigned int>( time, (unsigned int)st.st_mtime );
+  }
+}
+
+inline unsigned int imageBytes( const SgImageRecord& sr )
+{
+  return sizeof(RawPictureHeader) + std::max<int>( sr.width, 0 ) * std::max<int>( sr.height, 0 ) * 4;
+}
+}
+
+//pixels of decoding image, surface format
+struct SgCanvas
+{
+  unsigned int* pixels;
+  int width;
+  int height;
+};
+
+//cache file: header, entries sorted by name hash, names, page aligned data with raw pictures
+struct SgCacheHeader
+{
+  char magic[4];
+  unsigned int version;
+  unsigned int sgSize;    // sg2 file size and modify time
+  unsigned int sgTime;
+  unsigned int dataSize;  // summary size and last modify time of .555 files
+  unsigned int dataTime;
+  unsigned int count;
+  unsigned int strings;   // offset of names
+  unsigned int data;      // offset of pictures, page aligned
+};
+
+struct SgCacheEntry
+{
+  unsigned int hash;
+  unsigned int name;      // offset from names start
+  unsigned int offset;    // offset from file start
+  unsigned int length;
+};
+
+inline bool cacheEntryLess( const SgCacheEntry& a, const SgCacheEntry& b ) { return a.hash < b.hash; }
+
+//decodes range of archive images to raw pictures on worker thread
+class SgDecodeTask : public CTask
+{
+public:
+  typedef std::vector< const SgFileEntry* > Items;
+
+  Sg2ArchiveReader* reader;
+  Items items;
+  ByteArray data;
+
+  virtual bool task()
+  {
+    unsigned int length = 0;
+    foreach( it, items ) { length += imageBytes( (*it)->sr ); }
+
+    data.resize( length );
+    char* ptr = data.data();
+    foreach( it, items )
+    {
+      RawPictureHeader* header = (RawPictureHeader*)ptr;
+      memcpy( header->magic, RawPictureHeader::signature(), 4 );
+      header->width = std::max<int>( (*it)->sr.width, 0 );
+      header->height = std::max<int>( (*it)->sr.height, 0 );
+
+      SgCanvas canvas = { (unsigned int*)(ptr + sizeof(RawPictureHeader)), (int)header->width, (int)header->height };
+      reader->_decodeImage( canvas, **it );
+
+      ptr += imageBytes( (*it)->sr );
+    }
+
+    return true;
+  }
+};
+
 Sg2ArchiveLoader::Sg2ArchiveLoader(vfs::FileSystem*)
 {
 }
@@ -111,7 +250,7 @@ ArchivePtr Sg2ArchiveLoader::createArchive(NFile file, bool ignoreCase, bool ign
   return archive;
 }
 
-Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _file( file )
+Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _cache( 0 ), _file( file )
 {
   SgHeader header;
   file.seek(0);
@@ -121,6 +260,12 @@ Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _file( file )
   Logger::warning( "Read header, num bitmaps = %d, num images = %d",
                    header.num_bitmap_records, header.num_image_records);
 
+  //555 file name is resolved once per bitmap source, not for every image
+  std::map<std::string, Path> resolved555;
+  Path own555 = file.path().changeExtension( ".555" );
+  if( !own555.exist() )
+    own555 = Path();
+
   // Read bitmaps
   for( int bn = 0; bn < header.num_bitmap_records; ++bn)
   {
@@ -153,24 +298,27 @@ Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _file( file )
       Path p555;
       if( sir.flags[0] > 0 ) //is external resource file???
       {
-        Directory p555_d = file.path().directory();
-        Path tmpPath = p555_d/Path( sbr.filename ).changeExtension( ".555" );
-        SgFileEntry tmpEntry = { tmpPath.toString(), sir };
-        p555 = _find555File( tmpEntry );
-        //std::string p555_2 = p555 + "555/" + sbr.filename;
-        //p555_1[p555_1.length()-3] = p555_1[p555_1.length()-2] = p555_1[p555_1.length()-1] = '5';
-        //p555_2[p555_2.length()-3] = p555_2[p555_2.length()-2] = p555_2[p555_2.length()-1] = '5';
-
-        //Logger::warning( "File %s maybe in external 555 file: %s", name.c_str(), p555.toString().c_str() );
+        std::map<std::string, Path>::iterator rIt = resolved555.find( sbr.filename );
+        if( rIt == resolved555.end() )
+        {
+          Directory p555_d = file.path().directory();
+          Path tmpPath = p555_d/Path( sbr.filename ).changeExtension( ".555" );
+          SgFileEntry tmpEntry = { tmpPath.toString(), sir };
+          Path found = _find555File( tmpEntry );
+          rIt = resolved555.insert( std::make_pair( std::string( sbr.filename ),
+                                                    found.exist() ? found : Path() ) ).first;
+        }
+
+        p555 = rIt->second;
       }
       else
       {
-        p555 = file.path().changeExtension( ".555" );
+        p555 = own555;
       }
 
-      if( !p555.exist() )
+      if( p555.toString().empty() )
       {
-          Logger::warning("Cannot found 555 file for image %s in file %s", name.c_str(), p555.toString().c_str());
+          Logger::warning("Cannot found 555 file for image %s in file %s", name.c_str(), sbr.filename );
           continue; // skip to next bitmap
       }
 
@@ -182,9 +330,206 @@ Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _file( file )
     } // image loop
   } // bitmap loop
   sort();
+
+  if( cacheFolder.toString().empty() || _fileInfo.empty() )
+    return;
+
+  SgCacheHeader stamp;
+  memset( &stamp, 0, sizeof(stamp) );
+  addFileStamp( file.path(), stamp.sgSize, stamp.sgTime );
+  std::set<std::string> dataNames;
+  foreach( it, _fileInfo ) { dataNames.insert( it->second.fn ); }
+  foreach( it, dataNames ) { addFileStamp( *it, stamp.dataSize, stamp.dataTime ); }
+
+  Path cachePath = Directory( cacheFolder )/Path( file.path().baseName().removeExtension() + ".sgcache" );
+  if( !_openCache( cachePath, stamp ) )
+  {
+    _buildCache( cachePath, stamp );
+    _openCache( cachePath, stamp );
+  }
 }
 
-Sg2ArchiveReader::~Sg2ArchiveReader() {}
+void Sg2ArchiveReader::setCacheFolder( const Path& folder ) { cacheFolder = folder; }
+
+bool Sg2ArchiveReader::_openCache( const Path& cachePath, const SgCacheHeader& stamp )
+{
+  MappedFile* mfile = new MappedFile();
+  if( !mfile->open( cachePath ) )
+  {
+    delete mfile;
+    return false;
+  }
+
+  const SgCacheHeader* header = (const SgCacheHeader*)mfile->data();
+  bool valid = mfile->size() >= sizeof(SgCacheHeader)
+               && memcmp( header->magic, "CSG2", 4 ) == 0
+               && header->version == cacheVersion
+               && header->sgSize == stamp.sgSize && header->sgTime == stamp.sgTime
+               && header->dataSize == stamp.dataSize && header->dataTime == stamp.dataTime
+               && header->data <= mfile->size()
+               && header->strings + 1 <= header->data
+               && sizeof(SgCacheHeader) + header->count * sizeof(SgCacheEntry) <= header->strings;
+
+  if( !valid )
+  {
+    Logger::warning( "Sg2ArchiveReader: outdated cache " + cachePath.toString() );
+    delete mfile;
+    return false;
+  }
+
+  Logger::warning( "Sg2ArchiveReader: use cache " + cachePath.toString() );
+  delete _cache;
+  _cache = mfile;
+  return true;
+}
+
+void Sg2ArchiveReader::_buildCache( const Path& cachePath, const SgCacheHeader& stamp )
+{
+  Logger::warning( "Sg2ArchiveReader: build cache " + cachePath.toString() );
+  unsigned int startTime = DateTime::elapsedTime();
+
+  //all shared data must be ready before workers start
+  colorTable();
+  foreach( it, _fileInfo ) { _dataFile( it->second.fn ); }
+
+  SgCacheHeader header = stamp;
+  memcpy( header.magic, "CSG2", 4 );
+  header.version = cacheVersion;
+  header.count = _fileInfo.size();
+
+  std::vector< SgCacheEntry > entries;
+  std::string names;
+  std::vector< SgDecodeTask* > tasks;
+  unsigned int dataLength = 0;
+  foreach( it, _fileInfo )
+  {
+    if( tasks.empty() || tasks.back()->items.size() >= imagesPerTask )
+    {
+      tasks.push_back( new SgDecodeTask() );
+      tasks.back()->reader = this;
+    }
+    tasks.back()->items.push_back( &it->second );
+
+    SgCacheEntry entry;
+    entry.hash = StringHelper::hash( it->first );
+    entry.name = names.size();
+    entry.offset = dataLength;
+    entry.length = imageBytes( it->second.sr );
+    entries.push_back( entry );
+
+    names.append( it->first.c_str(), it->first.size() + 1 );
+    dataLength += entry.length;
+  }
+
+  header.strings = sizeof(SgCacheHeader) + entries.size() * sizeof(SgCacheEntry);
+  header.data = header.strings + names.size();
+  header.data = (header.data + cachePageSize - 1) / cachePageSize * cachePageSize;
+  for( unsigned int k=0; k < entries.size(); k++ )
+    entries[ k ].offset += header.data;
+
+  std::stable_sort( entries.begin(), entries.end(), cacheEntryLess );
+
+  int threadsCount = math::clamp<int>( SDL_GetCPUCount() - 1, 1, maxDecodeThreads );
+  std::vector< ThreadPtr > workers;
+  for( int k=0; k < threadsCount; k++ )
+  {
+    ThreadPtr worker( new Thread() );
+    worker->drop();
+    workers.push_back( worker );
+  }
+
+  std::vector< bool > queued( tasks.size(), false );
+  for( unsigned int k=0; k < tasks.size(); k++ )
+  {
+    queued[ k ] = workers[ k % workers.size() ]->Event( tasks[ k ] );
+  }
+
+  Path tmpPath = cachePath.toString() + ".tmp";
+  NFile cache = NFile::open( tmpPath, Entity::fmWrite );
+  bool writeOk = cache.isOpen();
+  if( writeOk )
+  {
+    std::vector< char > padding( header.data - header.strings - names.size(), 0 );
+    cache.write( &header, sizeof(header) );
+    cache.write( &entries[0], entries.size() * sizeof(SgCacheEntry) );
+    cache.write( names.data(), names.size() );
+    if( !padding.empty() )
+      cache.write( &padding[0], padding.size() );
+  }
+
+  //tasks are written in order, so memory is freed while workers decode next ones
+  for( unsigned int k=0; k < tasks.size(); k++ )
+  {
+    SgDecodeTask* task = tasks[ k ];
+    if( !queued[ k ] )
+    {
+      task->task();
+    }
+    else
+    {
+      while( task->getStatus() != TaskStatusCompleted )
+        Thread::msleep( 1 );
+    }
+
+    if( writeOk && !task->data.empty() )
+      writeOk = cache.write( task->data ) == (int)task->data.size();
+
+    delete task;
+  }
+
+  cache.flush();
+  cache = NFile();
+
+  if( writeOk )
+  {
+    NFile::remove( cachePath );
+    writeOk = NFile::rename( tmpPath, cachePath );
+  }
+  else
+  {
+    NFile::remove( tmpPath );
+  }
+
+  Logger::warning( "Sg2ArchiveReader: cache %s with %d images done in %d ms",
+                   writeOk ? "created" : "failed", header.count, DateTime::elapsedTime() - startTime );
+}
+
+const char* Sg2ArchiveReader::_findCached( const std::string& name, unsigned int& length ) const
+{
+  if( !_cache )
+    return 0;
+
+  const SgCacheHeader* header = (const SgCacheHeader*)_cache->data();
+  const SgCacheEntry* entries = (const SgCacheEntry*)(_cache->data() + sizeof(SgCacheHeader));
+  const char* names = _cache->data() + header->strings;
+  unsigned int hash = StringHelper::hash( name );
+
+  unsigned int left = 0, right = header->count;
+  while( left < right )
+  {
+    unsigned int middle = (left + right) / 2;
+    if( entries[ middle ].hash < hash ) { left = middle + 1; }
+    else { right = middle; }
+  }
+
+  for( ; left < header->count && entries[ left ].hash == hash; left++ )
+  {
+    const SgCacheEntry& entry = entries[ left ];
+    if( name == names + entry.name && entry.offset + entry.length <= _cache->size() )
+    {
+      length = entry.length;
+      return _cache->data() + entry.offset;
+    }
+  }
+
+  return 0;
+}
+
+Sg2ArchiveReader::~Sg2ArchiveReader()
+{
+  foreach( it, _dataFiles ) { delete it->second; }
+  delete _cache;
+}
 
 const std::string &Sg2ArchiveReader::getTypeName() const { return readerTypename;}
 Archive::Type Sg2ArchiveReader::getType() const{  return Archive::sg2;}
@@ -197,10 +542,12 @@ NFile Sg2ArchiveReader::createAndOpenFile(unsigned int index)
   return NFile();
 }
 
-void Sg2ArchiveReader::_loadSpriteImage( Picture& img, const SgFileEntry& rec)
+void Sg2ArchiveReader::_loadSpriteImage( SgCanvas& img, const SgFileEntry& rec)
 {
-	ByteArray buffer = _readData( rec );
-	_writeTransparentImage( img, (unsigned char*)buffer.data(), rec.sr.length);
+	ByteArray tail;
+	const unsigned char* buffer = _readData( rec, tail );
+	if( buffer )
+		_writeTransparentImage( img, buffer, rec.sr.length);
 }
 
 std::string Sg2ArchiveReader::_find555File( const SgFileEntry& rec )
@@ -255,49 +602,65 @@ std::string Sg2ArchiveReader::_findFilenameCaseInsensitive( const std::string& d
   return std::string();
 }
 
-ByteArray Sg2ArchiveReader::_readData(const SgFileEntry& rec )
+MappedFile* Sg2ArchiveReader::_dataFile( const std::string& filename )
 {
-	std::string filename = rec.fn;
-	unsigned int start = rec.sr.offset - rec.sr.flags[0];
-	unsigned int data_length = rec.sr.length;
+	DataFiles::iterator it = _dataFiles.find( filename );
+	if( it != _dataFiles.end() )
+		return it->second;
 
-	FileNative z5file( filename, Entity::fmRead );
-	if (!z5file.isOpen() )
+	MappedFile* mfile = new MappedFile();
+	if( !mfile->open( filename ) )
 	{
 		Logger::warning( "Unable to open 555 file %s", filename.c_str() );
-		return ByteArray();
+		delete mfile;
+		mfile = 0;
 	}
 
-	z5file.seek( start );
-	// This if statement will never execute since data_length is unsigned and therefore not negative. Intended?
-	if( data_length <= 0 )
-	{
-		Logger::warning( "Data length: %d", data_length); // not an error per se
-	}
+	_dataFiles[ filename ] = mfile;
+	return mfile;
+}
+
+const unsigned char* Sg2ArchiveReader::_readData(const SgFileEntry& rec, ByteArray& tail )
+{
+	unsigned int start = rec.sr.offset - rec.sr.flags[0];
+	unsigned int data_length = rec.sr.length;
 
-	ByteArray data = z5file.read( data_length );
+	MappedFile* z5file = _dataFile( rec.fn );
+	if( !z5file || start > z5file->size() )
+		return 0;
+
+	const unsigned char* data = (const unsigned char*)z5file->data() + start;
+	unsigned int real_read = z5file->size() - start;
+	if( real_read >= data_length )
+		return data;
 
-	unsigned int real_read = data.size();
-	if( real_read + 4 == data_length && z5file.isEof() )
+	if( real_read + 4 == data_length )
 	{
 		// Exception for some C3 graphics: last image is 'missing' 4 bytes
-		data.resize( real_read + 4 );
-		data[real_read] = data[real_read+1] = 0;
-		data[real_read+2] = data[real_read+3] = 0;
+		tail.resize( data_length );
+		memcpy( tail.data(), data, real_read );
+		tail[real_read] = tail[real_read+1] = 0;
+		tail[real_read+2] = tail[real_read+3] = 0;
+		return (const unsigned char*)tail.data();
 	}
 
-	return data;
+	Logger::warning( "Unable to read %d bytes from file (read %d bytes)", data_length, real_read );
+	return 0;
 }
 
-void Sg2ArchiveReader::_loadIsometricImage( Picture& pic, const SgFileEntry& rec )
+void Sg2ArchiveReader::_loadIsometricImage( SgCanvas& pic, const SgFileEntry& rec )
 {
-	ByteArray buffer = _readData( rec );
-	_writeIsometricBase( pic, rec.sr, (unsigned char*)buffer.data() );
-	_writeTransparentImage( pic, (unsigned char*)(&buffer[0] + rec.sr.uncompressed_length),
+	ByteArray tail;
+	const unsigned char* buffer = _readData( rec, tail );
+	if( !buffer )
+		return;
+
+	_writeIsometricBase( pic, rec.sr, buffer );
+	_writeTransparentImage( pic, buffer + rec.sr.uncompressed_length,
 				rec.sr.length - rec.sr.uncompressed_length);
 }
 
-void Sg2ArchiveReader::_writeIsometricBase( Picture& img, const SgImageRecord& rec, const unsigned char* buffer )
+void Sg2ArchiveReader::_writeIsometricBase( SgCanvas& img, const SgImageRecord& rec, const unsigned char* buffer )
 {
 	int i = 0, x, y;
 	int width, height, height_offset;
@@ -305,9 +668,9 @@ void Sg2ArchiveReader::_writeIsometricBase( Picture& img, const SgImageRecord& r
 	int x_offset, y_offset;
 	int tile_bytes, tile_height, tile_width;
 
-	width = img.width();
+	width = img.width;
 	height = (width + 2) / 2; /* 58 -> 30, 118 -> 60, etc */
-	height_offset = img.height() - height;
+	height_offset = img.height - height;
 	y_offset = height_offset;
 
 	if (size == 0) {
@@ -372,49 +735,36 @@ void Sg2ArchiveReader::_writeIsometricBase( Picture& img, const SgImageRecord& r
 	}
 }
 
-void Sg2ArchiveReader::_writeIsometricTile( Picture& img, const unsigned char* buffer,
+void Sg2ArchiveReader::_writeIsometricTile( SgCanvas& img, const unsigned char* buffer,
 																						int offset_x, int offset_y,
 																						int tile_width, int tile_height )
 {
 	int half_height = tile_height / 2;
-	int x, y, i = 0;
-
-	unsigned int* pixels = img.lock();
+	int y, i = 0;
+	const unsigned int* table = colorTable();
+	int width = img.width;
 
-	for (y = 0; y < half_height; y++)
-	{
-		int start = tile_height - 2 * (y + 1);
-		int end = tile_width - start;
-		for (x = start; x < end; x++, i += 2)
-		{
-			unsigned int* bufp32;
-			bufp32 = pixels + (offset_y + y) * img.width() + offset_x + x;
-			*bufp32 = _555toRGBA( (buffer[i+1] << 8) | buffer[i] );
-		}
-	}
+	unsigned int* pixels = img.pixels;
 
-	for (y = half_height; y < tile_height; y++)
+	for (y = 0; y < tile_height; y++)
 	{
-		int start = 2 * y - tile_height;
-		int end = tile_width - start;
-		for (x = start; x < end; x++, i += 2)
-		{
-			unsigned int* bufp32;
-			bufp32 = pixels + (offset_y + y) * img.width() + offset_x + x;
-			*bufp32 = _555toRGBA( (buffer[i+1] << 8) | buffer[i] );
-		}
+		int start = y < half_height
+								? tile_height - 2 * (y + 1)
+								: 2 * y - tile_height;
+		int count = tile_width - 2 * start;
+		convertRow( pixels + (offset_y + y) * width + offset_x + start, buffer + i, count, table );
+		i += count * 2;
 	}
-
-	img.unlock();
 }
 
-void Sg2ArchiveReader::_writeTransparentImage( Picture& img, const unsigned char* buffer, int length)
+void Sg2ArchiveReader::_writeTransparentImage( SgCanvas& img, const unsigned char* buffer, int length)
 {
 	int i = 0;
 	int x = 0, y = 0, j;
-	int width = img.width();
+	int width = img.width;
+	const unsigned int* table = colorTable();
 
-	unsigned int* pixels = img.lock();
+	unsigned int* pixels = img.pixels;
 	while (i < length)
 	{
 		unsigned char c = buffer[i++];
@@ -429,14 +779,14 @@ void Sg2ArchiveReader::_writeTransparentImage( Picture& img, const unsigned char
 		}
 		else
 		{
-			/* `c' is the number of image data bytes */
-			for (j = 0; j < c; j++, i += 2)
+			/* `c' is the number of image data bytes, converted by row runs */
+			for (j = 0; j < c; )
 			{
-				unsigned int* bufp32;
-				bufp32 = pixels + y * img.width() + x;
-				*bufp32 = _555toRGBA( buffer[i] | (buffer[i+1] << 8) );
-
-				x++;
+				int run = std::min<int>( c - j, width - x );
+				convertRow( pixels + y * width + x, buffer + i, run, table );
+				i += run * 2;
+				j += run;
+				x += run;
 				if (x >= width)
 				{
 					y++; x = 0;
@@ -444,10 +794,9 @@ void Sg2ArchiveReader::_writeTransparentImage( Picture& img, const unsigned char
 			}
 		}
 	}
-	img.unlock();
 }
 
-void Sg2ArchiveReader::_loadPlainImage( Picture& pic, const SgFileEntry& rec)
+void Sg2ArchiveReader::_loadPlainImage( SgCanvas& pic, const SgFileEntry& rec)
 {
 	// Check whether the image data is OK
 	if (rec.sr.height * rec.sr.width * 2 != (int)rec.sr.length)
@@ -456,55 +805,52 @@ void Sg2ArchiveReader::_loadPlainImage( Picture& pic, const SgFileEntry& rec)
 		return;
 	}
 
-	unsigned int need_length = rec.sr.length;
-	ByteArray data = _readData( rec );
-	if( data.size() != need_length )
-	{
-		Logger::warning( "Unable to read %d bytes from file (read %d bytes)",
-										 data.size(), need_length );
+	ByteArray tail;
+	const unsigned char* rdata = _readData( rec, tail );
+	if( !rdata )
 		return;
-	}
 
-	int i = 0;
-	unsigned int* pixels = pic.lock();
+	const unsigned int* table = colorTable();
+	unsigned int* pixels = pic.pixels;
 
-	unsigned char* rdata = (unsigned char*)data.data();
 	for (int y = 0; y < (int)rec.sr.height; y++)
 	{
-		for (int x = 0; x < (int)rec.sr.width; x++, i+= 2)
-		{
-			unsigned int* bufp32;
-			bufp32 = pixels + y * pic.width() + x;
-			*bufp32 = _555toRGBA( rdata[i] | (rdata[i+1] << 8) );
-		}
+		convertRow( pixels + y * pic.width, rdata + y * rec.sr.width * 2, rec.sr.width, table );
 	}
-
-	pic.unlock();
 }
 
-unsigned int Sg2ArchiveReader::_555toRGBA( unsigned short color)
+void Sg2ArchiveReader::_decodeImage( SgCanvas& img, const SgFileEntry& rec )
 {
-	if(color == 0xf81f)
-	{
-		return 0;
-	}
-
-	NColor rgb( 0xff000000 );
-
-	// Red: bits 11-15, should go to bits 17-24
-	unsigned int red = ((color & 0x7c00) << 9) | ((color & 0x7000) << 4);
-
-	// Green: bits 6-10, should go to bits 9-16
-	unsigned int green = ((color & 0x3e0) << 6) | ((color & 0x300));
-
-	// Blue: bits 1-5, should go to bits 1-8
-	unsigned int blue = ((color & 0x1f) << 3) | ((color & 0x1c) >> 2);
-
-	rgb.setRed( (red >> 16) & 0xff );
-	rgb.setGreen( (green >> 8) & 0xff );
-	rgb.setBlue( blue & 0xff );
+  switch( rec.sr.type )
+  {
+    case 0:
+    case 1:
+    case 10:
+    case 12:
+    case 13:
+      _loadPlainImage( img, rec );
+    break;
+
+    case 30:
+      _loadIsometricImage( img, rec );
+    break;
+
+    case 256:
+    case 257:
+    case 276:
+      _loadSpriteImage( img, rec );
+    break;
+
+    default:
+      Logger::warning("Unknown image type: %d", rec.sr.type);
+    break;
+  }
 
-	return rgb.abgr();
+  /*if( sir.alpha_length )
+  {
+    quint8 *alpha_buffer = &(buffer[workRecord->length]);
+    loadAlphaMask(&result, alpha_buffer);
+  }*/
 }
 
 NFile Sg2ArchiveReader::createAndOpenFile(const Path& filename)
@@ -513,52 +859,28 @@ NFile Sg2ArchiveReader::createAndOpenFile(const Path& filename)
 
   if( it != _fileInfo.end() )
   {
-    SgImageRecord& sir = it->second.sr;
-
-    PictureRef result;
-    result.init( Size( sir.width, sir.height ) );
-    result->fill( 0, Rect() ); // Transparent black
-
-    switch(sir.type)
+    unsigned int length = 0;
+    const char* cached = _findCached( it->first, length );
+    if( cached )
     {
-      case 0:
-      case 1:
-      case 10:
-      case 12:
-      case 13:
-        //Logger::warning( "Find plain image " + filename.toString() );
-        _loadPlainImage( *result, it->second );
-        //PictureConverter::save( *result, "base/" + filename.removeExtension() + ".png" );
-        break;
-
-      case 30:
-        //Logger::warning( "Find isometric image " + filename.toString() );
-        _loadIsometricImage( *result, it->second );
-        //PictureConverter::save( *result, "base/" + filename.removeExtension() + ".png" );
-      break;
-
-      case 256:
-      case 257:
-      case 276:
-        //Logger::warning( "Find sprite image " + filename.toString() );
-        _loadSpriteImage( *result, it->second );
-        //PictureConverter::save( *result, "base/" + filename.removeExtension() + ".png" );
-      break;
-
-      default:
-        Logger::warning("Unknown image type: %d", sir.type);
-      break;
+      //picture data stays in mapped cache while archive is mounted
+      return MemoryFile::create( (void*)cached, length, filename, false );
     }
 
-    ByteArray data = PictureConverter::save( *result, "PNG" );
-    NFile memfile = MemoryFile::create( data, filename );
-    return memfile;
+    //decoded picture is returned uncompressed, PictureLoader detect it by header
+    const SgImageRecord& sir = it->second.sr;
+    ByteArray data;
+    data.resize( imageBytes( sir ) ); // Transparent black
 
-    /*if( sir.alpha_length )
-    {
-      quint8 *alpha_buffer = &(buffer[workRecord->length]);
-      loadAlphaMask(&result, alpha_buffer);
-    }*/
+    RawPictureHeader* header = (RawPictureHeader*)data.data();
+    memcpy( header->magic, RawPictureHeader::signature(), 4 );
+    header->width = std::max<int>( sir.width, 0 );
+    header->height = std::max<int>( sir.height, 0 );
+
+    SgCanvas canvas = { (unsigned int*)(data.data() + sizeof(RawPictureHeader)), (int)header->width, (int)header->height };
+    _decodeImage( canvas, it->second );
+
+    return MemoryFile::create( data, filename );
   }
 
   return NFile();
@@ -130,6 +130,10 @@ struct SgFileEntry
   SgImageRecord sr;
 };
 
+class MappedFile;
+struct SgCanvas;
+struct SgCacheHeader;
+
 class Sg2ArchiveReader : public virtual Archive, virtual Entries
 {
 public:
@@ -143,20 +147,31 @@ public:
 
   Archive::Type getType() const;
 
+  //! folder where decoded sprites are stored between launches, empty path disables cache
+  static void setCacheFolder( const Path& folder );
+
 private:
-  //std::map<std::string, std::ifstream> _555List;
+  friend class SgDecodeTask;
+
   typedef std::map<std::string, SgFileEntry> FileInfo;
+  typedef std::map<std::string, MappedFile*> DataFiles;
   FileInfo _fileInfo;
+  DataFiles _dataFiles;  // .555 files, mapped once on first use
+  MappedFile* _cache;    // decoded sprites from previous launches
   NFile _file;
 
-  void _loadSpriteImage( gfx::Picture& img, const SgFileEntry& rec);
-  void _writeTransparentImage( gfx::Picture& img, const unsigned char* buffer, int length);
-  void _writeIsometricTile( gfx::Picture& img, const unsigned char* buffer, int offset_x, int offset_y, int tile_width, int tile_height);
-  void _writeIsometricBase( gfx::Picture& img, const SgImageRecord& rec, const unsigned char* buffer);
-  ByteArray _readData( const SgFileEntry& rec );
-  void _loadIsometricImage( gfx::Picture& pic, const SgFileEntry& rec);
-  void _loadPlainImage( gfx::Picture& pic, const SgFileEntry& rec);
-  unsigned int _555toRGBA( unsigned short color);
+  void _decodeImage( SgCanvas& img, const SgFileEntry& rec );
+  void _loadSpriteImage( SgCanvas& img, const SgFileEntry& rec);
+  void _writeTransparentImage( SgCanvas& img, const unsigned char* buffer, int length);
+  void _writeIsometricTile( SgCanvas& img, const unsigned char* buffer, int offset_x, int offset_y, int tile_width, int tile_height);
+  void _writeIsometricBase( SgCanvas& img, const SgImageRecord& rec, const unsigned char* buffer);
+  const unsigned char* _readData( const SgFileEntry& rec, ByteArray& tail );
+  MappedFile* _dataFile( const std::string& filename );
+  void _loadIsometricImage( SgCanvas& pic, const SgFileEntry& rec);
+  void _loadPlainImage( SgCanvas& pic, const SgFileEntry& rec);
+  bool _openCache( const Path& cachePath, const SgCacheHeader& stamp );
+  void _buildCache( const Path& cachePath, const SgCacheHeader& stamp );
+  const char* _findCached( const std::string& name, unsigned int& length ) const;
   std::string _findFilenameCaseInsensitive(const std::string& directory, std::string filename);
   std::string _find555File(const SgFileEntry& rec);
 }; // class Sg2ArchiveReader
@@ -19,6 +19,7 @@
 
 #include "entries.hpp"
 #include "memfile.hpp"
+#include "zipstream_impl.hpp"
 #include "core/logger.hpp"
 
 #include <zlib.h>
@@ -120,6 +121,7 @@ class ZipArchiveReader::Impl
 {
 public:
   bool isGZip;
+  ArchiveMappingPtr mapping; // native archive file mapped to memory, entries read from it
 };
 
 ZipArchiveReader::ZipArchiveReader( NFile file, bool ignoreCase, bool ignorePaths, bool isGZip)
@@ -141,6 +143,13 @@ ZipArchiveReader::ZipArchiveReader( NFile file, bool ignoreCase, bool ignorePath
 			while (scanZipHeader()) { }
 
 		sort();
+
+    ArchiveMappingPtr mapping( new ArchiveMapping() );
+    mapping->drop();
+    if( mapping->file.mapNative( file.path() ) && (long)mapping->file.size() == file.size() )
+    {
+      _d->mapping = mapping;
+    }
 	}
 }
 
@@ -447,6 +456,17 @@ NFile ZipArchiveReader::createAndOpenFile(unsigned int index)
 
   const SZipFileEntry &e = FileInfo[ _items()[index].uid ];
 
+  //not encrypted entries are read from mapped archive without full decoding
+  if( _d->mapping.isValid() && !(e.header.GeneralBitFlag & ZIP_FILE_ENCRYPTED)
+      && ZipStream::isSupported( e.header.CompressionMethod ) )
+  {
+    NFile stream = ZipStream::create( _d->mapping, e.Offset, e.header.DataDescriptor.CompressedSize,
+                                      e.header.DataDescriptor.UncompressedSize,
+                                      e.header.CompressionMethod, item( index ).fullpath );
+    if( stream.isOpen() )
+      return stream;
+  }
+
   short actualCompressionMethod=e.header.CompressionMethod;
   NFile decrypted;
   ByteArray decryptedBuf;
@@ -56,6 +56,8 @@ bool Directory::create( std::string dir )
     return false;
   }
 
+  FileSystem::instance().resetMissedFiles();
+
   int result=0;
 #ifdef CAESARIA_PLATFORM_WIN
   CreateDirectoryA( rdir.removeEndSlash().toString().c_str(), NULL );
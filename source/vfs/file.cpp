@@ -184,6 +184,8 @@ bool NFile::remove( Path filename )
 
 bool NFile::rename(Path oldpath, Path newpath)
 {
+  FileSystem::instance().resetMissedFiles();
+
 #ifdef CAESARIA_PLATFORM_WIN
   bool result = MoveFileExA( oldpath.toString().c_str(), newpath.toString().c_str(), MOVEFILE_REPLACE_EXISTING );
 
@@ -23,6 +23,10 @@
 #include "entries.hpp"
 #include "core/logger.hpp"
 #include "core/stringhelper.hpp"
+#include "thread/mutex.hpp"
+
+#include <map>
+#include <set>
 
 #if defined (CAESARIA_PLATFORM_WIN)
 	#include <direct.h> // for _chdir
@@ -44,9 +48,23 @@
 namespace vfs
 {
 
+namespace {
+static const unsigned int missedCacheLifetime = 2000; // ms, native files may be changed from outside
+}
+
 class FileSystem::Impl
 {
 public:
+  struct IndexEntry
+  {
+    Archive* archive;
+    unsigned int nhash;  // hash of file name with original case
+  };
+
+  typedef std::vector< IndexEntry > IndexEntries;
+  typedef std::map< unsigned int, IndexEntries > PathIndex;
+  typedef std::set< unsigned int > MissedFiles;
+
   //! currently attached ArchiveLoaders
   std::vector< ArchiveLoaderPtr > archiveLoaders;
 	//! currently attached Archives
@@ -59,10 +77,90 @@ public:
 
   FileSystem::Mode fileSystemType;
 
+  //! entries of all mounted archives in mount order, key is hash of lowercased file name
+  PathIndex pathIndex;
+
+  //! native files which not exist, key is hash of full path and sens type
+  MissedFiles missedFiles;
+  unsigned int missedResetTime;
+  Mutex missedLock;
+
 public:
   ArchivePtr changeArchivePassword( const Path& filename, const std::string& password );
+  void addToIndex( Archive* archive );
+  void rebuildIndex();
+  Archive* findArchive( const Path& filename ) const;
+  bool isMissed( unsigned int hash );
+  void addMissed( unsigned int hash );
+  void resetMissed();
 };
 
+void FileSystem::Impl::addToIndex( Archive* archive )
+{
+  const Entries* entries = archive->entries();
+  foreach( it, *entries )
+  {
+    IndexEntries& items = pathIndex[ it->nihash ];
+    if( !items.empty() && items.back().archive == archive && items.back().nhash == it->nhash )
+      continue;
+
+    IndexEntry entry = { archive, it->nhash };
+    items.push_back( entry );
+  }
+
+  resetMissed();
+}
+
+void FileSystem::Impl::rebuildIndex()
+{
+  pathIndex.clear();
+  foreach( it, openArchives ) { addToIndex( it->object() ); }
+  resetMissed();
+}
+
+Archive* FileSystem::Impl::findArchive( const Path& filename ) const
+{
+  std::string name = filename.baseName().toString();
+  PathIndex::const_iterator it = pathIndex.find( StringHelper::hash( StringHelper::localeLower( name ) ) );
+  if( it == pathIndex.end() )
+    return 0;
+
+  //exact name match is resolved by index, archive checks only other case of name
+  unsigned int nhash = StringHelper::hash( name );
+  foreach( item, it->second )
+  {
+    if( item->nhash == nhash || item->archive->entries()->findFile( filename ) != -1 )
+      return item->archive;
+  }
+
+  return 0;
+}
+
+bool FileSystem::Impl::isMissed( unsigned int hash )
+{
+  MutexLocker locker( &missedLock );
+  if( DateTime::elapsedTime() - missedResetTime > missedCacheLifetime )
+  {
+    missedFiles.clear();
+    missedResetTime = DateTime::elapsedTime();
+  }
+
+  return missedFiles.count( hash ) > 0;
+}
+
+void FileSystem::Impl::addMissed( unsigned int hash )
+{
+  MutexLocker locker( &missedLock );
+  missedFiles.insert( hash );
+}
+
+void FileSystem::Impl::resetMissed()
+{
+  MutexLocker locker( &missedLock );
+  missedFiles.clear();
+  missedResetTime = DateTime::elapsedTime();
+}
+
 ArchivePtr FileSystem::Impl::changeArchivePassword(const Path& filename, const std::string& password )
 {
   foreach( it, openArchives )
@@ -88,6 +186,7 @@ ArchivePtr FileSystem::Impl::changeArchivePassword(const Path& filename, const s
 //! constructor
 FileSystem::FileSystem() : _d( new Impl )
 {
+  _d->missedResetTime = 0;
   setMode( fsNative );
   //! reset current working directory
 
@@ -100,17 +199,8 @@ FileSystem::~FileSystem() {}
 
 NFile FileSystem::loadFileFromArchive( const Path& filePath )
 {
-  foreach( it, _d->openArchives )
-  {
-    NFile file = (*it)->createAndOpenFile( filePath );
-
-    if( file.isOpen() )
-    {
-      return file;
-    }
-  }
-
-  return NFile();
+  Archive* archive = _d->findArchive( filePath );
+  return archive ? archive->createAndOpenFile( filePath ) : NFile();
 }
 
 //! opens a file for read access
@@ -124,6 +214,9 @@ NFile FileSystem::createAndOpenFile(const Path& filename, Entity::Mode mode)
   }
 
   //Logger::warning( "FileSystem: create the file using an absolute path " + filename.toString() );
+  if( mode != Entity::fmRead )
+    resetMissedFiles();
+
   FSEntityPtr ptr( new FileNative( filename.absolutePath(), mode ) );
   ptr->drop();
 
@@ -178,6 +271,9 @@ bool FileSystem::moveArchive(unsigned int sourceIndex, int relative)
 		r = true;
 	}
 
+	if( r )
+		_d->rebuildIndex();
+
 	return r;
 }
 
@@ -294,6 +390,7 @@ ArchivePtr FileSystem::mountArchive(  const Path& filename,
     const std::string arcType = archive->getTypeName();
     Logger::warning( "FileSystem: check archive:type-%s as opened %s", arcType.c_str(), filename.toString().c_str() );
     _d->openArchives.push_back( archive );
+    _d->addToIndex( archive.object() );
     if( password.size() )
     {
       archive->Password=password;
@@ -393,6 +490,7 @@ ArchivePtr FileSystem::mountArchive(NFile file, Archive::Type archiveType,
     {
       Logger::warning( "Mount archive %s", file.path().toString().c_str() );
       _d->openArchives.push_back(archive);
+      _d->addToIndex( archive.object() );
 
       if (password.size())
       {
@@ -427,6 +525,7 @@ ArchivePtr FileSystem::mountArchive( ArchivePtr archive)
 	}
 
 	_d->openArchives.push_back(archive);
+  _d->addToIndex( archive.object() );
   return archive;
 }
 
@@ -439,6 +538,7 @@ bool FileSystem::unmountArchive(unsigned int index)
 	{
     Logger::warning( "FileSystem: unmountArchive %d", index );
 		_d->openArchives.erase( _d->openArchives.begin() + index );
+		_d->rebuildIndex();
 		ret = true;
 	}
 
@@ -529,6 +629,7 @@ const Path& FileSystem::workingDirectory()
 bool FileSystem::changeWorkingDirectoryTo(Path newDirectory)
 {
 	bool success=false;
+	resetMissedFiles(); // relative paths now point to other files
 
     if ( _d->fileSystemType != fsNative)
     {
@@ -689,28 +790,44 @@ Entries FileSystem::getFileList()
 //! determines if a file exists and would be able to be opened.
 bool FileSystem::existFile(const Path& filename, Path::SensType sens) const
 {
-  for (unsigned int i=0; i < _d->openArchives.size(); ++i)
-    if (_d->openArchives[i]->entries()->findFile(filename)!=-1)
-      return true;
+  if( _d->findArchive( filename ) != 0 )
+    return true;
 
+  unsigned int missedHash = StringHelper::hash( filename.toString() ) + sens;
+  if( _d->isMissed( missedHash ) )
+    return false;
+
+  bool exist = false;
+  bool checked = false;
   #if defined(CAESARIA_PLATFORM_WIN)
     if( sens == Path::nativeCase || sens == Path::ignoreCase )
     {
-      return ( _access( filename.toString().c_str(), 0) != -1);
+      exist = ( _access( filename.toString().c_str(), 0) != -1);
+      checked = true;
     }
   #elif defined(CAESARIA_PLATFORM_UNIX) || defined(CAESARIA_PLATFORM_HAIKU)
     if( sens == Path::nativeCase || sens == Path::equaleCase )
     {
-      return ( access( filename.toString().c_str(), 0 ) != -1);
+      exist = ( access( filename.toString().c_str(), 0 ) != -1);
+      checked = true;
     }
   #endif //CAESARIA_PLATFORM_UNIX
 
-  Entries files = Directory( filename.directory() ).getEntries();
-  files.setSensType( sens );
-  int index = files.findFile( filename );
-  return index != -1;
+  if( !checked )
+  {
+    Entries files = Directory( filename.directory() ).getEntries();
+    files.setSensType( sens );
+    exist = files.findFile( filename ) != -1;
+  }
+
+  if( !exist )
+    _d->addMissed( missedHash );
+
+  return exist;
 }
 
+void FileSystem::resetMissedFiles() { _d->resetMissed(); }
+
 DateTime FileSystem::getFileUpdateTime(const Path& filename) const
 { 
 #ifndef CAESARIA_PLATFORM_WIN
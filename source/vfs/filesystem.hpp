@@ -114,6 +114,9 @@ public:
   //! determines if a file exists and would be able to be opened.
   bool existFile(const Path& filename, Path::SensType sens=Path::nativeCase) const;
 
+  //! forget cached misses of native files, must be called when files created outside of NFile::open
+  void resetMissedFiles();
+
   DateTime getFileUpdateTime( const Path& filename ) const;
 
   Mode setMode( Mode listType );
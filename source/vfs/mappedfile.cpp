@@ -0,0 +1,174 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "mappedfile.hpp"
+#include "filesystem.hpp"
+#include "core/bytearray.hpp"
+#include "core/platform.hpp"
+
+#ifdef CAESARIA_PLATFORM_WIN
+  #include <windows.h>
+#elif defined(CAESARIA_PLATFORM_UNIX) || defined(CAESARIA_PLATFORM_HAIKU)
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace vfs
+{
+
+class MappedFile::Impl
+{
+public:
+  const char* data;
+  unsigned int size;
+  bool mapped;
+  ByteArray buffer; // used when file can't be mapped
+
+#ifdef CAESARIA_PLATFORM_WIN
+  HANDLE file;
+  HANDLE mapping;
+#endif
+
+  bool map( const Path& filename );
+  void unmap();
+};
+
+MappedFile::MappedFile() : _d( new Impl )
+{
+  _d->data = 0;
+  _d->size = 0;
+  _d->mapped = false;
+#ifdef CAESARIA_PLATFORM_WIN
+  _d->file = INVALID_HANDLE_VALUE;
+  _d->mapping = 0;
+#endif
+}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open( const Path& filename )
+{
+  close();
+
+  NFile file = FileSystem::instance().loadFileFromArchive( filename );
+  if( !file.isOpen() && _d->map( filename.absolutePath() ) )
+    return true;
+
+  if( !file.isOpen() )
+    file = NFile::open( filename );
+
+  if( !file.isOpen() )
+    return false;
+
+  _d->buffer = file.readAll();
+  _d->data = _d->buffer.data();
+  _d->size = _d->buffer.size();
+  return !_d->buffer.empty();
+}
+
+bool MappedFile::mapNative( const Path& filename )
+{
+  close();
+  return _d->map( filename.absolutePath() );
+}
+
+void MappedFile::close()
+{
+  if( _d->mapped )
+    _d->unmap();
+
+  _d->buffer.clear();
+  _d->data = 0;
+  _d->size = 0;
+  _d->mapped = false;
+}
+
+bool MappedFile::isOpen() const { return _d->data != 0; }
+bool MappedFile::isMapped() const { return _d->mapped; }
+const char* MappedFile::data() const { return _d->data; }
+unsigned int MappedFile::size() const { return _d->size; }
+
+#ifdef CAESARIA_PLATFORM_WIN
+bool MappedFile::Impl::map( const Path& filename )
+{
+  file = ::CreateFileA( filename.toString().c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+  if( file == INVALID_HANDLE_VALUE )
+    return false;
+
+  DWORD fsize = ::GetFileSize( file, 0 );
+  mapping = fsize > 0 ? ::CreateFileMappingA( file, 0, PAGE_READONLY, 0, 0, 0 ) : 0;
+  void* view = mapping ? ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : 0;
+  if( !view )
+  {
+    if( mapping ) ::CloseHandle( mapping );
+    ::CloseHandle( file );
+    mapping = 0;
+    file = INVALID_HANDLE_VALUE;
+    return false;
+  }
+
+  data = (const char*)view;
+  size = fsize;
+  mapped = true;
+  return true;
+}
+
+void MappedFile::Impl::unmap()
+{
+  ::UnmapViewOfFile( data );
+  ::CloseHandle( mapping );
+  ::CloseHandle( file );
+  mapping = 0;
+  file = INVALID_HANDLE_VALUE;
+}
+#elif defined(CAESARIA_PLATFORM_UNIX) || defined(CAESARIA_PLATFORM_HAIKU)
+bool MappedFile::Impl::map( const Path& filename )
+{
+  int fd = ::open( filename.toString().c_str(), O_RDONLY );
+  if( fd < 0 )
+    return false;
+
+  struct stat st;
+  void* view = MAP_FAILED;
+  if( ::fstat( fd, &st ) == 0 && st.st_size > 0 )
+  {
+    view = ::mmap( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  }
+  ::close( fd ); // mapping stays valid after descriptor closed
+
+  if( view == MAP_FAILED )
+    return false;
+
+  data = (const char*)view;
+  size = st.st_size;
+  mapped = true;
+  return true;
+}
+
+void MappedFile::Impl::unmap()
+{
+  ::munmap( (void*)data, size );
+}
+#else
+bool MappedFile::Impl::map( const Path& ) { return false; }
+void MappedFile::Impl::unmap() {}
+#endif
+
+}//end namespace vfs
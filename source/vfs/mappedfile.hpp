@@ -0,0 +1,59 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#ifndef __CAESARIA_MAPPEDFILE_H_INCLUDED__
+#define __CAESARIA_MAPPEDFILE_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "path.hpp"
+
+namespace vfs
+{
+
+/*!
+  Read-only view of whole file contents. Native files are memory mapped,
+  files from archives are read into memory once.
+*/
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open( const Path& filename );
+
+  //! maps native file only, never reads file contents to memory
+  bool mapNative( const Path& filename );
+  void close();
+
+  bool isOpen() const;
+  bool isMapped() const;
+
+  const char* data() const;
+  unsigned int size() const;
+
+private:
+  class Impl;
+  ScopedPtr<Impl> _d;
+
+  MappedFile( const MappedFile& );
+  MappedFile& operator=( const MappedFile& );
+};
+
+}//end namespace vfs
+
+#endif //__CAESARIA_MAPPEDFILE_H_INCLUDED__
@@ -0,0 +1,344 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#include "zipstream_impl.hpp"
+#include "core/logger.hpp"
+
+#include <zlib.h>
+#include <LzmaDec.h>
+#include <bzlib.h>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+namespace vfs
+{
+
+namespace
+{
+static const unsigned int windowCapacity = 64 * 1024;
+
+void *SzAlloc(void*, size_t size) { return malloc(size); }
+void SzFree(void*, void *address) { free(address); }
+ISzAlloc lzmaAlloc = { SzAlloc, SzFree };
+}
+
+class ZipStream::Impl
+{
+public:
+  ArchiveMappingPtr mapping;
+  const char* source;
+  unsigned int sourceSize;
+  unsigned int size;
+  int method;
+  Path filename;
+  long pos;
+
+  // last decoded part of data
+  ByteArray window;
+  unsigned int windowStart;
+  unsigned int windowSize;
+
+  // decoder state
+  bool started;
+  bool finished;
+  unsigned int decoded;   // uncompressed bytes produced
+  unsigned int consumed;  // compressed bytes used, lzma only
+  z_stream zstream;
+  bz_stream bzstream;
+  CLzmaDec lzmaState;
+
+  void stop();
+  bool restart();
+  bool decodeNext();
+  bool moveWindow( unsigned int position );
+};
+
+bool ZipStream::isSupported( int method )
+{
+  return method == stored || method == deflated || method == bzip2 || method == lzma;
+}
+
+NFile ZipStream::create( ArchiveMappingPtr mapping, unsigned int offset, unsigned int compressedSize,
+                         unsigned int size, int method, const Path& filename )
+{
+  if( mapping.isNull() || !isSupported( method )
+      || offset + compressedSize > mapping->file.size() )
+  {
+    return NFile();
+  }
+
+  ZipStream* zs = new ZipStream();
+  zs->_d->mapping = mapping;
+  zs->_d->source = mapping->file.data() + offset;
+  zs->_d->sourceSize = compressedSize;
+  zs->_d->size = (method == stored ? compressedSize : size);
+  zs->_d->method = method;
+  zs->_d->filename = filename;
+
+  FSEntityPtr ret( zs );
+  ret->drop();
+
+  return NFile( ret );
+}
+
+ZipStream::ZipStream() : _d( new Impl )
+{
+#ifdef _DEBUG
+  setDebugName("ZipStream");
+#endif
+
+  _d->source = 0;
+  _d->sourceSize = 0;
+  _d->size = 0;
+  _d->method = stored;
+  _d->pos = 0;
+  _d->windowStart = 0;
+  _d->windowSize = 0;
+  _d->started = false;
+  _d->finished = false;
+  _d->decoded = 0;
+  _d->consumed = 0;
+  LzmaDec_Construct( &_d->lzmaState );
+}
+
+ZipStream::~ZipStream() { _d->stop(); }
+
+void ZipStream::Impl::stop()
+{
+  if( !started )
+    return;
+
+  switch( method )
+  {
+  case deflated: inflateEnd( &zstream ); break;
+  case bzip2: BZ2_bzDecompressEnd( &bzstream ); break;
+  case lzma: LzmaDec_Free( &lzmaState, &lzmaAlloc ); break;
+  default: break;
+  }
+
+  started = false;
+}
+
+bool ZipStream::Impl::restart()
+{
+  stop();
+
+  finished = false;
+  decoded = 0;
+  consumed = 0;
+  windowStart = 0;
+  windowSize = 0;
+  window.resize( windowCapacity );
+
+  switch( method )
+  {
+  case deflated:
+    memset( &zstream, 0, sizeof(zstream) );
+    zstream.next_in = (Bytef*)source;
+    zstream.avail_in = sourceSize;
+    // wbits < 0 indicates no zlib header inside the data.
+    started = (inflateInit2( &zstream, -MAX_WBITS ) == Z_OK);
+  break;
+
+  case bzip2:
+    memset( &bzstream, 0, sizeof(bzstream) );
+    bzstream.next_in = (char*)source;
+    bzstream.avail_in = sourceSize;
+    started = (BZ2_bzDecompressInit( &bzstream, 0, 0 ) == BZ_OK);
+  break;
+
+  case lzma:
+  {
+    if( sourceSize < 4 )
+      break;
+
+    // 2 bytes version, 2 bytes size of properties, properties
+    unsigned int propSize = ((unsigned char)source[3] << 8) + (unsigned char)source[2];
+    if( 4 + propSize > sourceSize )
+      break;
+
+    LzmaDec_Construct( &lzmaState );
+    started = (LzmaDec_Allocate( &lzmaState, (const Byte*)source + 4, propSize, &lzmaAlloc ) == SZ_OK);
+    if( started )
+      LzmaDec_Init( &lzmaState );
+    consumed = 4 + propSize;
+  }
+  break;
+
+  default: break;
+  }
+
+  if( !started )
+    Logger::warning( "ZipStream: can't start decoding " + filename.toString() );
+
+  return started;
+}
+
+bool ZipStream::Impl::decodeNext()
+{
+  if( !started || finished || decoded >= size )
+    return false;
+
+  unsigned int produced = 0;
+  switch( method )
+  {
+  case deflated:
+  {
+    zstream.next_out = (Bytef*)window.data();
+    zstream.avail_out = windowCapacity;
+    int err = inflate( &zstream, Z_NO_FLUSH );
+    produced = windowCapacity - zstream.avail_out;
+    finished = (err != Z_OK);
+    if( err != Z_OK && err != Z_STREAM_END )
+      Logger::warning( "ZipStream: error decompressing " + filename.toString() );
+  }
+  break;
+
+  case bzip2:
+  {
+    bzstream.next_out = window.data();
+    bzstream.avail_out = windowCapacity;
+    int err = BZ2_bzDecompress( &bzstream );
+    produced = windowCapacity - bzstream.avail_out;
+    finished = (err != BZ_OK);
+    if( err != BZ_OK && err != BZ_STREAM_END )
+      Logger::warning( "ZipStream: error decompressing " + filename.toString() );
+  }
+  break;
+
+  case lzma:
+  {
+    SizeT dstLen = windowCapacity;
+    SizeT srcLen = sourceSize - consumed;
+    ELzmaStatus status;
+    SRes err = LzmaDec_DecodeToBuf( &lzmaState, (Byte*)window.data(), &dstLen,
+                                    (const Byte*)source + consumed, &srcLen,
+                                    LZMA_FINISH_ANY, &status );
+    consumed += srcLen;
+    produced = dstLen;
+    finished = (err != SZ_OK || produced == 0);
+    if( err != SZ_OK )
+      Logger::warning( "ZipStream: error decompressing " + filename.toString() );
+  }
+  break;
+
+  default: break;
+  }
+
+  windowStart = decoded;
+  windowSize = std::min( produced, size - decoded );
+  decoded += windowSize;
+
+  return windowSize > 0;
+}
+
+bool ZipStream::Impl::moveWindow( unsigned int position )
+{
+  if( position >= windowStart && position < windowStart + windowSize )
+    return true;
+
+  // decoder can't go back, start from begin
+  if( !started || position < windowStart )
+  {
+    if( !restart() )
+      return false;
+  }
+
+  while( decodeNext() )
+  {
+    if( position < windowStart + windowSize )
+      return true;
+  }
+
+  return false;
+}
+
+int ZipStream::read(void* buffer, unsigned int sizeToRead)
+{
+  unsigned int amount = 0;
+  char* out = (char*)buffer;
+
+  if( _d->method == stored )
+  {
+    amount = std::min<unsigned int>( sizeToRead, _d->size - _d->pos );
+    memcpy( out, _d->source + _d->pos, amount );
+    _d->pos += amount;
+    return amount;
+  }
+
+  while( amount < sizeToRead && (unsigned int)_d->pos < _d->size )
+  {
+    if( !_d->moveWindow( _d->pos ) )
+      break;
+
+    unsigned int offset = _d->pos - _d->windowStart;
+    unsigned int part = std::min( sizeToRead - amount, _d->windowSize - offset );
+    memcpy( out + amount, _d->window.data() + offset, part );
+    amount += part;
+    _d->pos += part;
+  }
+
+  return amount;
+}
+
+ByteArray ZipStream::readLine()
+{
+  ByteArray ret;
+  char c;
+  while( read( &c, 1 ) == 1 )
+  {
+    if( c == '\n' )
+      break;
+
+    ret.push_back( c );
+  }
+
+  return ret;
+}
+
+ByteArray ZipStream::read( unsigned int sizeToRead )
+{
+  ByteArray ret;
+  ret.resize( std::min<unsigned int>( sizeToRead, _d->size - _d->pos ) );
+  if( !ret.empty() )
+    ret.resize( read( ret.data(), ret.size() ) );
+
+  return ret;
+}
+
+int ZipStream::write(const void*, unsigned int) { return 0; }
+int ZipStream::write( const ByteArray& ) { return 0; }
+
+bool ZipStream::seek(long finalPos, bool relativeMovement)
+{
+  long newPos = relativeMovement ? _d->pos + finalPos : finalPos;
+  if( newPos < 0 || newPos > (long)_d->size )
+    return false;
+
+  _d->pos = newPos;
+  return true;
+}
+
+long ZipStream::size() const { return _d->size; }
+bool ZipStream::isOpen() const { return _d->source != 0; }
+long ZipStream::getPos() const { return _d->pos; }
+const Path& ZipStream::path() const { return _d->filename; }
+bool ZipStream::isEof() const { return (unsigned int)_d->pos >= _d->size; }
+void ZipStream::flush() {}
+
+} //end namespace vfs
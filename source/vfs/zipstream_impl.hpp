@@ -0,0 +1,74 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
+
+#ifndef __CAESARIA_ZIPSTREAM_H_INCLUDED__
+#define __CAESARIA_ZIPSTREAM_H_INCLUDED__
+
+#include "entity.hpp"
+#include "file.hpp"
+#include "path.hpp"
+#include "mappedfile.hpp"
+#include "core/scopedptr.hpp"
+
+namespace vfs
+{
+
+//! Mapped archive, shared with opened entries so they stay valid after archive unmounted
+class ArchiveMapping : public ReferenceCounted
+{
+public:
+  MappedFile file;
+};
+
+typedef SmartPtr< ArchiveMapping > ArchiveMappingPtr;
+
+//! Entry of zip archive which reads directly from mapped archive.
+//! Stored data is copied to reader buffer only, compressed data is decoded by parts on reading.
+class ZipStream : public Entity
+{
+public:
+  typedef enum { stored=0, deflated=8, bzip2=12, lzma=14 } Method;
+
+  static bool isSupported( int method );
+  static NFile create( ArchiveMappingPtr mapping, unsigned int offset, unsigned int compressedSize,
+                       unsigned int size, int method, const Path& filename );
+
+  virtual ~ZipStream();
+
+  virtual int read(void* buffer, unsigned int sizeToRead);
+  virtual ByteArray readLine();
+  virtual ByteArray read( unsigned int sizeToRead );
+  virtual int write(const void* buffer, unsigned int sizeToWrite);
+  virtual int write( const ByteArray& bArray );
+  virtual bool seek(long finalPos, bool relativeMovement = false);
+  virtual long size() const;
+  virtual bool isOpen() const;
+  virtual long getPos() const;
+  virtual const Path& path() const;
+  virtual bool isEof() const;
+  virtual void flush();
+
+private:
+  ZipStream();
+
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+} //end namespace vfs
+
+#endif //__CAESARIA_ZIPSTREAM_H_INCLUDED__
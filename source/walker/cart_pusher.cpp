@@ -134,7 +134,7 @@ void CartPusher::_brokePathway(TilePos pos)
     }
   }
 
-  Logger::warning( "CartPusher::_brokePathway now destination point [%d,%d]", pos.i(), pos.j() );
+  CAESARIA_LOG_DEBUG( "CartPusher::_brokePathway now destination point [%d,%d]", pos.i(), pos.j() );
   deleteLater();
 }
 
@@ -88,7 +88,7 @@ void DustCloud::send2City(const TilePos &start, const TilePos& stop )
 
   if( _d->from == _d->dst )
   {
-    Logger::warning( "WARNING!!! DustCloud: start equale destination" );
+    CAESARIA_LOG_DEBUG( "WARNING!!! DustCloud: start equale destination" );
     _d->dst = _d->from + TilePos( 1, 1 );
   }
 
@@ -216,7 +216,7 @@ void EnemySoldier::_check4attack()
   else
   {
     //impossible state, but...
-    Logger::warning( "EnemySoldier: can't find any path" );
+    CAESARIA_LOG_DEBUG( "EnemySoldier: can't find any path" );
     die();
   }
 }
@@ -106,7 +106,7 @@ void Patrician::_findNewWay( const TilePos& start )
   }
   else
   {
-    Logger::warning( "Patrician: cant find way" );
+    CAESARIA_LOG_DEBUG( "Patrician: cant find way" );
     die();
   }
 }
@@ -132,10 +132,10 @@ void TaxCollector::_reachedPathway()
       base()->applyService( this );
     }
 
-    Logger::warning( "TaxCollector: path history" );
+    CAESARIA_LOG_DEBUG( "TaxCollector: path history" );
     foreach( it, _d->history )
     {
-      Logger::warning( "       [%s]:%f", it->first.c_str(), it->second );
+      CAESARIA_LOG_DEBUG( "       [%s]:%f", it->first.c_str(), it->second );
     }
     deleteLater();
     return;
@@ -273,7 +273,7 @@ void Walker::_centerTile()
 void Walker::_reachedPathway()
 {
   _d->action.action = acNone;  // stop moving
-  _d->animation = Animation();
+  _d->animation.clear();
 }
 
 void Walker::_computeDirection()
@@ -329,7 +329,7 @@ void Walker::_waitFinished() { }
 
 Walker::Action Walker::action() const {  return (Walker::Action)_d->action.action;}
 bool Walker::isDeleted() const{   return _d->isDeleted;}
-void Walker::_changeDirection(){  _d->animation = Animation(); } // need to fetch the new animation
+void Walker::_changeDirection(){  _d->animation.clear(); } // need to fetch the new animation
 walker::Type Walker::type() const{ return _d->type; }
 Direction Walker::direction() const {  return _d->action.direction;}
 double Walker::health() const{  return _d->health;}
@@ -425,27 +425,8 @@ const Picture& Walker::getMainPicture()
 {
   if( !_d->animation.isValid() )
   {
-    const AnimationBank::MovementAnimation& animMap = AnimationBank::find( type() );
-    AnimationBank::MovementAnimation::const_iterator itAnimMap;
-    if( _d->action.direction == constants::noneDirection )
-    {
-      DirectedAction action = { _d->action.action, constants::north };
-      itAnimMap = animMap.find(action);
-    }
-    else
-    {
-      itAnimMap = animMap.find(_d->action);
-    }
-
-    if( itAnimMap != animMap.end() )
-    {
-      _d->animation = itAnimMap->second;
-    }
-    else
-    {
-      _d->animation = animMap.begin()->second;
-      Logger::warning( "Walker: wrong direction detected" );
-    }
+    // frames are shared with the bank, copy takes only playback state
+    _d->animation = AnimationBank::find( type(), _d->action );
   }
 
   return _d->animation.currentFrame();
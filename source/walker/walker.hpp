@@ -32,11 +32,13 @@
 #include "core/scopedptr.hpp"
 #include "predefinitions.hpp"
 #include "core/debug_queue.hpp"
+#include "core/objectpool.hpp"
 
 class Pathway;
 
 class Walker : public Serializable, public ReferenceCounted
 {
+  CAESARIA_POOL_ALLOCATED
 public:
   typedef unsigned int UniqueId;
   typedef enum { acNone=0, acMove, acFight, acDie, acWork, acMax } Action;
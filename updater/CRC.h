@@ -91,19 +91,18 @@ public:
 		if (fh == NULL) throw std::runtime_error("Could not open file: " + file.toString());
 
 		unsigned int crc = 0;
-		
+
+		// Read the file in 256kb chunks into one buffer
+		ByteArray buf;
+		buf.resize(256*1024);
+
 		while (true)
 		{
-			// Read the file in 32kb chunks
-			ByteArray buf;
-			buf.resize(32*1024);
-
-			size_t bytesRead = fread(buf.data(), 1, sizeof(buf), fh);
+			size_t bytesRead = fread(buf.data(), 1, buf.size(), fh);
 
 			if( bytesRead > 0 )
 			{
-				buf.resize( bytesRead );
-				crc = buf.crc32( crc );
+				crc = ByteArray::CRC32( crc, buf.data(), bytesRead );
 				continue;
 			}
 			
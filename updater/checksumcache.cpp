@@ -0,0 +1,115 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "checksumcache.hpp"
+#include "CRC.h"
+#include "core/logger.hpp"
+
+#include <sys/stat.h>
+#include <fstream>
+
+namespace updater
+{
+
+bool ChecksumCache::GetStamp(vfs::Path file, Stamp& stamp)
+{
+	struct stat attrib;
+	if( ::stat( file.toString().c_str(), &attrib ) != 0 )
+		return false;
+
+	stamp.size = attrib.st_size;
+	stamp.mtime = (long)attrib.st_mtime;
+	return true;
+}
+
+void ChecksumCache::Load(vfs::Path cacheFile)
+{
+	MutexLocker locker(&_mutex);
+
+	if( _cacheFile.toString() == cacheFile.toString() )
+		return;
+
+	_entries.clear();
+	_changed = false;
+	_cacheFile = cacheFile;
+
+	std::ifstream stream( cacheFile.toString().c_str() );
+	if( !stream.is_open() )
+		return;
+
+	// one entry per line: crc size mtime path
+	std::string line;
+	while( std::getline( stream, line ) )
+	{
+		char path[1024];
+		Entry entry;
+		unsigned long size;
+		if( sscanf( line.c_str(), "%x %lu %ld %1023[^\n]", &entry.crc, &size, &entry.stamp.mtime, path ) == 4 )
+		{
+			entry.stamp.size = size;
+			_entries[ path ] = entry;
+		}
+	}
+
+	Logger::warning( "ChecksumCache: loaded %d entries from %s", (int)_entries.size(), cacheFile.toString().c_str() );
+}
+
+void ChecksumCache::Save()
+{
+	MutexLocker locker(&_mutex);
+
+	if( !_changed || _cacheFile.toString().empty() )
+		return;
+
+	std::ofstream stream( _cacheFile.toString().c_str(), std::ios::trunc );
+	if( !stream.is_open() )
+	{
+		Logger::warning( "ChecksumCache: can't write " + _cacheFile.toString() );
+		return;
+	}
+
+	for( Entries::const_iterator i = _entries.begin(); i != _entries.end(); ++i )
+	{
+		stream << StringHelper::format( 0xff, "%x %lu %ld ", i->second.crc, (unsigned long)i->second.stamp.size, i->second.stamp.mtime )
+		       << i->first << "\n";
+	}
+
+	_changed = false;
+}
+
+unsigned int ChecksumCache::GetCrc(vfs::Path file, const Stamp& stamp)
+{
+	const std::string key = file.toString();
+
+	{
+		MutexLocker locker(&_mutex);
+		Entries::const_iterator i = _entries.find( key );
+		if( i != _entries.end() && i->second.stamp == stamp )
+			return i->second.crc;
+	}
+
+	// read file without lock, other threads go on with their files
+	Entry entry;
+	entry.stamp = stamp;
+	entry.crc = CRC::GetCrcForFile( file );
+
+	MutexLocker locker(&_mutex);
+	_entries[ key ] = entry;
+	_changed = true;
+
+	return entry.crc;
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_UPDATER_CHECKSUMCACHE_H_INCLUDE__
+#define __CAESARIA_UPDATER_CHECKSUMCACHE_H_INCLUDE__
+
+#include <map>
+#include <string>
+#include "vfs/path.hpp"
+#include "thread/mutex.hpp"
+
+namespace updater
+{
+
+/**
+ * Remembers CRCs of local files together with their size and modification time,
+ * so files which were not touched since the last run need not be read again.
+ * Lookups and updates may be called from several threads.
+ */
+class ChecksumCache
+{
+public:
+	ChecksumCache() : _changed(false) {}
+
+	// Size and modification time of a local file
+	struct Stamp
+	{
+		std::size_t size;
+		long mtime;
+
+		Stamp() : size(0), mtime(0) {}
+
+		bool operator==(const Stamp& other) const
+		{
+			return size == other.size && mtime == other.mtime;
+		}
+	};
+
+	// Reads the stamp of the given file, returns false if the file can't be stat'ed
+	static bool GetStamp(vfs::Path file, Stamp& stamp);
+
+	// Loads cached entries from the given file, does nothing if it was loaded already
+	void Load(vfs::Path cacheFile);
+
+	// Writes entries back to the file they were loaded from, if anything changed
+	void Save();
+
+	// Returns the CRC of the file, reading it only when the stamp has changed
+	// @throws: std::runtime_error if the file can't be read
+	unsigned int GetCrc(vfs::Path file, const Stamp& stamp);
+
+private:
+	struct Entry
+	{
+		Stamp stamp;
+		unsigned int crc;
+	};
+
+	typedef std::map<std::string, Entry> Entries;
+	Entries _entries;
+
+	vfs::Path _cacheFile;
+	bool _changed;
+	Mutex _mutex;
+};
+
+} // namespace
+
+#endif //__CAESARIA_UPDATER_CHECKSUMCACHE_H_INCLUDE__
@@ -471,6 +471,11 @@ void ConsoleUpdater::PrintProgress()
 	case ProgressInfo::FileDownload:	
 	{
 		line += " at " + Util::GetHumanReadableBytes( _info.downloadSpeed ) + "/sec ";
+
+		if (_info.filesToDownload > 1)
+		{
+			line += StringHelper::format( 0xff, "(%d files) ", (int)_info.filesToDownload );
+		}
 	}
 	break;
 
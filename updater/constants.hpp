@@ -52,6 +52,9 @@ const char* const UPDATE_UPDATER_BATCH_FILE = "update_updater.sh";
 
 const char* const TEMP_FILE_PREFIX = "__";
 
+// The file keeping CRCs of local files between runs
+const char* const LOCAL_CRC_CACHE_FILE = "crc_cache.txt";
+
 } // namespace
 
 #endif //__CAESARIA_UPDATERCONSTANTS_H_INLCUDE__
@@ -0,0 +1,278 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "deltapatch.hpp"
+#include "vfs/file.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+
+namespace updater
+{
+
+namespace
+{
+const char patchMagic[4] = { 'C', 'P', 'C', 'H' };
+const unsigned int blockSize = 4096;
+const std::size_t headerSize = 24;
+
+enum { opEnd='E', opCopy='C', opData='D' };
+
+void writeUint(ByteArray& out, unsigned int value)
+{
+	for (int k = 0; k < 4; k++)
+		out.push_back((char)((value >> (8 * k)) & 0xff));
+}
+
+bool readUint(const ByteArray& in, std::size_t& pos, unsigned int& value)
+{
+	if (pos + 4 > in.size())
+		return false;
+
+	const unsigned char* p = (const unsigned char*)in.data() + pos;
+	value = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+	pos += 4;
+	return true;
+}
+
+// rsync-like weak checksum, can be moved along data one byte at a time
+class RollingSum
+{
+public:
+	void reset(const unsigned char* data, unsigned int length)
+	{
+		a = b = 0;
+		for (unsigned int i = 0; i < length; i++)
+		{
+			a += data[i];
+			b += (length - i) * data[i];
+		}
+		len = length;
+	}
+
+	void roll(unsigned char out, unsigned char in)
+	{
+		a += in - out;
+		b += a - len * out;
+	}
+
+	unsigned int value() const { return (a & 0xffff) | (b << 16); }
+
+private:
+	unsigned int a, b, len;
+};
+
+typedef std::pair<unsigned int, unsigned int> BlockSum; // sum, block index
+
+class DeltaWriter
+{
+public:
+	ByteArray& out;
+	unsigned int copyBlock;
+	unsigned int copyCount;
+
+	DeltaWriter(ByteArray& patch) : out(patch), copyBlock(0), copyCount(0) {}
+
+	void copy(unsigned int block)
+	{
+		if (copyCount > 0 && copyBlock + copyCount == block)
+		{
+			copyCount++;
+			return;
+		}
+
+		flushCopy();
+		copyBlock = block;
+		copyCount = 1;
+	}
+
+	void data(const char* begin, const char* end)
+	{
+		if (begin == end)
+			return;
+
+		flushCopy();
+		out.push_back((char)opData);
+		writeUint(out, end - begin);
+		out.insert(out.end(), begin, end);
+	}
+
+	void flushCopy()
+	{
+		if (copyCount == 0)
+			return;
+
+		out.push_back((char)opCopy);
+		writeUint(out, copyBlock);
+		writeUint(out, copyCount);
+		copyCount = 0;
+	}
+};
+
+}
+
+const char* DeltaPatch::extension() { return ".patch"; }
+
+ByteArray DeltaPatch::create(const ByteArray& base, const ByteArray& target)
+{
+	ByteArray patch;
+	patch.insert(patch.end(), patchMagic, patchMagic + 4);
+	writeUint(patch, blockSize);
+	writeUint(patch, base.size());
+	writeUint(patch, ByteArray::CRC32(0, base.data(), base.size()));
+	writeUint(patch, target.size());
+	writeUint(patch, ByteArray::CRC32(0, target.data(), target.size()));
+
+	// sorted weak sums of all full blocks of base file
+	const unsigned char* old = (const unsigned char*)base.data();
+	std::vector<BlockSum> sums;
+	RollingSum sum;
+	for (unsigned int block = 0; (block + 1) * blockSize <= base.size(); block++)
+	{
+		sum.reset(old + block * blockSize, blockSize);
+		sums.push_back(BlockSum(sum.value(), block));
+	}
+	std::sort(sums.begin(), sums.end());
+
+	DeltaWriter writer(patch);
+	const char* data = target.data();
+	const std::size_t size = target.size();
+	std::size_t literal = 0;
+	std::size_t pos = 0;
+
+	if (!sums.empty() && size >= blockSize)
+	{
+		sum.reset((const unsigned char*)data, blockSize);
+		while (pos + blockSize <= size)
+		{
+			bool matched = false;
+			std::vector<BlockSum>::const_iterator it = std::lower_bound(sums.begin(), sums.end(), BlockSum(sum.value(), 0));
+			for (; it != sums.end() && it->first == sum.value(); ++it)
+			{
+				if (memcmp(old + it->second * blockSize, data + pos, blockSize) == 0)
+				{
+					writer.data(data + literal, data + pos);
+					writer.copy(it->second);
+					pos += blockSize;
+					literal = pos;
+					matched = true;
+					break;
+				}
+			}
+
+			if (matched)
+			{
+				if (pos + blockSize <= size)
+					sum.reset((const unsigned char*)data + pos, blockSize);
+				continue;
+			}
+
+			if (pos + blockSize < size)
+				sum.roll(data[pos], data[pos + blockSize]);
+			pos++;
+		}
+	}
+
+	writer.data(data + literal, data + size);
+	writer.flushCopy();
+	patch.push_back((char)opEnd);
+
+	return patch;
+}
+
+bool DeltaPatch::apply(const ByteArray& base, const ByteArray& patch, ByteArray& target)
+{
+	if (patch.size() < headerSize || memcmp(patch.data(), patchMagic, 4) != 0)
+		return false;
+
+	std::size_t pos = 4;
+	unsigned int patchBlock, baseSize, baseCrc, targetSize, targetCrc;
+	readUint(patch, pos, patchBlock);
+	readUint(patch, pos, baseSize);
+	readUint(patch, pos, baseCrc);
+	readUint(patch, pos, targetSize);
+	readUint(patch, pos, targetCrc);
+
+	if (patchBlock == 0 || baseSize != base.size()
+		|| baseCrc != ByteArray::CRC32(0, base.data(), base.size()))
+	{
+		return false;
+	}
+
+	target.clear();
+	target.reserve(targetSize);
+
+	while (pos < patch.size())
+	{
+		char op = patch[pos++];
+		unsigned int first, count;
+
+		switch (op)
+		{
+		case opEnd:
+			return target.size() == targetSize
+				   && ByteArray::CRC32(0, target.data(), target.size()) == targetCrc;
+
+		case opCopy:
+			if (!readUint(patch, pos, first) || !readUint(patch, pos, count)
+				|| ((std::size_t)first + count) * patchBlock > base.size())
+			{
+				return false;
+			}
+
+			target.insert(target.end(), base.begin() + first * patchBlock,
+						  base.begin() + (first + count) * patchBlock);
+		break;
+
+		case opData:
+			if (!readUint(patch, pos, count) || pos + count > patch.size())
+				return false;
+
+			target.insert(target.end(), patch.begin() + pos, patch.begin() + pos + count);
+			pos += count;
+		break;
+
+		default:
+			return false;
+		}
+	}
+
+	return false; // no end mark, patch is truncated
+}
+
+bool DeltaPatch::apply(vfs::Path baseFile, vfs::Path patchFile, vfs::Path outFile,
+					   unsigned int requiredCrc, std::size_t requiredSize)
+{
+	ByteArray base = vfs::NFile::open(baseFile).readAll();
+	ByteArray patch = vfs::NFile::open(patchFile).readAll();
+
+	ByteArray target;
+	if (!apply(base, patch, target))
+	{
+		Logger::warning("Patch %s doesn't fit %s", patchFile.toString().c_str(), baseFile.toString().c_str());
+		return false;
+	}
+
+	if (target.size() != requiredSize || ByteArray::CRC32(0, target.data(), target.size()) != requiredCrc)
+	{
+		Logger::warning("Patched file %s has wrong crc or size", baseFile.toString().c_str());
+		return false;
+	}
+
+	vfs::NFile out = vfs::NFile::open(outFile, vfs::Entity::fmWrite);
+	return out.write(target) == (int)target.size();
+}
+
+} // namespace
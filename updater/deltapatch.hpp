@@ -0,0 +1,53 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_UPDATER_DELTAPATCH_H_INCLUDE__
+#define __CAESARIA_UPDATER_DELTAPATCH_H_INCLUDE__
+
+#include "core/bytearray.hpp"
+#include "vfs/path.hpp"
+
+namespace updater
+{
+
+/**
+ * Binary patch between two versions of a file. The base file is cut in
+ * fixed blocks, the new file is scanned with a rolling checksum and every
+ * block found in the base is stored as a reference, the rest as literal data.
+ * Resource archives keep unchanged members byte for byte, so a patch for them
+ * is about the size of the changed members.
+ */
+class DeltaPatch
+{
+public:
+	// Extension of the patch files next to release files
+	static const char* extension();
+
+	// Creates a patch which turns base into target
+	static ByteArray create(const ByteArray& base, const ByteArray& target);
+
+	// Rebuilds target from base and patch. Returns false if the patch was made
+	// for another base or the result doesn't match the CRC stored in the patch.
+	static bool apply(const ByteArray& base, const ByteArray& patch, ByteArray& target);
+
+	// Applies the patch to baseFile and writes the result to outFile,
+	// if it has the required CRC and size
+	static bool apply(vfs::Path baseFile, vfs::Path patchFile, vfs::Path outFile,
+					  unsigned int requiredCrc, std::size_t requiredSize);
+};
+
+} // namespace
+
+#endif //__CAESARIA_UPDATER_DELTAPATCH_H_INCLUDE__
@@ -22,11 +22,160 @@
 
 #include "core/logger.hpp"
 #include "core/delegate.hpp"
+#include "core/foreach.hpp"
 #include "vfs/file.hpp"
 
+#include <fstream>
+
 namespace updater
 {
 
+namespace
+{
+// Files smaller than that are downloaded with one request
+const std::size_t minSegmentedSize = 4 * 1024 * 1024;
+const std::size_t minSegmentSize = 1024 * 1024;
+const std::size_t maxSegments = 4;
+}
+
+/**
+ * One byte range of a segmented download, received into its own part file
+ * on a separate thread. Data already in the part file is not requested again.
+ * Status and request are written by segment thread and read by the
+ * download thread and UI, so they are accessed under the segment lock.
+ */
+class DownloadSegment : public ReferenceCounted
+{
+public:
+	enum Status { WAITING, IN_PROGRESS, FAILED, SUCCESS };
+
+private:
+	Mutex _lock;
+	Status _status;
+	HttpRequestPtr _request;
+
+public:
+	HttpConnectionPtr conn;
+	std::vector<std::string> urls;
+	std::size_t urlIndex;
+	std::size_t first;
+	std::size_t last;
+	vfs::Path part;
+
+	bool stopped;
+	std::size_t resumedBytes;
+	ExceptionSafeThreadPtr thread;
+
+	DownloadSegment() : _status(WAITING), urlIndex(0), first(0), last(0), stopped(false), resumedBytes(0) {}
+
+	Status GetStatus()
+	{
+		MutexLocker locker(&_lock);
+		return _status;
+	}
+
+	void SetStatus(Status status)
+	{
+		MutexLocker locker(&_lock);
+		_status = status;
+	}
+
+	HttpRequestPtr GetRequest()
+	{
+		MutexLocker locker(&_lock);
+		return _request;
+	}
+
+	void SetRequest(HttpRequestPtr request)
+	{
+		MutexLocker locker(&_lock);
+		_request = request;
+	}
+
+	std::size_t length() const { return last - first + 1; }
+
+	std::size_t partSize() const
+	{
+		return part.exist() ? (std::size_t)vfs::NFile::size( part ) : 0;
+	}
+
+	std::size_t GetDownloadedBytes()
+	{
+		HttpRequestPtr r = GetRequest();
+		return resumedBytes + (r.isValid() ? r->GetDownloadedBytes() : 0);
+	}
+
+	double GetDownloadSpeed()
+	{
+		HttpRequestPtr r = GetRequest();
+		return r.isValid() && GetStatus() == IN_PROGRESS ? r->GetDownloadSpeed() : 0.0;
+	}
+
+	void Start()
+	{
+		SetStatus( IN_PROGRESS );
+		ExceptionSafeThreadPtr p( new ExceptionSafeThread( Delegate0<>( this, &DownloadSegment::perform ) ) );
+		p->SetThreadType( ThreadTypeIntervalDriven, 0 );
+		p->drop();
+		thread = p;
+	}
+
+	void Stop()
+	{
+		stopped = true;
+		HttpRequestPtr r = GetRequest();
+		if( r.isValid() )
+		{
+			r->Cancel();
+		}
+	}
+
+	void perform()
+	{
+		// every mirror gets one chance, starting with own one
+		for( std::size_t attempt = 0; attempt < urls.size() && !stopped; attempt++ )
+		{
+			resumedBytes = partSize();
+			if( resumedBytes > length() )
+			{
+				vfs::NFile::remove( part );
+				resumedBytes = 0;
+			}
+
+			if( resumedBytes == length() )
+			{
+				SetStatus( SUCCESS );
+				return;
+			}
+
+			HttpRequestPtr r = conn->createRequest( urls[ urlIndex ], part );
+			r->SetRange( first + resumedBytes, last );
+			SetRequest( r );
+			r->Perform();
+
+			// request aborts in headers when server ignores range, so part file stays valid,
+			// protocols without status line may still append whole file
+			bool rangeOk = r->GetResponseCode() == 206;
+			if( !rangeOk && partSize() > resumedBytes )
+			{
+				vfs::NFile::remove( part );
+			}
+
+			if( r->GetStatus() == HttpRequest::OK && rangeOk && partSize() == length() )
+			{
+				SetStatus( SUCCESS );
+				return;
+			}
+
+			Logger::warning( "Segment %lu-%lu of %s failed on %s", (unsigned long)first, (unsigned long)last,
+							 part.toString().c_str(), urls[ urlIndex ].c_str() );
+			urlIndex = (urlIndex + 1) % urls.size();
+		}
+
+		SetStatus( FAILED );
+	}
+};
+
 Download::Download(const HttpConnectionPtr& conn, const std::string& url, vfs::Path destFilename) :
 	_curUrl(0),
 	_destFilename(destFilename),
@@ -100,17 +249,25 @@ void Download::Start()
 
 void Download::Stop()
 {
-	if (_thread != NULL && _request != NULL)
+	if (_thread != NULL)
 	{
 		// Set the URL index beyond the list size to prevent 
 		// the worker thread from proceeding to the next URL
 		_curUrl = _urls.size();
 
-		// Cancel the request
-		_request->Cancel();
+		// Cancel the request, part files of segments are kept to resume later
+		{
+			MutexLocker locker(&_segmentsMutex);
+			if (_request != NULL)
+			{
+				_request->Cancel();
+			}
+
+			foreach( it, _segments ) { (*it)->Stop(); }
+			_request = HttpRequestPtr();
+		}
 
 		_thread = ExceptionSafeThreadPtr();
-		_request = HttpRequestPtr();
 
 		// Don't reset successful stati
 		if (_status != SUCCESS)
@@ -125,16 +282,43 @@ void Download::Stop()
 
 double Download::GetProgressFraction()
 {
+	MutexLocker locker(&_segmentsMutex);
+	if (!_segments.empty())
+	{
+		return _requiredFilesize > 0 ? static_cast<double>(_downloadedBytesLocked()) / _requiredFilesize : 0.0;
+	}
+
 	return _request != NULL ? _request->GetProgressFraction() : 0.0;
 }
 
 double Download::GetDownloadSpeed()
 {
+	MutexLocker locker(&_segmentsMutex);
+	if (!_segments.empty())
+	{
+		double speed = 0;
+		foreach( it, _segments ) { speed += (*it)->GetDownloadSpeed(); }
+		return speed;
+	}
+
 	return _request != NULL ? _request->GetDownloadSpeed() : 0.0;
 }
 
 std::size_t Download::GetDownloadedBytes()
 {
+	MutexLocker locker(&_segmentsMutex);
+	return _downloadedBytesLocked();
+}
+
+std::size_t Download::_downloadedBytesLocked()
+{
+	if (!_segments.empty())
+	{
+		std::size_t bytes = 0;
+		foreach( it, _segments ) { bytes += (*it)->GetDownloadedBytes(); }
+		return bytes;
+	}
+
 	return _request != NULL ? _request->GetDownloadedBytes() : 0;
 }
 
@@ -160,6 +344,22 @@ void Download::SetRequiredFilesize(std::size_t requiredSize)
 
 void Download::perform()
 {
+	if (isSegmentable())
+	{
+		if (performSegmented() && finishDownload())
+		{
+			return;
+		}
+
+		if (_curUrl >= _urls.size())
+		{
+			_status = FAILED;
+			return; // stopped
+		}
+
+		Logger::warning( "Segmented download of %s failed, trying single request", GetFilename().c_str() );
+	}
+
 	while (_curUrl < _urls.size())
 	{
 		// Remove any previous temporary file
@@ -167,43 +367,23 @@ void Download::perform()
 
 		const std::string& url = _urls[_curUrl];
 
-		// Create a new request
-		_request = _conn->createRequest(url, _tempFilename.toString());
+		// Create a new request, progress queries and Stop() use it from other thread
+		HttpRequestPtr request = _conn->createRequest(url, _tempFilename.toString());
+		{
+			MutexLocker locker(&_segmentsMutex);
+			_request = request;
+		}
 	
 		// Start the download, blocks until finished or aborted
-		_request->Perform();
+		request->Perform();
 
-		if (_request->GetStatus() == HttpRequest::OK)
+		if (request->GetStatus() == HttpRequest::OK)
 		{
-			// Check the downloaded file
-			bool valid = checkIntegrity();
-
-			if (!valid)
+			if (!finishDownload())
 			{
 				_curUrl++;
 				continue;
 			}
-			else
-			{
-				Logger::update( " CRC");
-			}
-
-			// Remove the destination filename before moving the temporary file over
-			vfs::NFile::remove( _destFilename );
-
-			// Move temporary file to the real one
-			if( vfs::NFile::rename( _tempFilename, _destFilename ) )
-			{
-				Logger::update( " REPLACE" );
-				_status = SUCCESS;
-			}
-			else
-			{
-				// Move failed
-				Logger::warning( "\nFailed renamed %s to %s ", _tempFilename.toString().c_str(),
-																										 _destFilename.toString().c_str() );
-				_status = FAILED;
-			}
 
 			// Download succeeded, exit the loop
 			break;
@@ -211,7 +391,7 @@ void Download::perform()
 		else 
 		{
 			// Download error
-			if (_request->GetStatus() == HttpRequest::ABORTED)
+			if (request->GetStatus() == HttpRequest::ABORTED)
 			{
 				Logger::warning(  "Download aborted.");
 			}
@@ -233,6 +413,137 @@ void Download::perform()
 	}
 }
 
+bool Download::finishDownload()
+{
+	// Check the downloaded file
+	if (!checkIntegrity())
+	{
+		return false;
+	}
+
+	Logger::update( " CRC");
+
+	// Remove the destination filename before moving the temporary file over
+	vfs::NFile::remove( _destFilename );
+
+	// Move temporary file to the real one
+	if( vfs::NFile::rename( _tempFilename, _destFilename ) )
+	{
+		Logger::update( " REPLACE" );
+		_status = SUCCESS;
+	}
+	else
+	{
+		// Move failed
+		Logger::warning( "\nFailed renamed %s to %s ", _tempFilename.toString().c_str(),
+																								 _destFilename.toString().c_str() );
+		_status = FAILED;
+	}
+
+	return true;
+}
+
+bool Download::isSegmentable() const
+{
+	return _filesizeCheckEnabled && _requiredFilesize >= minSegmentedSize && !_urls.empty();
+}
+
+bool Download::performSegmented()
+{
+	std::size_t count = std::min( maxSegments, _requiredFilesize / minSegmentSize );
+
+	// part files are valid only for the same file version and splitting
+	vfs::Path stateFile = _tempFilename.toString() + ".segments";
+	std::string state = StringHelper::format( 0xff, "%lu %x %lu", (unsigned long)_requiredFilesize,
+											  (unsigned int)_requiredCrc, (unsigned long)count );
+	std::string savedState;
+	{
+		std::ifstream in( stateFile.toString().c_str() );
+		std::getline( in, savedState );
+	}
+
+	std::vector<DownloadSegmentPtr> segments;
+	for (std::size_t k = 0; k < count; k++)
+	{
+		DownloadSegmentPtr segment( new DownloadSegment() );
+		segment->drop();
+		segment->conn = _conn;
+		segment->urls = _urls;
+		segment->urlIndex = (_curUrl + k) % _urls.size();
+		segment->first = _requiredFilesize * k / count;
+		segment->last = _requiredFilesize * (k + 1) / count - 1;
+		segment->part = _tempFilename.toString() + StringHelper::format( 0xff, ".part%d", (int)k );
+
+		if (savedState != state)
+		{
+			vfs::NFile::remove( segment->part );
+		}
+
+		segments.push_back( segment );
+	}
+
+	if (savedState != state)
+	{
+		std::ofstream out( stateFile.toString().c_str() );
+		out << state << std::endl;
+	}
+	else
+	{
+		Logger::warning( "Resuming download of %s", GetFilename().c_str() );
+	}
+
+	{
+		MutexLocker locker(&_segmentsMutex);
+		_segments = segments;
+	}
+
+	foreach( it, segments ) { (*it)->Start(); }
+
+	bool finished = false;
+	while (!finished)
+	{
+		Util::Wait(50);
+
+		finished = true;
+		foreach( it, segments )
+		{
+			finished &= ((*it)->GetStatus() != DownloadSegment::IN_PROGRESS);
+		}
+	}
+
+	bool allDone = (_curUrl < _urls.size());
+	foreach( it, segments )
+	{
+		allDone &= ((*it)->GetStatus() == DownloadSegment::SUCCESS);
+	}
+
+	if (!allDone)
+	{
+		MutexLocker locker(&_segmentsMutex);
+		_segments.clear();
+		return false;
+	}
+
+	// join parts into temporary file
+	{
+		std::ofstream out( _tempFilename.toString().c_str(), std::ofstream::out|std::ofstream::binary|std::ofstream::trunc );
+		foreach( it, segments )
+		{
+			std::ifstream in( (*it)->part.toString().c_str(), std::ifstream::in|std::ifstream::binary );
+			out << in.rdbuf();
+		}
+	}
+
+	foreach( it, segments ) { vfs::NFile::remove( (*it)->part ); }
+	vfs::NFile::remove( stateFile );
+
+	// progress is taken from the whole file from now on
+	MutexLocker locker(&_segmentsMutex);
+	_segments.clear();
+
+	return true;
+}
+
 vfs::Path Download::GetDestFilename() const
 {
 	return _destFilename;
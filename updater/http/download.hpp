@@ -20,6 +20,7 @@
 #include "httprequest.hpp"
 #include "vfs/path.hpp"
 #include "core/smartptr.hpp"
+#include "thread/mutex.hpp"
 #include "../updater/exceptionsafethread.hpp"
 
 
@@ -44,7 +45,14 @@ namespace updater
  * in the temporary file. The temporary file is named the same
  * as the destination filename, but with a prefixed underscore character:
  * e.g. target/directory/_download.pk4
+ *
+ * Large files with known size are fetched in several HTTP ranges at once,
+ * each range from its own mirror. Ranges are kept in part files next to the
+ * temporary file, so an interrupted download continues where it stopped.
  */
+class DownloadSegment;
+typedef SmartPtr<DownloadSegment> DownloadSegmentPtr;
+
 class Download : public ReferenceCounted
 {
 protected:
@@ -85,6 +93,10 @@ protected:
 	std::size_t _requiredFilesize;
 	std::size_t _requiredCrc;
 
+	// Ranges of a segmented download, empty for single request
+	std::vector<DownloadSegmentPtr> _segments;
+	Mutex _segmentsMutex;
+
 public:
 	/** 
 	 * greebo: Construct a new Download using the given URL.
@@ -148,6 +160,19 @@ protected:
 
 	// Check method
 	bool checkIntegrity();
+
+	// Checks the temporary file and moves it to the destination
+	bool finishDownload();
+
+	// Fetches the file in ranges and joins them into the temporary file,
+	// returns false if any range failed
+	bool performSegmented();
+
+	// True if the file is worth splitting into ranges
+	bool isSegmentable() const;
+
+	// Downloaded bytes, caller must hold _segmentsMutex
+	std::size_t _downloadedBytesLocked();
 };
 typedef SmartPtr<Download> DownloadPtr;
 
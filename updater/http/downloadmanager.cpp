@@ -22,7 +22,8 @@ namespace updater
 
 DownloadManager::DownloadManager() :
 	_nextAvailableId(1),
-	_allDownloadsDone(true)
+	_allDownloadsDone(true),
+	_maxActiveDownloads(3)
 {}
 
 int DownloadManager::AddDownload(const DownloadPtr& download)
@@ -102,23 +103,59 @@ void DownloadManager::ProcessDownloads()
 		return; // nothing to do
 	}
 
-	if (DownloadInProgress())
+	std::size_t active = GetActiveDownloadsCount();
+
+	// Fill free slots with new downloads from the queue
+	for (Downloads::const_iterator i = _downloads.begin();
+		 i != _downloads.end() && active < _maxActiveDownloads; ++i)
+	{
+		if (i->second->GetStatus() == Download::NOT_STARTED_YET)
+		{
+			i->second->Start();
+			active++;
+		}
+	}
+
+	if (active == 0)
+	{
+		// No download left to handle
+		_allDownloadsDone = true;
+	}
+}
+
+void DownloadManager::SetMaxActiveDownloads(std::size_t count)
+{
+	_maxActiveDownloads = count > 0 ? count : 1;
+}
+
+std::size_t DownloadManager::GetActiveDownloadsCount()
+{
+	std::size_t count = 0;
+
+	for (Downloads::const_iterator i = _downloads.begin(); i != _downloads.end(); ++i)
 	{
-		return; // download still in progress
+		if (i->second->GetStatus() == Download::IN_PROGRESS)
+		{
+			count++;
+		}
 	}
 
-	// No download in progress, pick a new from the queue
+	return count;
+}
+
+double DownloadManager::GetTotalDownloadSpeed()
+{
+	double speed = 0;
+
 	for (Downloads::const_iterator i = _downloads.begin(); i != _downloads.end(); ++i)
 	{
-		if (i->second->GetStatus() == Download::NOT_STARTED_YET)
+		if (i->second->GetStatus() == Download::IN_PROGRESS)
 		{
-			i->second->Start();
-			return;
+			speed += i->second->GetDownloadSpeed();
 		}
 	}
 
-	// No download left to handle
-	_allDownloadsDone = true;
+	return speed;
 }
 
 bool DownloadManager::HasFailedDownloads()
@@ -45,6 +45,9 @@ private:
 
 	bool _allDownloadsDone;
 
+	// How many downloads may run at the same time
+	std::size_t _maxActiveDownloads;
+
 public:
 	DownloadManager();
 
@@ -72,6 +75,15 @@ public:
 	// Returns true if one or more downloads have failed status
 	bool HasFailedDownloads();
 
+	// Number of downloads running at the same time, at least one
+	void SetMaxActiveDownloads(std::size_t count);
+
+	// Number of downloads currently in progress
+	std::size_t GetActiveDownloadsCount();
+
+	// Summed speed of all downloads in progress, in bytes/sec
+	double GetTotalDownloadSpeed();
+
 	// Iterate over all registered downloads
 	void ForeachDownload(DownloadVisitor& visitor);
 };
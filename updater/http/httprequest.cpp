@@ -17,6 +17,7 @@
 #include "httpconnection.hpp"
 
 #include <cstring>
+#include <cstdlib>
 #include "core/logger.hpp"
 #include "core/stringhelper.hpp"
 #include "../constants.hpp"
@@ -40,7 +41,9 @@ HttpRequest::HttpRequest(HttpConnection& conn, const std::string& url) :
 	_cancelFlag(false),
 	_progress(0),
 	_downloadedBytes(0),
-	_showDebugInfo( false )
+	_showDebugInfo( false ),
+	_appendToFile( false ),
+	_responseCode( 0 )
 {}
 
 HttpRequest::HttpRequest(HttpConnection& conn, const std::string& url, vfs::Path destFilename) :
@@ -52,7 +55,9 @@ HttpRequest::HttpRequest(HttpConnection& conn, const std::string& url, vfs::Path
 	_cancelFlag(false),
 	_progress(0),
 	_downloadedBytes(0),
-	_showDebugInfo( false )
+	_showDebugInfo( false ),
+	_appendToFile( false ),
+	_responseCode( 0 )
 {}
 
 void HttpRequest::InitRequest()
@@ -76,6 +81,15 @@ void HttpRequest::InitRequest()
 	// We pass ourselves as user data pointer to the callback function
 	curl_easy_setopt(_handle, CURLOPT_WRITEDATA, this);
 
+	if( !_range.empty() )
+	{
+		curl_easy_setopt(_handle, CURLOPT_RANGE, _range.c_str());
+
+		// check that server honours the range before any data is written
+		curl_easy_setopt(_handle, CURLOPT_HEADERFUNCTION, HttpRequest::HeaderCallback);
+		curl_easy_setopt(_handle, CURLOPT_HEADERDATA, this);
+	}
+
 	// Set agent
 	std::string agent = StringHelper::format( 0xff, "Caesaria Updater v%s/%s",
 																									LIB_UPDATE_VERSION,
@@ -112,16 +126,25 @@ void HttpRequest::Perform()
 	InitRequest();
 
 	_progress = 0;
+	_responseCode = 0;
 	_status = IN_PROGRESS;
 
 	// Check target file
 	if (!_destFilename.toString().empty())
 	{
-		_destStream.open(_destFilename.toString().c_str(), std::ofstream::out|std::ofstream::binary);
+		std::ios_base::openmode mode = std::ofstream::out|std::ofstream::binary;
+		if( _appendToFile )
+		{
+			mode |= std::ofstream::app;
+		}
+
+		_destStream.open(_destFilename.toString().c_str(), mode);
 	}
 
 	CURLcode result = curl_easy_perform(_handle);
 
+	curl_easy_getinfo(_handle, CURLINFO_RESPONSE_CODE, &_responseCode);
+
 	if (!_destFilename.toString().empty())
 	{
 		_destStream.flush();
@@ -170,6 +193,17 @@ std::string HttpRequest::GetErrorMessage()
 	return _errorMessage;
 }
 
+void HttpRequest::SetRange(std::size_t first, std::size_t last)
+{
+	_range = StringHelper::format( 0xff, "%lu-%lu", (unsigned long)first, (unsigned long)last );
+	_appendToFile = true;
+}
+
+long HttpRequest::GetResponseCode()
+{
+	return _responseCode;
+}
+
 double HttpRequest::GetProgressFraction()
 {
 	return _progress;
@@ -262,6 +296,32 @@ size_t HttpRequest::WriteMemoryCallback(void* ptr, size_t size, size_t nmemb, Ht
 	return static_cast<size_t>(bytesToCopy);
 }
 
+size_t HttpRequest::HeaderCallback(char* ptr, size_t size, size_t nmemb, HttpRequest* self)
+{
+	std::size_t length = size * nmemb;
+	std::string line( ptr, length );
+
+	if( line.compare( 0, 5, "HTTP/" ) == 0 )
+	{
+		// status line comes for every response, redirects included
+		std::size_t space = line.find( ' ' );
+		self->_responseCode = (space != std::string::npos) ? atol( line.c_str() + space + 1 ) : 0;
+	}
+	else if( line == "\r\n" || line == "\n" )
+	{
+		// headers of final response are done, server which ignores range
+		// would send whole file into part file, so transfer is aborted here
+		bool interim = self->_responseCode < 200 || (self->_responseCode >= 300 && self->_responseCode < 400);
+		if( !interim && self->_responseCode != 206 )
+		{
+			Logger::warning( "Server ignores range, response code %ld", self->_responseCode );
+			return 0;
+		}
+	}
+
+	return length;
+}
+
 size_t HttpRequest::WriteFileCallback(void* ptr, size_t size, size_t nmemb, HttpRequest* self)
 {
 	// Needed size
@@ -78,6 +78,14 @@ private:
 	std::string _errorMessage;
 	bool _showDebugInfo;
 
+	// Requested byte range "first-last", empty for whole file
+	std::string _range;
+
+	// Keep data already in destination file and write after it
+	bool _appendToFile;
+
+	long _responseCode;
+
 public:
 	HttpRequest(HttpConnection& conn, const std::string& url);
 
@@ -86,6 +94,7 @@ public:
 	// Callbacks for CURL
 	static size_t WriteMemoryCallback(void* ptr, size_t size, size_t nmemb, HttpRequest* self);
 	static size_t WriteFileCallback(void* ptr, size_t size, size_t nmemb, HttpRequest* self);
+	static size_t HeaderCallback(char* ptr, size_t size, size_t nmemb, HttpRequest* self);
 
 	RequestStatus GetStatus();
 
@@ -109,6 +118,12 @@ public:
 	// If GetStatus == FAILED, this holds the curl error
 	std::string GetErrorMessage();
 
+	// Requests only bytes [first..last] of the file, appending them to the destination file
+	void SetRange(std::size_t first, std::size_t last);
+
+	// HTTP status of the response, 206 if the server honoured the range
+	long GetResponseCode();
+
 private:
 	void InitRequest();
 
@@ -50,6 +50,7 @@ int main(int argc, char* argv[])
         std::string basedir = localOptions.get( "directory" );
         std::string version = localOptions.get( "version" );
 		Packager p( basedir, version );
+		p.setPreviousRelease( localOptions.get( "previous" ) );
 
 		p.createUpdate( localOptions.isSet( "release" ) );
 
@@ -3,6 +3,7 @@
 #include "constants.hpp"
 #include "util.hpp"
 #include "inifile.hpp"
+#include "deltapatch.hpp"
 #include "core/stringhelper.hpp"
 
 #include "vfs/file.hpp"
@@ -10,6 +11,7 @@
 #include "vfs/entries.hpp"
 #include "vfs/entryinfo.hpp"
 #include "core/foreach.hpp"
+#include "core/logger.hpp"
 
 namespace updater
 {
@@ -52,10 +54,43 @@ std::string getFilePlatforms(vfs::Path &path) {
   return "";
 }
 
+void Packager::setPreviousRelease(std::string folder)
+{
+  _previous = folder;
+}
+
+// patch is stored only when it saves most of the download
+static void __createPatch( vfs::Directory previous, vfs::Path file, const ByteArray& data,
+                           unsigned int crc, IniFilePtr vinfo, const std::string& sectionName )
+{
+  vfs::Path prevFile = previous.getFilePath( file );
+  if( !prevFile.exist() )
+    return;
+
+  ByteArray base = vfs::NFile::open( prevFile ).readAll();
+  if( base.crc32( 0 ) == crc )
+    return;
+
+  ByteArray patch = DeltaPatch::create( base, data );
+  if( patch.size() > data.size() / 2 )
+    return;
+
+  std::string patchName = file.toString() + DeltaPatch::extension();
+  vfs::NFile::open( patchName, vfs::Entity::fmWrite ).write( patch );
+
+  vinfo->SetValue( sectionName, "patch", patchName );
+  vinfo->SetValue( sectionName, "patchfrom", StringHelper::format( 0xff, "%x", base.crc32( 0 ) ) );
+  vinfo->SetValue( sectionName, "patchcrc", StringHelper::format( 0xff, "%x", patch.crc32( 0 ) ) );
+  vinfo->SetValue( sectionName, "patchsize", StringHelper::format( 0xff, "%d", patch.size() ) );
+  Logger::warning( "Packager: patch %s %d bytes instead of %d", patchName.c_str(), patch.size(), data.size() );
+}
+
 void Packager::createUpdate( bool release )
 {
   FilePathList allFiles;
 
+  vfs::Directory previous = vfs::Path( _previous ).absolutePath();
+
   vfs::Directory::changeCurrentDir( _baseset );
   vfs::Directory dir = vfs::Directory::getCurrent();
 
@@ -67,7 +102,8 @@ void Packager::createUpdate( bool release )
   {
     std::string baseName = (*i).toString();
     if( baseName == STABLE_VERSION_FILE ||
-        baseName == UPDATE_VERSION_FILE )
+        baseName == UPDATE_VERSION_FILE ||
+        (*i).isMyExtension( DeltaPatch::extension() ) )
     {
         continue;
     }
@@ -87,6 +123,11 @@ void Packager::createUpdate( bool release )
     unsigned int crc = data.crc32( 0 );
     vinfo->SetValue( sectionName, "crc", StringHelper::format( 0xff, "%x", crc ) );
     vinfo->SetValue( sectionName, "filesize", StringHelper::format( 0xff, "%d", data.size() ) );
+
+    if( !_previous.empty() )
+    {
+      __createPatch( previous, *i, data, crc, vinfo, sectionName );
+    }
     // Add platforms information info release file
     std::string platforms = getFilePlatforms(*i);
     if (!platforms.empty()) {
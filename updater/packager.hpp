@@ -13,9 +13,13 @@ public:
 
   void createUpdate(bool release);
 
+  // files of this folder are used as base for binary patches
+  void setPreviousRelease( std::string folder );
+
 private:
   std::string _baseset;
   std::string _crver;
+  std::string _previous;
 };
 
 }
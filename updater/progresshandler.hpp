@@ -70,10 +70,10 @@ public:
 		progress.file = info.file;
 		progress.progressFraction = info.progressFraction > 1.0 ? 1.0 : info.progressFraction;
 		progress.mirrorDisplayName = info.mirrorDisplayName;
-		progress.downloadSpeed = info.downloadSpeed;
+		progress.downloadSpeed = info.totalDownloadSpeed;
 		progress.downloadedBytes = info.downloadedBytes;
 		progress.bytesToDownload = 0;
-		progress.filesToDownload = 1;
+		progress.filesToDownload = info.activeDownloads;
 
 		_view.onProgressChange(progress);
 
@@ -25,6 +25,15 @@ void ReleaseFileSet::Visitor::VisitSection(const IniFile& iniFile, const std::st
 					result.first->second.crc = CRC::ParseFromString(iniFile.GetValue(section, "crc"));
 					result.first->second.filesize = StringHelper::toUint( iniFile.GetValue(section, "filesize") );
 
+					std::string patch = iniFile.GetValue(section, "patch");
+					if( !patch.empty() )
+					{
+						result.first->second.patch = patch;
+						result.first->second.patchBaseCrc = CRC::ParseFromString(iniFile.GetValue(section, "patchfrom"));
+						result.first->second.patchCrc = CRC::ParseFromString(iniFile.GetValue(section, "patchcrc"));
+						result.first->second.patchsize = StringHelper::toUint( iniFile.GetValue(section, "patchsize") );
+					}
+
 					if( filename.isMyExtension( ".zip") )
 					{
 						result.first->second.isArchive = true;
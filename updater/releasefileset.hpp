@@ -50,17 +50,38 @@ struct ReleaseFile
 	// The download ID of this file (-1 == no download ID)
 	int downloadId;
 
+	// Binary patch from the previous release (empty == no patch)
+	std::string patch;
+
+	// CRC of the previous release file the patch applies to
+	unsigned int patchBaseCrc;
+
+	// CRC and size of the patch file itself
+	unsigned int patchCrc;
+	std::size_t patchsize;
+
+	// True if the patch is downloaded instead of the whole file
+	bool usePatch;
+
 	ReleaseFile() :
 		isArchive(false),
 		localChangesAllowed(false),
-		downloadId(-1)
+		downloadId(-1),
+		patchBaseCrc(0),
+		patchCrc(0),
+		patchsize(0),
+		usePatch(false)
 	{}
 
 	ReleaseFile(vfs::Path pathToFile) :
 		isArchive(false),
 		file(pathToFile),
 		localChangesAllowed(false),
-		downloadId(-1)
+		downloadId(-1),
+		patchBaseCrc(0),
+		patchCrc(0),
+		patchsize(0),
+		usePatch(false)
 	{}
 
 	ReleaseFile(vfs::Path pathToFile, unsigned int crc_) :
@@ -68,7 +89,11 @@ struct ReleaseFile
 		file(pathToFile),
 		crc(crc_),
 		localChangesAllowed(false),
-		downloadId(-1)
+		downloadId(-1),
+		patchBaseCrc(0),
+		patchCrc(0),
+		patchsize(0),
+		usePatch(false)
 	{}
 
 	// Implement less operator for use in std::set or std::map
@@ -114,6 +139,12 @@ struct ReleaseFile
         return false;
     }
 
+	// Number of bytes which will be downloaded for this file
+	std::size_t GetDownloadSize() const
+	{
+		return usePatch ? patchsize : filesize;
+	}
+
 	bool isUpdater(const std::string& executable) const
 	{
 		return StringHelper::isEquale( file.toString(), executable );
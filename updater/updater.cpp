@@ -21,6 +21,8 @@
 #include "constants.hpp"
 #include "core/foreach.hpp"
 #include "util.hpp"
+#include "thread/workerpool.hpp"
+#include "deltapatch.hpp"
 
 #if defined(CAESARIA_PLATFORM_UNIX) || defined(CAESARIA_PLATFORM_HAIKU)
   #include <limits.h>
@@ -48,6 +50,7 @@ Updater::Updater(const UpdaterOptions& options, vfs::Path executable) :
   _ignoreList.insert(STABLE_VERSION_FILE);
   _ignoreList.insert(UPDATE_VERSION_FILE);
   _ignoreList.insert(CAESARIA_MIRRORS_INFO);
+  _ignoreList.insert(LOCAL_CRC_CACHE_FILE);
 
 	MirrorDownload::InitRandomizer();
 
@@ -249,6 +252,8 @@ void Updater::DetermineLocalVersion()
 
 	std::size_t curItem = 0;
 
+	LoadCrcCache();
+
 	for (ReleaseVersions::const_iterator v = _releaseVersions.begin(); v != _releaseVersions.end(); ++v)
 	{
 		Logger::warning( "Trying to match against version: %s", v->first.c_str() );
@@ -286,7 +291,9 @@ void Updater::DetermineLocalVersion()
 				continue;
 			}
 
-			std::size_t candidateFilesize = vfs::NFile::size( candidate );
+			ChecksumCache::Stamp stamp;
+			ChecksumCache::GetStamp( candidate, stamp );
+			std::size_t candidateFilesize = stamp.size;
 
 			if (candidateFilesize != f->second.filesize)
 			{
@@ -298,7 +305,7 @@ void Updater::DetermineLocalVersion()
 			// Calculate the CRC of this file
       if (!_options.isSet("no-crc"))
       {
-        unsigned int crc = CRC::GetCrcForFile(candidate);
+        unsigned int crc = _crcCache.GetCrc(candidate, stamp);
 
         if (crc != f->second.crc)
         {
@@ -335,6 +342,8 @@ void Updater::DetermineLocalVersion()
 
 	Logger::warning( "The local files are matching %d different versions.", _localVersions.size() );
 
+	_crcCache.Save();
+
 	if (_fileProgressCallback != NULL)
 	{
 		_fileProgressCallback->OnFileOperationFinish();
@@ -467,6 +476,59 @@ vfs::Directory Updater::getTargetDir()
 	return targetPath;
 }
 
+// Takes files from shared list one by one, so a few large files
+// don't leave other threads idle
+class Updater::CheckFilesTask : public CTask
+{
+public:
+	struct Check
+	{
+		ReleaseFileSet::const_iterator file;
+		bool ok;
+		std::string error;
+	};
+
+	Updater* updater;
+	vfs::Path installPath;
+	std::vector<Check>* checks;
+	Mutex* mutex;
+	std::size_t* next;
+	std::size_t end;
+
+	virtual bool task()
+	{
+		while (true)
+		{
+			std::size_t index;
+			{
+				MutexLocker locker(mutex);
+				index = (*next)++;
+			}
+
+			if (index >= end)
+				break;
+
+			Check& check = (*checks)[index];
+			try
+			{
+				check.ok = updater->CheckLocalFile(installPath, check.file->second);
+			}
+			catch (std::runtime_error& ex)
+			{
+				check.ok = false;
+				check.error = ex.what();
+			}
+		}
+
+		return true;
+	}
+};
+
+void Updater::LoadCrcCache()
+{
+	_crcCache.Load( getTargetDir().getFilePath( LOCAL_CRC_CACHE_FILE ) );
+}
+
 void Updater::CheckLocalFiles()
 {
 	_downloadQueue.clear();
@@ -476,27 +538,76 @@ void Updater::CheckLocalFiles()
 
 	Logger::warning( "Checking target folder: " + targetDir.toString() );
 
-	std::size_t count = 0;
+	LoadCrcCache();
+
+	std::vector<CheckFilesTask::Check> checks;
 	for (ReleaseFileSet::const_iterator i = _latestRelease.begin(); i != _latestRelease.end(); ++i)
 	{
-		if (_fileProgressCallback != NULL)
-		{
-			CurFileInfo info;
-			info.operation = CurFileInfo::Check;
-			info.file = i->second.file;
-			info.progressFraction = static_cast<double>(count) / _latestRelease.size();
+		CheckFilesTask::Check check;
+		check.file = i;
+		check.ok = true;
+		checks.push_back(check);
+	}
+
+	WorkerPool& pool = WorkerPool::instance();
+	Mutex mutex;
+	std::size_t next = 0;
+
+	std::vector<CheckFilesTask*> tasks;
+	for (unsigned int k = 0; k < pool.concurrency(); k++)
+	{
+		CheckFilesTask* task = new CheckFilesTask();
+		task->updater = this;
+		task->installPath = targetDir;
+		task->checks = &checks;
+		task->mutex = &mutex;
+		task->next = &next;
+		tasks.push_back(task);
+	}
+
+	// Files are checked in batches, so progress is reported while the check goes on
+	const std::size_t batchSize = pool.concurrency() * 4;
+	std::string error;
+	for (std::size_t first = 0; first < checks.size() && error.empty(); first += batchSize)
+	{
+		std::size_t last = std::min(first + batchSize, checks.size());
 
-			_fileProgressCallback->OnFileOperationProgress(info);
+		next = first;
+		WorkerPool::Tasks ptasks;
+		foreach (it, tasks)
+		{
+			(*it)->end = last;
+			ptasks.push_back(*it);
 		}
 
-		//Logger::warning( "Checking for file: " + i->second.file.toString() + "...");
-		if( !CheckLocalFile(targetDir, i->second) )
+		pool.execute(ptasks);
+
+		for (std::size_t k = first; k < last; k++)
 		{
-			// A member is missing or out of date, mark the archive for download
-			_downloadQueue.insert(*i);
+			const CheckFilesTask::Check& check = checks[k];
+			NotifyFileProgress(check.file->second.file, CurFileInfo::Check, static_cast<double>(k) / checks.size());
+
+			if (!check.error.empty())
+			{
+				error = check.error;
+				break;
+			}
+
+			if (!check.ok)
+			{
+				// A member is missing or out of date, mark the archive for download
+				_downloadQueue.insert(*check.file);
+			}
 		}
+	}
 
-		count++;
+	foreach (it, tasks) { delete *it; }
+
+	_crcCache.Save();
+
+	if (!error.empty())
+	{
+		throw std::runtime_error(error);
 	}
 
 	if (_fileProgressCallback != NULL)
@@ -531,26 +642,25 @@ bool Updater::CheckLocalFile(vfs::Path installPath, const ReleaseFile& releaseFi
     return true; // ignore this file
   }
 
-  if (!localFile.exist())
+  ChecksumCache::Stamp stamp;
+  if (!ChecksumCache::GetStamp(localFile, stamp))
   {
     Logger::warning("MISSING");
     return false;
   }
   // File exists
   // Compare file size
-  std::size_t fileSize = vfs::NFile::size(localFile);
-
-  if (fileSize != releaseFile.filesize)
+  if (stamp.size != releaseFile.filesize)
   {
     Logger::warning("SIZE MISMATCH");
     return false;
   }
   // Size is matching
 
-  // Check CRC if not disabled
+  // Check CRC if not disabled, unchanged files take it from cache
   if (!_options.isSet("no-crc"))
   {
-    unsigned int existingCrc = CRC::GetCrcForFile(localFile);
+    unsigned int existingCrc = _crcCache.GetCrc(localFile, stamp);
 
     if (existingCrc != releaseFile.crc)
     {
@@ -570,23 +680,129 @@ bool Updater::LocalFilesNeedUpdate()
 
 void Updater::PrepareUpdateStep(std::string prefix)
 {
-	vfs::Directory targetdir = getTargetDir();
+	LoadCrcCache();
 
-  // Create a download for each of the files
+  // Create a download for each of the files, a patch is enough when local file is the previous release
   foreach( i, _downloadQueue )
 	{
-		DownloadPtr download(new MirrorDownload(_conn, _mirrors, i->second.file.toString(), targetdir.getFilePath(prefix+i->second.file.toString() ) )) ;
+		i->second.usePatch = prefix.empty() && IsPatchApplicable(i->second);
+		if (i->second.usePatch)
+		{
+			AddPatchDownload(i->second);
+		}
+		else
+		{
+			AddFullDownload(i->second, prefix);
+		}
+	}
+}
 
-    download->EnableCrcCheck(!_options.isSet("no-crc"));
-    download->EnableFilesizeCheck( true );
-    download->SetRequiredCrc( i->second.crc );
-    download->SetRequiredFilesize( i->second.filesize );
+bool Updater::IsPatchApplicable(const ReleaseFile& releaseFile)
+{
+	if (releaseFile.patch.empty())
+	{
+		return false;
+	}
 
-		i->second.downloadId = _downloadManager->AddDownload(download);
+	vfs::Path localFile = getTargetDir().getFilePath(releaseFile.file);
+
+	ChecksumCache::Stamp stamp;
+	if (!ChecksumCache::GetStamp(localFile, stamp))
+	{
+		return false;
+	}
+
+	try
+	{
+		return _crcCache.GetCrc(localFile, stamp) == releaseFile.patchBaseCrc;
+	}
+	catch (std::runtime_error&)
+	{
+		return false;
 	}
 }
 
-void Updater::PerformUpdateStep()
+void Updater::AddFullDownload(ReleaseFile& releaseFile, const std::string& prefix)
+{
+	vfs::Directory targetdir = getTargetDir();
+	DownloadPtr download(new MirrorDownload(_conn, _mirrors, releaseFile.file.toString(), targetdir.getFilePath(prefix+releaseFile.file.toString() ) )) ;
+
+	download->EnableCrcCheck(!_options.isSet("no-crc"));
+	download->EnableFilesizeCheck( true );
+	download->SetRequiredCrc( releaseFile.crc );
+	download->SetRequiredFilesize( releaseFile.filesize );
+
+	releaseFile.downloadId = _downloadManager->AddDownload(download);
+}
+
+void Updater::AddPatchDownload(ReleaseFile& releaseFile)
+{
+	vfs::Directory targetdir = getTargetDir();
+	DownloadPtr download(new MirrorDownload(_conn, _mirrors, releaseFile.patch, targetdir.getFilePath(releaseFile.patch) )) ;
+
+	download->EnableCrcCheck( true );
+	download->EnableFilesizeCheck( true );
+	download->SetRequiredCrc( releaseFile.patchCrc );
+	download->SetRequiredFilesize( releaseFile.patchsize );
+
+	releaseFile.downloadId = _downloadManager->AddDownload(download);
+}
+
+bool Updater::ApplyDownloadedPatches()
+{
+	bool fallback = false;
+	vfs::Directory targetdir = getTargetDir();
+
+	std::size_t count = 0;
+	foreach( i, _downloadQueue )
+	{
+		count++;
+		ReleaseFile& releaseFile = i->second;
+		if (!releaseFile.usePatch)
+		{
+			continue;
+		}
+
+		NotifyFileProgress(releaseFile.file, CurFileInfo::Replace, static_cast<double>(count) / _downloadQueue.size());
+
+		DownloadPtr download = _downloadManager->GetDownload(releaseFile.downloadId);
+		vfs::Path localFile = targetdir.getFilePath(releaseFile.file);
+		vfs::Path patchFile = targetdir.getFilePath(releaseFile.patch);
+		vfs::Path patchedFile = targetdir.getFilePath(TEMP_FILE_PREFIX + releaseFile.file.toString());
+
+		bool patched = download.isValid() && download->GetStatus() == Download::SUCCESS
+					   && DeltaPatch::apply(localFile, patchFile, patchedFile, releaseFile.crc, releaseFile.filesize);
+
+		vfs::NFile::remove( patchFile );
+
+		if (patched)
+		{
+			vfs::NFile::remove( localFile );
+			patched = vfs::NFile::rename( patchedFile, localFile );
+		}
+
+		if (!patched)
+		{
+			// Broken patch or local file, take the whole file
+			Logger::warning( "Can't patch %s, downloading whole file", releaseFile.file.toString().c_str() );
+			vfs::NFile::remove( patchedFile );
+
+			_downloadManager->RemoveDownload(releaseFile.downloadId);
+			releaseFile.usePatch = false;
+			AddFullDownload(releaseFile, "");
+			fallback = true;
+		}
+	}
+
+	if (_fileProgressCallback != NULL)
+	{
+		_fileProgressCallback->OnFileOperationFinish();
+	}
+
+	return fallback;
+}
+
+void Updater::WaitForDownloads()
 {
 	// Wait until the download is done
 	while (_downloadManager->HasPendingDownloads())
@@ -607,6 +823,17 @@ void Updater::PerformUpdateStep()
 
 		Util::Wait(100);
 	}
+}
+
+void Updater::PerformUpdateStep()
+{
+	WaitForDownloads();
+
+	// Patches which failed are replaced by full downloads
+	if (ApplyDownloadedPatches())
+	{
+		WaitForDownloads();
+	}
 
   Logger::warning("Downloading finished");
 
@@ -646,7 +873,7 @@ void Updater::NotifyFullUpdateProgress()
 
 		if (download->GetStatus() == Download::SUCCESS)
 		{
-			totalBytesDownloaded += i->second.filesize;
+			totalBytesDownloaded += i->second.GetDownloadSize();
 		}
 		else if (download->GetStatus() == Download::IN_PROGRESS)
 		{
@@ -685,6 +912,8 @@ void Updater::NotifyDownloadProgress()
 		info.progressFraction = curDownload->GetProgressFraction();
 		info.downloadSpeed = curDownload->GetDownloadSpeed();
 		info.downloadedBytes = curDownload->GetDownloadedBytes();
+		info.totalDownloadSpeed = _downloadManager->GetTotalDownloadSpeed();
+		info.activeDownloads = _downloadManager->GetActiveDownloadsCount();
 
 		MirrorDownloadPtr mirrorDownload = ptr_cast<MirrorDownload>( curDownload );
 
@@ -783,7 +1012,7 @@ std::size_t Updater::GetTotalDownloadSize()
 
 	for (ReleaseFileSet::iterator i = _downloadQueue.begin(); i != _downloadQueue.end(); ++i)
 	{
-		totalSize += i->second.filesize;
+		totalSize += i->second.GetDownloadSize();
 	}
 
 	return totalSize;
@@ -23,6 +23,7 @@
 #include "http/downloadmanager.hpp"
 #include "releasefileset.hpp"
 #include "releaseversions.hpp"
+#include "checksumcache.hpp"
 
 /**
  * Main updater class containing the application logic. 
@@ -71,6 +72,12 @@ struct CurDownloadInfo
 	// In bytes/sec
 	double downloadSpeed;
 
+	// Summed speed of all running downloads, in bytes/sec
+	double totalDownloadSpeed;
+
+	// Number of downloads running at the same time
+	std::size_t activeDownloads;
+
 	// Number of bytes received
 	std::size_t downloadedBytes;
 
@@ -200,6 +207,12 @@ private:
 	// The local versions a differential update is applicable to
 	std::set<std::string> _applicableDifferentialUpdates;
 
+	// CRCs of local files from previous runs
+	ChecksumCache _crcCache;
+
+	// Checks a share of local files on a worker thread
+	class CheckFilesTask;
+
 public:
 	// Pass the program options to this class
 	Updater(const UpdaterOptions& options, vfs::Path executable);
@@ -312,6 +325,23 @@ private:
 	// Returns false if the local files is missing or needs an update
 	bool CheckLocalFile(vfs::Path installPath, const ReleaseFile& releaseFile);
 
+	// Loads the CRC cache of the target folder
+	void LoadCrcCache();
+
+	// True if the release file has a patch made for the local file
+	bool IsPatchApplicable(const ReleaseFile& releaseFile);
+
+	// Queue the download of the whole file or of its patch
+	void AddFullDownload(ReleaseFile& releaseFile, const std::string& prefix);
+	void AddPatchDownload(ReleaseFile& releaseFile);
+
+	// Patches local files with downloaded patches, failed ones get a full download.
+	// Returns true if full downloads were added.
+	bool ApplyDownloadedPatches();
+
+	// Processes downloads until all of them are finished
+	void WaitForDownloads();
+
 	// Get the target path (defaults to current path)
 	vfs::Directory getTargetDir();
 
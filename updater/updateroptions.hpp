@@ -88,6 +88,7 @@ private:
         _desc[ "--release"   ] = "Create stable_info.txt for this configuration";
 		_desc[ "--directory" ] = "Use only in release/update mode, path to working directory";
         _desc[ "--version"   ] = "Use only in releases/udate mode, current version";
+        _desc[ "--previous"  ] = "Use only in release/update mode, path to previous release, binary patches are created against its files";
 	}
 };
 